@@ -0,0 +1,350 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий простой измеритель производительности для бенчмарков
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_BENCH_HPP
+#define SMART_ROAD_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Минимальное время измерения одного бенчмарка, с
+#define BENCH_MIN_SECONDS   0.5
+
+/// Относительное увеличение времени итерации, которое считается регрессией
+#define BENCH_REGRESSION_THRESHOLD  0.10
+
+#define BENCH_OK            0
+#define BENCH_ERROR         (-1)
+#define BENCH_REGRESSION    1
+
+/// Результат одного бенчмарка
+struct bench_result {
+    std::string name;                   ///< Название бенчмарка
+    std::string unit;                   ///< Единица измерения обработанных элементов
+    unsigned long long iterations = 0;  ///< Количество выполненных итераций
+    double seconds = 0;                 ///< Суммарное время измерения
+    double ns_per_iteration = 0;        ///< Время одной итерации, нс
+    double items_per_second = 0;        ///< Количество элементов в секунду
+    double p50_ns = 0;                  ///< Медиана времени одной итерации, нс (только для run_paced())
+    double p99_ns = 0;                  ///< 99-й процентиль времени одной итерации, нс (только для run_paced())
+    double max_ns = 0;                  ///< Максимальное время одной итерации, нс (только для run_paced())
+};
+
+/**
+ * \brief Предотвращает удаление компилятором вычислений, результат которых не используется
+ *
+ * \param [in] value Значение, которое должно быть вычислено
+ */
+template<typename T>
+void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * \brief Объект, запускающий бенчмарки и собирающий результаты
+ *
+ * Каждый бенчмарк выполняется пачками итераций, размер пачки удваивается до тех пор, пока суммарное
+ * время не превысит BENCH_MIN_SECONDS.
+ */
+class BenchRunner {
+
+private:
+    std::vector<bench_result> results;
+    std::string filter;
+
+public:
+    /**
+     * \brief Конструктор с фильтром.
+     *
+     * \param [in] name_filter Подстрока, которая должна входить в название запускаемых бенчмарков
+     */
+    explicit BenchRunner(std::string name_filter = "") : filter(std::move(name_filter)) {}
+
+    /**
+     * \brief Проверка, проходит ли бенчмарк фильтр.
+     *
+     * \param [in] name Название бенчмарка
+     */
+    bool is_selected(const std::string &name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    /**
+     * \brief Добавление результата бенчмарка, измеренного вне run() и run_paced().
+     *
+     * \param [in] result Результат бенчмарка
+     */
+    void add_result(const bench_result &result) {
+        printf("%-48s %14.1f ns/iter %16.1f %s/s\n",
+               result.name.c_str(),
+               result.ns_per_iteration,
+               result.items_per_second,
+               result.unit.c_str());
+
+        results.push_back(result);
+    }
+
+    /**
+     * \brief Запуск бенчмарка.
+     *
+     * \param [in] name Название бенчмарка
+     * \param [in] unit Единица измерения обрабатываемых элементов
+     * \param [in] items_per_iteration Количество элементов, обрабатываемых за одну итерацию
+     * \param [in] body Тело одной итерации
+     */
+    template<typename Body>
+    void run(const std::string &name, const char *unit, double items_per_iteration, Body body) {
+        if (!is_selected(name)) {
+            return;
+        }
+
+        body();
+
+        unsigned long long batch = 1;
+        unsigned long long iterations = 0;
+        double seconds = 0;
+
+        while (seconds < BENCH_MIN_SECONDS) {
+            auto start = std::chrono::steady_clock::now();
+
+            for (unsigned long long i = 0; i < batch; ++i) {
+                body();
+            }
+
+            auto stop = std::chrono::steady_clock::now();
+
+            iterations += batch;
+            seconds += std::chrono::duration<double>(stop - start).count();
+            batch *= 2;
+        }
+
+        bench_result result{};
+
+        result.name = name;
+        result.unit = unit;
+        result.iterations = iterations;
+        result.seconds = seconds;
+        result.ns_per_iteration = seconds * 1e9 / (double) iterations;
+        result.items_per_second = items_per_iteration * (double) iterations / seconds;
+
+        add_result(result);
+    }
+
+    /**
+     * \brief Запуск бенчмарка с заданной частотой итераций.
+     *
+     * Итерации запускаются по расписанию с частотой rate в течение BENCH_MIN_SECONDS, время каждой
+     * итерации измеряется отдельно. Позволяет оценить задержку, которую тело добавляет к обработке
+     * при реальной нагрузке, а не при непрерывном выполнении.
+     *
+     * \param [in] name Название бенчмарка
+     * \param [in] unit Единица измерения обрабатываемых элементов
+     * \param [in] items_per_iteration Количество элементов, обрабатываемых за одну итерацию
+     * \param [in] rate Количество итераций в секунду
+     * \param [in] body Тело одной итерации
+     */
+    template<typename Body>
+    void run_paced(const std::string &name, const char *unit, double items_per_iteration, double rate, Body body) {
+        if (!is_selected(name)) {
+            return;
+        }
+
+        body();
+
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / rate));
+        auto start = std::chrono::steady_clock::now();
+        auto next = start;
+
+        std::vector<double> samples;
+        samples.reserve((size_t) (rate * BENCH_MIN_SECONDS) + 1);
+
+        while (next - start < std::chrono::duration<double>(BENCH_MIN_SECONDS)) {
+            std::this_thread::sleep_until(next);
+
+            auto iteration_start = std::chrono::steady_clock::now();
+            body();
+            auto iteration_stop = std::chrono::steady_clock::now();
+
+            samples.push_back(std::chrono::duration<double, std::nano>(iteration_stop - iteration_start).count());
+            next += period;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double total = 0;
+
+        for (double sample : samples) {
+            total += sample;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        bench_result result{};
+
+        result.name = name;
+        result.unit = unit;
+        result.iterations = samples.size();
+        result.seconds = seconds;
+        result.ns_per_iteration = total / (double) samples.size();
+        result.items_per_second = items_per_iteration * (double) samples.size() / seconds;
+        result.p50_ns = samples[samples.size() / 2];
+        result.p99_ns = samples[samples.size() * 99 / 100];
+        result.max_ns = samples.back();
+
+        printf("%-48s %14.1f ns/iter %16.1f %s/s   p50 %.1f ns, p99 %.1f ns, max %.1f ns\n",
+               result.name.c_str(),
+               result.ns_per_iteration,
+               result.items_per_second,
+               result.unit.c_str(),
+               result.p50_ns,
+               result.p99_ns,
+               result.max_ns);
+
+        results.push_back(result);
+    }
+
+    /**
+     * \brief Получение результатов всех выполненных бенчмарков.
+     */
+    const std::vector<bench_result> &get_results() const {
+        return results;
+    }
+
+    /**
+     * \brief Запись результатов в файл JSON.
+     *
+     * Файл содержит массив results, каждый результат записывается одной строкой, чтобы результаты разных
+     * запусков можно было сравнивать построчно и читать обратно через load_json().
+     *
+     * \param [in] path Путь к файлу
+     * \return BENCH_OK, если файл записан. В противном случае - BENCH_ERROR.
+     */
+    int write_json(const char *path) const {
+        FILE *file = fopen(path, "w");
+
+        if (file == nullptr) {
+            return BENCH_ERROR;
+        }
+
+        fprintf(file, "{\n  \"results\": [\n");
+
+        for (size_t pos = 0; pos < results.size(); ++pos) {
+            const bench_result &result = results[pos];
+
+            fprintf(file,
+                    "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, \"seconds\": %.6f, "
+                    "\"ns_per_iteration\": %.3f, \"items_per_second\": %.3f, "
+                    "\"p50_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f}%s\n",
+                    result.name.c_str(),
+                    result.unit.c_str(),
+                    result.iterations,
+                    result.seconds,
+                    result.ns_per_iteration,
+                    result.items_per_second,
+                    result.p50_ns,
+                    result.p99_ns,
+                    result.max_ns,
+                    pos + 1 < results.size() ? "," : "");
+        }
+
+        fprintf(file, "  ]\n}\n");
+
+        return fclose(file) == 0 ? BENCH_OK : BENCH_ERROR;
+    }
+
+    /**
+     * \brief Чтение результатов из файла, записанного write_json().
+     *
+     * Читаются только название и время итерации, остальные поля результата остаются нулевыми.
+     *
+     * \param [in] path Путь к файлу
+     * \param [out] loaded Прочитанные результаты
+     * \return BENCH_OK, если файл прочитан. В противном случае - BENCH_ERROR.
+     */
+    static int load_json(const char *path, std::vector<bench_result> *loaded) {
+        FILE *file = fopen(path, "r");
+
+        if (file == nullptr) {
+            return BENCH_ERROR;
+        }
+
+        loaded->clear();
+
+        char line[1024];
+        char name[256];
+
+        while (fgets(line, sizeof line, file) != nullptr) {
+            const char *name_field = strstr(line, "\"name\": \"");
+            const char *time_field = strstr(line, "\"ns_per_iteration\": ");
+
+            if (name_field == nullptr || time_field == nullptr ||
+                sscanf(name_field + strlen("\"name\": \""), "%255[^\"]", name) != 1) {
+                continue;
+            }
+
+            bench_result result{};
+
+            result.name = name;
+            result.ns_per_iteration = strtod(time_field + strlen("\"ns_per_iteration\": "), nullptr);
+
+            loaded->push_back(result);
+        }
+
+        fclose(file);
+
+        return BENCH_OK;
+    }
+
+    /**
+     * \brief Сравнение результатов с результатами предыдущего запуска.
+     *
+     * Печатает изменение времени итерации для каждого бенчмарка, который есть в обоих запусках.
+     * Бенчмарки с расписанием (run_paced()) сравниваются так же, по среднему времени итерации.
+     *
+     * \param [in] baseline Результаты предыдущего запуска
+     * \return BENCH_REGRESSION, если время итерации хотя бы одного бенчмарка выросло больше чем
+     * на BENCH_REGRESSION_THRESHOLD. В противном случае - BENCH_OK.
+     */
+    int compare(const std::vector<bench_result> &baseline) const {
+        int status = BENCH_OK;
+
+        for (const bench_result &result : results) {
+            for (const bench_result &previous : baseline) {
+                if (previous.name != result.name || previous.ns_per_iteration <= 0) {
+                    continue;
+                }
+
+                double change = result.ns_per_iteration / previous.ns_per_iteration - 1.0;
+                bool regressed = change > BENCH_REGRESSION_THRESHOLD;
+
+                printf("%-48s %14.1f -> %14.1f ns/iter %+7.1f%%%s\n",
+                       result.name.c_str(),
+                       previous.ns_per_iteration,
+                       result.ns_per_iteration,
+                       change * 100.0,
+                       regressed ? "   REGRESSION" : "");
+
+                if (regressed) {
+                    status = BENCH_REGRESSION;
+                }
+
+                break;
+            }
+        }
+
+        return status;
+    }
+};
+
+#endif //SMART_ROAD_BENCH_HPP
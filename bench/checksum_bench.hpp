@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки расчёта контрольной суммы
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_CHECKSUM_BENCH_HPP
+#define SMART_ROAD_CHECKSUM_BENCH_HPP
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/smart_road_radar_utils.hpp"
+
+/// Количество целей в кадре, по данным которого считается контрольная сумма
+#define CHECKSUM_BENCH_TARGETS  35
+
+/**
+ * \brief Поэлементный расчёт контрольной суммы, с которым сравнивается векторизованный
+ *
+ * Повторяет расчёт calculate_checksum() до перехода на update_checksum(), включая передачу кадра по значению.
+ *
+ * \param [in] target_frame Кадр, для которого рассчитывается контрольная сумма
+ * \return Контрольная сумма
+ */
+u_byte_t calculate_checksum_scalar(frame target_frame) {
+    u_byte_t checksum = 0x00;
+
+    checksum += target_frame.data_length.b[0];
+    checksum += target_frame.data_length.b[1];
+
+    checksum += target_frame.word;
+
+    if (target_frame.data_length.i > 1) {
+        for (long long i = 0; i < target_frame.data_length.i - 1; ++i) {
+            checksum += target_frame.data[i];
+        }
+    }
+
+    return checksum;
+}
+
+/**
+ * \brief Регистрация бенчмарков контрольной суммы
+ *
+ * Сравниваются поэлементный расчёт и calculate_checksum() на кадре с данными о целях и на коротком
+ * командном кадре. Отдельно измеряется update_checksum(), вызываемая порциями, как в FrameParser.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_checksum_bench(BenchRunner &runner) {
+    std::vector<u_byte_t> target_payload = make_target_payload(CHECKSUM_BENCH_TARGETS, 1);
+    u_byte_t command_payload[] = {0x0A};
+
+    struct checksum_case {
+        const char *name;
+        u_byte_t *payload;
+        size_t length;
+    };
+
+    checksum_case cases[] = {
+            {"target_frame",  target_payload.data(), target_payload.size()},
+            {"command_frame", command_payload,       sizeof(command_payload)},
+    };
+
+    for (const checksum_case &test_case : cases) {
+        frame target_frame{};
+
+        target_frame.data_length.i = (int) test_case.length + 1;
+        target_frame.word = CMD_READ_TARGET_DATA;
+        target_frame.data = test_case.payload;
+
+        double bytes = (double) test_case.length;
+
+        runner.run(std::string("checksum/scalar/") + test_case.name, "bytes", bytes, [&]() {
+            do_not_optimize(target_frame);
+            do_not_optimize(calculate_checksum_scalar(target_frame));
+        });
+
+        runner.run(std::string("checksum/calculate_checksum/") + test_case.name, "bytes", bytes, [&]() {
+            do_not_optimize(target_frame);
+            do_not_optimize(calculate_checksum(target_frame));
+        });
+    }
+
+    for (size_t chunk_size : {64, 512, 4096}) {
+        runner.run("checksum/update_checksum/chunk_" + std::to_string(chunk_size), "bytes",
+                   (double) target_payload.size(), [&]() {
+            u_byte_t checksum = 0x00;
+
+            for (size_t offset = 0; offset < target_payload.size(); offset += chunk_size) {
+                size_t length = target_payload.size() - offset < chunk_size ? target_payload.size() - offset : chunk_size;
+                checksum = update_checksum(checksum, target_payload.data() + offset, length);
+            }
+
+            do_not_optimize(checksum);
+        });
+    }
+}
+
+#endif //SMART_ROAD_CHECKSUM_BENCH_HPP
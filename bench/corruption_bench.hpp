@@ -0,0 +1,382 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий нагрузочную проверку парсера кадров на повреждённых потоках
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_CORRUPTION_BENCH_HPP
+#define SMART_ROAD_CORRUPTION_BENCH_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/frame_parser.hpp"
+
+/// Количество кадров в потоке
+#define CORRUPTION_BENCH_FRAMES     2000
+/// Количество целей в кадре
+#define CORRUPTION_BENCH_TARGETS    35
+/// Количество различных полезных нагрузок, которые повторяются в потоке
+#define CORRUPTION_BENCH_PAYLOADS   16
+/// Размер порции, которой поток передаётся парсеру, как при чтении из порта
+#define CORRUPTION_BENCH_CHUNK      512
+/// Скорость линии, по которой байты восстановления переводятся во время, бод
+#define CORRUPTION_BENCH_BAUD       115200
+
+/**
+ * \brief Вероятности повреждения кадра
+ *
+ * Каждая вероятность относится к одному кадру, виды повреждений применяются независимо.
+ */
+struct corruption_config {
+    double bit_flip = 0;        ///< Инвертирование случайного бита кадра, в том числе в заголовке и длине
+    double truncation = 0;      ///< Обрезка кадра в случайном месте
+    double bad_checksum = 0;    ///< Искажение контрольной суммы
+    double spurious_header = 0; ///< Вставка перед кадром ложного заголовка со случайной длиной и мусором
+};
+
+/// Смещение в полезной нагрузке, по которому записывается номер кадра (внутри блока облака точек)
+#define CORRUPTION_BENCH_INDEX_OFFSET   5
+
+/// Повреждённый поток и сведения для проверки результата разбора
+struct corrupted_stream {
+    std::vector<u_byte_t> bytes;        ///< Поток байт
+
+    std::vector<bool> intact;           ///< Признаки неповреждённых кадров по номерам кадров
+    std::vector<size_t> frame_ends;     ///< Смещения концов кадров по номерам кадров
+    std::vector<int> recovery_frames;   ///< Номера первых неповреждённых кадров после каждого повреждения
+};
+
+/// Результат разбора повреждённого потока
+struct corruption_report {
+    size_t frames_expected = 0;         ///< Количество неповреждённых кадров
+    size_t frames_delivered = 0;        ///< Количество неповреждённых кадров, разобранных с верной контрольной суммой
+    size_t false_frames = 0;            ///< Количество кадров с верной контрольной суммой, которых не было в потоке
+    size_t frames_lost_after_damage = 0;///< Количество повреждений, после которых следующий целый кадр потерян
+
+    double mean_recovery_bytes = 0;     ///< Средняя задержка выдачи первого целого кадра после повреждения, байт
+    size_t max_recovery_bytes = 0;      ///< Наибольшая задержка выдачи первого целого кадра после повреждения, байт
+
+    frame_parser_statistics parser{};   ///< Статистика парсера
+};
+
+/**
+ * \brief Формирует поток кадров CMD_READ_TARGET_DATA с повреждениями
+ *
+ * \param [in] config Вероятности повреждений
+ * \param [in] seed Начальное значение генератора повреждений
+ * \return Поток и сведения о кадрах
+ */
+corrupted_stream make_corrupted_stream(const corruption_config &config, unsigned int seed) {
+    std::vector<std::vector<u_byte_t>> payloads;
+
+    for (int i = 0; i < CORRUPTION_BENCH_PAYLOADS; ++i) {
+        payloads.push_back(make_target_payload(CORRUPTION_BENCH_TARGETS, i));
+    }
+
+    corrupted_stream stream;
+    unsigned int state = seed * 2654435761u + 1;
+
+    auto next_random = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+
+    auto chance = [&next_random](double probability) {
+        return (double) next_random() < probability * (double) (1u << 24);
+    };
+
+    std::vector<u_byte_t> packet;
+    bool awaiting_recovery = false;
+
+    for (int i = 0; i < CORRUPTION_BENCH_FRAMES; ++i) {
+        bool damaged = false;
+
+        if (chance(config.spurious_header)) {
+            u_short_t fake_length = (u_short_t) next_random();
+            size_t garbage = next_random() % 64;
+
+            stream.bytes.push_back(HEADER_DATA_FRAME_1);
+            stream.bytes.push_back(HEADER_DATA_FRAME_2);
+            stream.bytes.push_back((u_byte_t) (fake_length & 0xFF));
+            stream.bytes.push_back((u_byte_t) (fake_length >> 8));
+
+            for (size_t j = 0; j < garbage; ++j) {
+                stream.bytes.push_back((u_byte_t) next_random());
+            }
+
+            /// Сам кадр после ложного заголовка остаётся целым
+            awaiting_recovery = true;
+        }
+
+        std::vector<u_byte_t> &payload = payloads[i % CORRUPTION_BENCH_PAYLOADS];
+
+        payload[CORRUPTION_BENCH_INDEX_OFFSET] = (u_byte_t) (i & 0xFF);
+        payload[CORRUPTION_BENCH_INDEX_OFFSET + 1] = (u_byte_t) (i >> 8);
+
+        packet.clear();
+        append_frame(packet, CMD_READ_TARGET_DATA, payload.data(), payload.size());
+
+        if (chance(config.bit_flip)) {
+            size_t bit = next_random() % (packet.size() * 8);
+            packet[bit / 8] ^= (u_byte_t) (1 << (bit % 8));
+            damaged = true;
+        }
+
+        if (chance(config.bad_checksum)) {
+            packet.back() ^= (u_byte_t) (1 + next_random() % 255);
+            damaged = true;
+        }
+
+        if (chance(config.truncation)) {
+            packet.resize(1 + next_random() % (packet.size() - 1));
+            damaged = true;
+        }
+
+        stream.bytes.insert(stream.bytes.end(), packet.begin(), packet.end());
+
+        stream.intact.push_back(!damaged);
+        stream.frame_ends.push_back(stream.bytes.size());
+
+        if (damaged) {
+            awaiting_recovery = true;
+        } else if (awaiting_recovery) {
+            stream.recovery_frames.push_back(i);
+            awaiting_recovery = false;
+        }
+    }
+
+    return stream;
+}
+
+/**
+ * \brief Разбор потока порциями CORRUPTION_BENCH_CHUNK
+ *
+ * \param [in,out] parser Парсер
+ * \param [in] stream Поток байт
+ * \param [out] deliveries Номера кадров с верной контрольной суммой и количество байт потока, прочитанных
+ * к моменту их выдачи. Может быть равен nullptr.
+ * \return Количество кадров с верной контрольной суммой
+ */
+int parse_corrupted_stream(FrameParser &parser, const std::vector<u_byte_t> &stream,
+                           std::vector<std::pair<int, size_t>> *deliveries) {
+    int frames = 0;
+
+    for (size_t offset = 0; offset < stream.size();) {
+        size_t length = std::min(stream.size() - offset, (size_t) CORRUPTION_BENCH_CHUNK);
+        size_t chunk_end = offset + length;
+
+        while (offset < chunk_end) {
+            frame_view view;
+            size_t consumed;
+
+            int result = parser.parse(stream.data() + offset, chunk_end - offset, &consumed, &view);
+            offset += consumed;
+
+            if (result == FRAME_PARSER_FRAME_READY && view.is_valid) {
+                ++frames;
+
+                if (deliveries != nullptr) {
+                    int index = -1;
+
+                    if (view.data_length > CORRUPTION_BENCH_INDEX_OFFSET + 2) {
+                        index = view.payload[CORRUPTION_BENCH_INDEX_OFFSET] |
+                                (view.payload[CORRUPTION_BENCH_INDEX_OFFSET + 1] << 8);
+                    }
+
+                    deliveries->emplace_back(index, offset);
+                }
+            }
+        }
+    }
+
+    return frames;
+}
+
+/**
+ * \brief Разбор повреждённого потока с проверкой результата
+ *
+ * Кадры узнаются по номеру в полезной нагрузке. Задержка восстановления после повреждения - количество байт,
+ * прочитанных после конца первого целого кадра за повреждением до момента его выдачи. Ноль означает, что кадр
+ * выдан сразу, как только пришёл его последний байт.
+ *
+ * \param [in] stream Повреждённый поток
+ * \return Результат разбора
+ */
+corruption_report check_corrupted_stream(const corrupted_stream &stream) {
+    FrameParser parser;
+    std::vector<std::pair<int, size_t>> deliveries;
+
+    parse_corrupted_stream(parser, stream.bytes, &deliveries);
+
+    corruption_report report;
+    std::vector<size_t> delivered_at(stream.intact.size(), 0);
+
+    report.parser = parser.get_statistics();
+
+    for (bool intact : stream.intact) {
+        report.frames_expected += intact;
+    }
+
+    for (const std::pair<int, size_t> &delivery : deliveries) {
+        int index = delivery.first;
+
+        if (index < 0 || index >= (int) stream.intact.size() || !stream.intact[index] || delivered_at[index] != 0) {
+            ++report.false_frames;
+            continue;
+        }
+
+        delivered_at[index] = delivery.second;
+        ++report.frames_delivered;
+    }
+
+    size_t recoveries = 0;
+    double total_recovery = 0;
+
+    for (int index : stream.recovery_frames) {
+        if (delivered_at[index] == 0) {
+            ++report.frames_lost_after_damage;
+            continue;
+        }
+
+        size_t recovery = delivered_at[index] - stream.frame_ends[index];
+
+        total_recovery += (double) recovery;
+        report.max_recovery_bytes = std::max(report.max_recovery_bytes, recovery);
+        ++recoveries;
+    }
+
+    if (recoveries > 0) {
+        report.mean_recovery_bytes = total_recovery / (double) recoveries;
+    }
+
+    return report;
+}
+
+/**
+ * \brief Пиковый объём памяти процесса, КБ, или 0, если он недоступен
+ */
+long get_peak_memory_kb() {
+#ifndef _WIN32
+    rusage usage{};
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * \brief Проверка парсера на одном наборе вероятностей повреждений
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \param [in] name Название набора
+ * \param [in] config Вероятности повреждений
+ */
+void run_corruption_case(BenchRunner &runner, const std::string &name, const corruption_config &config) {
+    std::string bench_name = "corruption/" + name;
+
+    if (!runner.is_selected(bench_name)) {
+        return;
+    }
+
+    corrupted_stream stream = make_corrupted_stream(config, 1);
+    corruption_report report = check_corrupted_stream(stream);
+
+    long memory_before = get_peak_memory_kb();
+    FrameParser parser;
+
+    runner.run(bench_name, "frames", (double) report.frames_expected, [&]() {
+        do_not_optimize(parse_corrupted_stream(parser, stream.bytes, nullptr));
+    });
+
+    long memory_after = get_peak_memory_kb();
+    double bytes_per_ms = CORRUPTION_BENCH_BAUD / 10.0 / 1000.0;
+
+    printf("%s: %zu/%zu intact frames delivered, %zu false frames, %zu damaged frames, "
+           "%llu checksum and %llu length errors\n",
+           bench_name.c_str(),
+           report.frames_delivered,
+           report.frames_expected,
+           report.false_frames,
+           stream.intact.size() - report.frames_expected,
+           report.parser.checksum_errors,
+           report.parser.length_errors);
+
+    printf("%s: recovery delay mean %.0f bytes (%.1f ms at %d baud), max %zu bytes (%.1f ms), "
+           "%zu recoveries lost the next frame, peak memory %ld KB (+%ld KB)\n",
+           bench_name.c_str(),
+           report.mean_recovery_bytes,
+           report.mean_recovery_bytes / bytes_per_ms,
+           CORRUPTION_BENCH_BAUD,
+           report.max_recovery_bytes,
+           (double) report.max_recovery_bytes / bytes_per_ms,
+           report.frames_lost_after_damage,
+           memory_after,
+           memory_after - memory_before);
+}
+
+/**
+ * \brief Регистрация нагрузочной проверки парсера на повреждённых потоках
+ *
+ * Поток из CORRUPTION_BENCH_FRAMES кадров повреждается с заданными вероятностями и разбирается порциями.
+ * Измеряется количество неповреждённых кадров в секунду, проверяется, что все они доставлены, и печатается
+ * время восстановления синхронизации после повреждений и пиковый объём памяти процесса.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \param [in] custom_rate Суммарная вероятность повреждения кадра для дополнительного набора corruption/custom,
+ * поровну между видами повреждений. Если не больше нуля, то набор не запускается.
+ */
+void run_corruption_bench(BenchRunner &runner, double custom_rate = 0) {
+    corruption_config clean;
+
+    corruption_config bit_flips;
+    bit_flips.bit_flip = 0.05;
+
+    corruption_config truncations;
+    truncations.truncation = 0.05;
+
+    corruption_config bad_checksums;
+    bad_checksums.bad_checksum = 0.05;
+
+    corruption_config spurious_headers;
+    spurious_headers.spurious_header = 0.05;
+
+    corruption_config mixed;
+    mixed.bit_flip = 0.125;
+    mixed.truncation = 0.125;
+    mixed.bad_checksum = 0.125;
+    mixed.spurious_header = 0.125;
+
+    run_corruption_case(runner, "clean", clean);
+    run_corruption_case(runner, "bit_flip_5pct", bit_flips);
+    run_corruption_case(runner, "truncation_5pct", truncations);
+    run_corruption_case(runner, "bad_checksum_5pct", bad_checksums);
+    run_corruption_case(runner, "spurious_header_5pct", spurious_headers);
+    run_corruption_case(runner, "mixed_50pct", mixed);
+
+    if (custom_rate > 0) {
+        corruption_config custom;
+        custom.bit_flip = custom_rate / 4;
+        custom.truncation = custom_rate / 4;
+        custom.bad_checksum = custom_rate / 4;
+        custom.spurious_header = custom_rate / 4;
+
+        run_corruption_case(runner, "custom", custom);
+    }
+}
+
+#endif //SMART_ROAD_CORRUPTION_BENCH_HPP
@@ -0,0 +1,71 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки потокового парсера кадров
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_FRAME_PARSER_BENCH_HPP
+#define SMART_ROAD_FRAME_PARSER_BENCH_HPP
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/frame_parser.hpp"
+
+/// Количество кадров в синтетическом потоке
+#define FRAME_PARSER_BENCH_FRAMES   64
+/// Количество целей в кадре синтетического потока
+#define FRAME_PARSER_BENCH_TARGETS  35
+
+/**
+ * \brief Разбор потока порциями заданного размера
+ *
+ * \param [in,out] parser Парсер
+ * \param [in] stream Поток байт
+ * \param [in] chunk_size Размер порции
+ * \return Количество кадров с верной контрольной суммой
+ */
+int parse_stream(FrameParser &parser, const std::vector<u_byte_t> &stream, size_t chunk_size) {
+    int frames = 0;
+
+    for (size_t offset = 0; offset < stream.size(); offset += chunk_size) {
+        const u_byte_t *chunk = stream.data() + offset;
+        size_t length = stream.size() - offset < chunk_size ? stream.size() - offset : chunk_size;
+
+        while (length > 0) {
+            frame_view view;
+            size_t consumed;
+
+            if (parser.parse(chunk, length, &consumed, &view) == FRAME_PARSER_FRAME_READY && view.is_valid) {
+                ++frames;
+            }
+
+            chunk += consumed;
+            length -= consumed;
+        }
+    }
+
+    return frames;
+}
+
+/**
+ * \brief Регистрация бенчмарков парсера
+ *
+ * Количество кадров в секунду измеряется в одном потоке, то есть соответствует производительности
+ * одного ядра.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_frame_parser_bench(BenchRunner &runner) {
+    std::vector<u_byte_t> stream = make_target_stream(FRAME_PARSER_BENCH_FRAMES, FRAME_PARSER_BENCH_TARGETS);
+    FrameParser parser;
+
+    for (size_t chunk_size : {64, 512, 4096, 65536}) {
+        runner.run("frame_parser/chunk_" + std::to_string(chunk_size), "frames", FRAME_PARSER_BENCH_FRAMES, [&]() {
+            do_not_optimize(parse_stream(parser, stream, chunk_size));
+        });
+    }
+}
+
+#endif //SMART_ROAD_FRAME_PARSER_BENCH_HPP
@@ -0,0 +1,92 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки генератора целей и эмулируемых радаров без ограничения частоты
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_GENERATOR_BENCH_HPP
+#define SMART_ROAD_GENERATOR_BENCH_HPP
+
+#include <memory>
+#include <random>
+
+#include "bench.hpp"
+#include "../src/smart_road_radar_demo.hpp"
+#include "../src/smart_road_radar_loopback.hpp"
+#include "../src/target_generator.hpp"
+
+/**
+ * \brief Заполнение пакета через std::mt19937 и распределения, как в SmartRoadRadarDemo до TargetGenerator
+ *
+ * \param [in,out] generator Генератор
+ * \param [out] batch Пакет целей
+ * \param [in] count Количество целей
+ * \param [in] ranges Диапазоны значений
+ */
+void generate_targets_mt19937(std::mt19937 &generator, target_batch *batch, int count, const generator_ranges &ranges) {
+    std::uniform_int_distribution<std::mt19937::result_type> num(1, count);
+    std::uniform_real_distribution<float> distance(ranges.min_distance, ranges.max_distance);
+    std::uniform_real_distribution<float> speed(ranges.min_speed, ranges.max_speed);
+    std::uniform_real_distribution<float> angle(ranges.min_angle, ranges.max_angle);
+
+    batch->count = count;
+
+    for (int pos = 0; pos < count; ++pos) {
+        batch->num[pos] = num(generator);
+        batch->distance[pos] = distance(generator);
+        batch->speed[pos] = speed(generator);
+        batch->angle[pos] = angle(generator);
+        batch->snr[pos] = 0;
+    }
+}
+
+/**
+ * \brief Регистрация бенчмарков генератора целей
+ *
+ * Сравнивается заполнение пакета через std::mt19937 и TargetGenerator, затем измеряется частота кадров
+ * SmartRoadRadarDemo и SmartRoadRadarLoopback с GENERATOR_RATE_UNLIMITED. У SmartRoadRadarLoopback в кадр
+ * входят кодирование, разбор и декодирование байт протокола.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_generator_bench(BenchRunner &runner) {
+    std::unique_ptr<target_batch> batch(new target_batch());
+    generator_ranges ranges;
+
+    std::mt19937 mt19937(1);
+    TargetGenerator generator(1);
+
+    for (int count : {35, TARGET_BATCH_CAPACITY}) {
+        std::string suffix = "/" + std::to_string(count) + "_targets";
+
+        runner.run("generator/mt19937" + suffix, "targets", count, [&]() {
+            generate_targets_mt19937(mt19937, batch.get(), count, ranges);
+            do_not_optimize(batch->distance[0]);
+        });
+
+        runner.run("generator/xorshift" + suffix, "targets", count, [&]() {
+            generator.generate(batch.get(), count, ranges);
+            do_not_optimize(batch->distance[0]);
+        });
+    }
+
+    if (runner.is_selected("generator/demo")) {
+        SmartRoadRadarDemo demo(1, GENERATOR_RATE_UNLIMITED);
+
+        runner.run("generator/demo/unlimited", "frames", 1, [&]() {
+            do_not_optimize(demo.get_target_data(batch.get()));
+        });
+    }
+
+    if (runner.is_selected("generator/loopback")) {
+        SmartRoadRadarLoopback loopback(1, GENERATOR_RATE_UNLIMITED);
+
+        runner.run("generator/loopback/unlimited", "frames", 1, [&]() {
+            do_not_optimize(loopback.get_target_data(batch.get()));
+        });
+    }
+}
+
+#endif //SMART_ROAD_GENERATOR_BENCH_HPP
@@ -0,0 +1,96 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарк расчёта показателей по полосам LaneAggregator
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_LANE_AGGREGATOR_BENCH_HPP
+#define SMART_ROAD_LANE_AGGREGATOR_BENCH_HPP
+
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "tracker_bench.hpp"
+#include "../src/lane_aggregator.hpp"
+#include "../src/road_transform.hpp"
+
+/// Количество полос, совпадающее с make_moving_targets()
+#define AGGREGATOR_BENCH_LANES  17
+
+/**
+ * \brief Регистрация бенчмарка расчёта показателей по полосам
+ *
+ * Пакеты из TARGET_BATCH_CAPACITY движущихся целей make_moving_targets() переводятся в координаты дороги
+ * и передаются в LaneAggregator с 17 зонами детекторов длиной 5 м. Время пакетов идёт с шагом 50 мс,
+ * поэтому за время бенчмарка окна многократно сдвигаются и передают отчёты.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_lane_aggregator_bench(BenchRunner &runner) {
+    std::vector<target_batch> batches = make_moving_targets(TRACKER_BENCH_FRAMES, TARGET_BATCH_CAPACITY);
+    RoadTransform transform;
+
+    for (target_batch &batch: batches) {
+        transform.apply(&batch);
+    }
+
+    ZoneMap zones;
+
+    for (int lane = 0; lane < AGGREGATOR_BENCH_LANES; ++lane) {
+        float center = (float) (lane - AGGREGATOR_BENCH_LANES / 2) * 4.0f;
+
+        zones.add_zone((u_short_t) (lane + 1), {
+                {center - 1.75f, 50.0f},
+                {center + 1.75f, 50.0f},
+                {center + 1.75f, 55.0f},
+                {center - 1.75f, 55.0f}
+        });
+    }
+
+    if (zones.build() != ZONES_OK) {
+        printf("aggregator: can't build zone map\n");
+        return;
+    }
+
+    LaneAggregator aggregator(zones);
+
+    for (int lane = 0; lane < AGGREGATOR_BENCH_LANES; ++lane) {
+        aggregator.add_lane((u_short_t) (lane + 1));
+    }
+
+    unsigned long long reports = 0;
+
+    aggregator.set_report_callback([&](const lane_report &report) {
+        ++reports;
+        do_not_optimize(report.flow_per_hour);
+    });
+
+    auto received_at = std::chrono::steady_clock::time_point{};
+    size_t frame_pos = 0;
+
+    runner.run("aggregator/update/255_targets", "targets", TARGET_BATCH_CAPACITY, [&]() {
+        received_at += std::chrono::milliseconds(1000 / TRACKER_BENCH_RATE);
+        aggregator.update(batches[frame_pos], received_at);
+
+        if (++frame_pos == batches.size()) {
+            frame_pos = 0;
+        }
+    });
+
+    if (runner.is_selected("aggregator/")) {
+        lane_report report = aggregator.get_report(0, AGGREGATOR_WINDOW_15MIN);
+
+        printf("aggregator: %llu interval reports, lane 0 over 15 min: %.0f veh/h, %.1f%% occupancy, "
+               "%.2f s headway, %.1f m/s\n",
+               reports,
+               report.flow_per_hour,
+               report.occupancy,
+               report.mean_headway,
+               report.mean_speed);
+    }
+}
+
+#endif //SMART_ROAD_LANE_AGGREGATOR_BENCH_HPP
@@ -0,0 +1,79 @@
+#include <cstring>
+
+#include "checksum_bench.hpp"
+#include "corruption_bench.hpp"
+#include "frame_parser_bench.hpp"
+#include "radar_bench.hpp"
+#include "recorder_bench.hpp"
+#include "replay_bench.hpp"
+#include "radar_manager_bench.hpp"
+#include "tracker_bench.hpp"
+#include "zones_bench.hpp"
+#include "road_transform_bench.hpp"
+#include "lane_aggregator_bench.hpp"
+#include "generator_bench.hpp"
+#include "serial_pty_check.hpp"
+
+/**
+ * Запуск: smart_road_radar_bench [фильтр] [--json путь] [--baseline путь] [--corruption вероятность]
+ *
+ * --json сохраняет результаты в файл, --baseline сравнивает их с файлом предыдущего запуска.
+ * --corruption добавляет проверку парсера corruption/custom с заданной вероятностью повреждения кадра.
+ * При регрессии программа завершается с кодом BENCH_REGRESSION.
+ */
+int main(int argc, char* argv[]) {
+    const char *filter = "";
+    const char *json_path = nullptr;
+    const char *baseline_path = nullptr;
+    double corruption_rate = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--corruption") == 0 && i + 1 < argc) {
+            corruption_rate = atof(argv[++i]);
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    BenchRunner runner(filter);
+
+    if (run_serial_pty_check(runner) != BENCH_OK) {
+        printf("Serial port check failed\n");
+        return BENCH_ERROR;
+    }
+
+    run_checksum_bench(runner);
+    run_frame_parser_bench(runner);
+    run_corruption_bench(runner, corruption_rate);
+    run_radar_bench(runner);
+    run_recorder_bench(runner);
+    run_replay_bench(runner);
+    run_radar_manager_bench(runner);
+    run_tracker_bench(runner);
+    run_zones_bench(runner);
+    run_road_transform_bench(runner);
+    run_lane_aggregator_bench(runner);
+    run_generator_bench(runner);
+
+    if (json_path != nullptr && runner.write_json(json_path) != BENCH_OK) {
+        printf("Can't write %s\n", json_path);
+        return BENCH_ERROR;
+    }
+
+    if (baseline_path != nullptr) {
+        std::vector<bench_result> baseline;
+
+        if (BenchRunner::load_json(baseline_path, &baseline) != BENCH_OK) {
+            printf("Can't read %s\n", baseline_path);
+            return BENCH_ERROR;
+        }
+
+        return runner.compare(baseline);
+    }
+
+    return 0;
+}
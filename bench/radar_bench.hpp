@@ -0,0 +1,165 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки SmartRoadRadar на синтетическом потоке из памяти
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_RADAR_BENCH_HPP
+#define SMART_ROAD_RADAR_BENCH_HPP
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "stream_transport.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/frame_pool.hpp"
+#include "../src/lane_aggregator.hpp"
+#include "../src/target_tracker.hpp"
+
+/// Количество кадров в синтетическом потоке
+#define RADAR_BENCH_FRAMES      64
+/// Количество целей в кадре синтетического потока
+#define RADAR_BENCH_TARGETS     35
+
+/**
+ * \brief Регистрация бенчмарков разбора и декодирования кадров
+ *
+ * Поток из RADAR_BENCH_FRAMES кадров CMD_READ_TARGET_DATA выдаётся StreamTransport по кругу,
+ * каждая итерация - один кадр.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_radar_read_bench(BenchRunner &runner) {
+    StreamRadar radar(make_target_stream(RADAR_BENCH_FRAMES, RADAR_BENCH_TARGETS));
+    target_batch batch;
+    point_cloud_block cloud;
+    frame received_frame;
+
+    runner.run("radar/read_frame", "frames", 1, [&]() {
+        do_not_optimize(radar.read_frame(&received_frame));
+        do_not_optimize(received_frame.checksum);
+    });
+
+    runner.run("radar/get_target_data", "frames", 1, [&]() {
+        do_not_optimize(radar.get_target_data(&batch));
+    });
+
+    runner.run("radar/get_target_data/point_cloud", "frames", 1, [&]() {
+        do_not_optimize(radar.get_target_data(&batch, &cloud));
+    });
+}
+
+/**
+ * \brief Регистрация бенчмарков формирования командных кадров и перевода полей в float
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_radar_utils_bench(BenchRunner &runner) {
+    FramePool pool;
+    u_byte_t parameters_data[sizeof(parameters)] = {};
+
+    runner.run("radar/configure_frame/command", "frames", 1, [&]() {
+        FrameHandle handle = configure_frame(&pool, CMD_SET_TARGET_NUM, 35);
+        do_not_optimize(handle->checksum);
+    });
+
+    runner.run("radar/configure_frame/parameters", "frames", 1, [&]() {
+        FrameHandle handle = configure_frame(&pool, CMD_SET_PARAMETERS, parameters_data, sizeof(parameters));
+        do_not_optimize(handle->checksum);
+    });
+
+    std::vector<u_byte_t> payload = make_target_payload(RADAR_BENCH_TARGETS, 1);
+    const u_byte_t *records = payload.data() + 1 + TARGET_DATA_BYTE_OFFSET;
+
+    runner.run("radar/u_byte_to_float", "values", 4 * RADAR_BENCH_TARGETS, [&]() {
+        float sum = 0;
+
+        for (int target = 0; target < RADAR_BENCH_TARGETS; ++target) {
+            const u_byte_t *record = records + TARGET_DATA_BYTE_LENGTH * target;
+
+            sum += u_byte_to_float(record + 2);
+            sum += u_byte_to_float(record + 4);
+            sum += u_byte_to_float(record + 6);
+            sum += u_byte_to_float(record + 8);
+        }
+
+        do_not_optimize(sum);
+    });
+}
+
+/**
+ * \brief Регистрация сквозного бенчмарка обработки кадров
+ *
+ * Каждый кадр проходит весь путь обработки одного радара: разбор, декодирование целей и облака точек,
+ * перевод в координаты дороги, сопровождение целей и расчёт показателей по полосам. Результат -
+ * количество кадров в секунду, которое обрабатывает одно ядро.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_radar_pipeline_bench(BenchRunner &runner) {
+    if (!runner.is_selected("radar/pipeline")) {
+        return;
+    }
+
+    StreamRadar radar(make_target_stream(RADAR_BENCH_FRAMES, RADAR_BENCH_TARGETS));
+
+    radar_calibration calibration;
+    calibration.height = 6.0f;
+    radar.set_calibration(calibration);
+
+    ZoneMap zones;
+
+    for (int lane = 0; lane < 4; ++lane) {
+        float left = (float) (lane - 2) * 3.5f;
+
+        zones.add_zone((u_short_t) (lane + 1), {
+                {left,        5.0f},
+                {left + 3.5f, 5.0f},
+                {left + 3.5f, 10.0f},
+                {left,        10.0f}
+        });
+    }
+
+    if (zones.build() != ZONES_OK) {
+        printf("radar: can't build zone map\n");
+        return;
+    }
+
+    LaneAggregator aggregator(zones);
+
+    for (int lane = 0; lane < 4; ++lane) {
+        aggregator.add_lane((u_short_t) (lane + 1));
+    }
+
+    std::unique_ptr<TargetTracker> tracker(new TargetTracker());
+    std::unique_ptr<target_batch> batch(new target_batch());
+    point_cloud_block cloud;
+
+    auto received_at = std::chrono::steady_clock::time_point{};
+
+    runner.run("radar/pipeline", "frames", 1, [&]() {
+        received_at += std::chrono::milliseconds(1000 / DATA_FREQ_20);
+
+        if (radar.get_target_data(batch.get(), &cloud) == SMART_ROAD_RADAR_OK) {
+            do_not_optimize(tracker->update(*batch, received_at).count);
+            aggregator.update(*batch, received_at);
+        }
+    });
+}
+
+/**
+ * \brief Регистрация бенчмарков SmartRoadRadar на синтетическом потоке
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_radar_bench(BenchRunner &runner) {
+    run_radar_read_bench(runner);
+    run_radar_utils_bench(runner);
+    run_radar_pipeline_bench(runner);
+}
+
+#endif //SMART_ROAD_RADAR_BENCH_HPP
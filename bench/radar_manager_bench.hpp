@@ -0,0 +1,197 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарк затрат процессора RadarManager на один порт
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_RADAR_MANAGER_BENCH_HPP
+#define SMART_ROAD_RADAR_MANAGER_BENCH_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/radar_manager.hpp"
+
+/// Количество целей в кадре, который получает каждый порт
+#define RADAR_MANAGER_BENCH_TARGETS 35
+/// Частота кадров на одном порту, Гц (соответствует DATA_FREQ_20)
+#define RADAR_MANAGER_BENCH_RATE    20
+/// Время измерения для одного количества портов, с
+#define RADAR_MANAGER_BENCH_SECONDS 2.0
+
+#ifndef _WIN32
+
+/**
+ * \brief Процессорное время, нс
+ *
+ * \param [in] clock_id CLOCK_PROCESS_CPUTIME_ID или CLOCK_THREAD_CPUTIME_ID
+ */
+double get_cpu_time_ns(clockid_t clock_id) {
+    timespec time{};
+    clock_gettime(clock_id, &time);
+
+    return (double) time.tv_sec * 1e9 + (double) time.tv_nsec;
+}
+
+/**
+ * \brief Измерение затрат процессора RadarManager при заданном количестве портов
+ *
+ * Порты эмулируются псевдотерминалами: отдельный поток пишет в каждый из них кадр с целями с частотой
+ * RADAR_MANAGER_BENCH_RATE, а менеджер с одним потоком читает и декодирует все порты. Время процессора
+ * потока записи вычитается из времени процесса, остаток делится на количество кадров и портов.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \param [in] port_count Количество портов
+ */
+void run_radar_manager_ports_bench(BenchRunner &runner, int port_count) {
+    std::string name = "radar_manager/ports_" + std::to_string(port_count);
+
+    if (!runner.is_selected(name)) {
+        return;
+    }
+
+    std::vector<u_byte_t> target_frame = make_target_stream(1, RADAR_MANAGER_BENCH_TARGETS);
+
+    std::vector<int> masters;
+    std::vector<std::unique_ptr<SmartRoadRadar>> radars;
+
+    port_config config{230400, 8, ONESTOPBIT, NOPARITY};
+
+    for (int port = 0; port < port_count; ++port) {
+        int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            if (master >= 0) {
+                close(master);
+            }
+
+            break;
+        }
+
+        masters.push_back(master);
+        radars.emplace_back(new SmartRoadRadar(ptsname(master), config));
+    }
+
+    if ((int) masters.size() != port_count) {
+        printf("%s: can't open %d pseudo terminals\n", name.c_str(), port_count);
+
+        for (int master: masters) {
+            close(master);
+        }
+
+        return;
+    }
+
+    RadarManager manager;
+    std::atomic<unsigned long long> batches{0};
+
+    for (auto &radar: radars) {
+        manager.add_radar(radar.get());
+    }
+
+    manager.set_batch_callback([&](const radar_batch &received) {
+        batches.fetch_add(1, std::memory_order_relaxed);
+        do_not_optimize(received.batch->count);
+    });
+
+    manager.start();
+
+    std::atomic<bool> writing{true};
+    double writer_cpu_ns = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    double process_start_ns = get_cpu_time_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+    std::thread writer([&]() {
+        double thread_start_ns = get_cpu_time_ns(CLOCK_THREAD_CPUTIME_ID);
+        auto next = std::chrono::steady_clock::now();
+
+        while (writing.load()) {
+            for (int master: masters) {
+                ssize_t written = write(master, target_frame.data(), target_frame.size());
+                do_not_optimize(written);
+            }
+
+            next += std::chrono::microseconds(1000000 / RADAR_MANAGER_BENCH_RATE);
+            std::this_thread::sleep_until(next);
+        }
+
+        writer_cpu_ns = get_cpu_time_ns(CLOCK_THREAD_CPUTIME_ID) - thread_start_ns;
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(RADAR_MANAGER_BENCH_SECONDS));
+
+    writing.store(false);
+    writer.join();
+
+    /// Последние кадры должны быть прочитаны до остановки
+    std::this_thread::sleep_for(std::chrono::milliseconds(SERIAL_READ_POLL_TIMEOUT));
+
+    double manager_cpu_ns = get_cpu_time_ns(CLOCK_PROCESS_CPUTIME_ID) - process_start_ns - writer_cpu_ns;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    manager.stop();
+
+    for (int master: masters) {
+        close(master);
+    }
+
+    unsigned long long delivered = batches.load();
+
+    if (delivered == 0) {
+        printf("%s: no batches delivered\n", name.c_str());
+        return;
+    }
+
+    bench_result result{};
+
+    result.name = name;
+    result.unit = "batches";
+    result.iterations = delivered;
+    result.seconds = seconds;
+    result.ns_per_iteration = manager_cpu_ns / (double) delivered;
+    result.items_per_second = (double) delivered / seconds;
+
+    runner.add_result(result);
+
+    printf("%s: %llu of %d batches, %.4f%% of one core per port\n",
+           name.c_str(),
+           delivered,
+           (int) (port_count * RADAR_MANAGER_BENCH_RATE * RADAR_MANAGER_BENCH_SECONDS),
+           manager_cpu_ns / (seconds * 1e9) / port_count * 100.0);
+}
+
+#endif
+
+/**
+ * \brief Регистрация бенчмарков RadarManager
+ *
+ * Затраты процессора измеряются для 1, 8 и 32 портов, обслуживаемых одним потоком. Время на итерацию - это
+ * время процессора на один принятый и декодированный пакет целей.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_radar_manager_bench(BenchRunner &runner) {
+#ifndef _WIN32
+    run_radar_manager_ports_bench(runner, 1);
+    run_radar_manager_ports_bench(runner, 8);
+    run_radar_manager_ports_bench(runner, 32);
+#endif
+}
+
+#endif //SMART_ROAD_RADAR_MANAGER_BENCH_HPP
@@ -0,0 +1,124 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки записи и чтения кадров
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_RECORDER_BENCH_HPP
+#define SMART_ROAD_RECORDER_BENCH_HPP
+
+#include <cstdio>
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/frame_parser.hpp"
+#include "../src/frame_recorder.hpp"
+
+/// Файл, в который пишется запись во время бенчмарка
+#define RECORDER_BENCH_PATH     "smart_road_radar_bench.rec"
+/// Количество кадров в синтетическом потоке
+#define RECORDER_BENCH_FRAMES   64
+/// Количество целей в кадре синтетического потока
+#define RECORDER_BENCH_TARGETS  35
+/// Частота кадров в бенчмарках с расписанием, в 100 раз выше DATA_FREQ_20
+#define RECORDER_BENCH_RATE     2000
+
+/**
+ * \brief Разбор одного кадра потока с записью, если он верный
+ *
+ * После последнего кадра разбор продолжается с начала потока.
+ *
+ * \param [in,out] parser Парсер
+ * \param [in,out] recorder Объект записи или nullptr, если кадры не записываются
+ * \param [in] stream Поток байт
+ * \param [in,out] offset Позиция в потоке
+ * \return true, если разобран кадр с верной контрольной суммой
+ */
+bool parse_and_record_frame(FrameParser &parser, FrameRecorder *recorder, const std::vector<u_byte_t> &stream,
+                            size_t *offset) {
+    while (true) {
+        if (*offset >= stream.size()) {
+            *offset = 0;
+        }
+
+        frame_view view;
+        size_t consumed;
+
+        int result = parser.parse(stream.data() + *offset, stream.size() - *offset, &consumed, &view);
+        *offset += consumed;
+
+        if (result == FRAME_PARSER_FRAME_READY) {
+            if (view.is_valid && recorder != nullptr) {
+                recorder->record(1, view.word, view.payload, view.data_length, view.checksum,
+                                 std::chrono::system_clock::now());
+            }
+
+            return view.is_valid;
+        }
+    }
+}
+
+/**
+ * \brief Регистрация бенчмарков записи кадров
+ *
+ * Кадры разбираются по одному с частотой RECORDER_BENCH_RATE без записи и с записью каждого кадра:
+ * разница времени обработки кадра - это задержка, которую запись добавляет потоку чтения. Запись в файл
+ * выполняется потоком FrameRecorder и в измерение не входит. Отдельно измеряется чтение кадров из файла
+ * в случайном порядке через индекс.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_recorder_bench(BenchRunner &runner) {
+    std::vector<u_byte_t> stream = make_target_stream(RECORDER_BENCH_FRAMES, RECORDER_BENCH_TARGETS);
+
+    FrameParser parser;
+    FrameRecorder recorder;
+    size_t offset = 0;
+
+    runner.run_paced("recorder/parse_only", "frames", 1, RECORDER_BENCH_RATE, [&]() {
+        do_not_optimize(parse_and_record_frame(parser, nullptr, stream, &offset));
+    });
+
+    if (recorder.open(RECORDER_BENCH_PATH) != RECORDER_OK) {
+        printf("recorder: can't create %s\n", RECORDER_BENCH_PATH);
+        return;
+    }
+
+    runner.run_paced("recorder/parse_and_record", "frames", 1, RECORDER_BENCH_RATE, [&]() {
+        do_not_optimize(parse_and_record_frame(parser, &recorder, stream, &offset));
+    });
+
+    recorder.close();
+
+    recorder_statistics statistics = recorder.get_statistics();
+
+    if (statistics.frames_recorded > 0) {
+        printf("recorder: %llu frames recorded, %llu dropped, %.1f MB written\n",
+               statistics.frames_recorded,
+               statistics.frames_dropped,
+               (double) statistics.bytes_written / 1e6);
+    }
+
+    FrameRecording recording;
+
+    if (recording.open(RECORDER_BENCH_PATH) == RECORDER_OK && recording.get_frame_count() > 0) {
+        size_t frame_count = recording.get_frame_count();
+        unsigned int state = 1;
+
+        runner.run("recorder/get_frame/random", "frames", 1, [&]() {
+            recorded_frame received_frame;
+
+            state = state * 1664525u + 1013904223u;
+            recording.get_frame(state % frame_count, &received_frame);
+
+            do_not_optimize(received_frame.payload[0]);
+        });
+    }
+
+    recording.close();
+    remove(RECORDER_BENCH_PATH);
+}
+
+#endif //SMART_ROAD_RECORDER_BENCH_HPP
@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки разбора и декодирования записанных кадров через SmartRoadRadarReplay
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_REPLAY_BENCH_HPP
+#define SMART_ROAD_REPLAY_BENCH_HPP
+
+#include <cstdio>
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/frame_parser.hpp"
+#include "../src/smart_road_radar_replay.hpp"
+
+/// Файл записи, которую воспроизводят бенчмарки
+#define REPLAY_BENCH_PATH       "smart_road_radar_replay_bench.rec"
+/// Количество кадров в записи
+#define REPLAY_BENCH_FRAMES     64
+/// Количество целей в кадре записи
+#define REPLAY_BENCH_TARGETS    35
+/// Частота кадров в бенчмарке с расписанием, в 100 раз выше DATA_FREQ_20
+#define REPLAY_BENCH_RATE       2000
+
+/**
+ * \brief Создание записи из синтетического потока
+ *
+ * \param [in] path Путь к файлу записи
+ * \return RECORDER_OK, если запись создана. В противном случае - RECORDER_ERROR.
+ */
+int make_replay_recording(const char *path) {
+    std::vector<u_byte_t> stream = make_target_stream(REPLAY_BENCH_FRAMES, REPLAY_BENCH_TARGETS);
+
+    FrameParser parser;
+    FrameRecorder recorder;
+
+    if (recorder.open(path, REPLAY_BENCH_FRAMES) != RECORDER_OK) {
+        return RECORDER_ERROR;
+    }
+
+    auto received_at = std::chrono::system_clock::now();
+
+    for (size_t offset = 0; offset < stream.size();) {
+        frame_view view;
+        size_t consumed;
+
+        if (parser.parse(stream.data() + offset, stream.size() - offset, &consumed, &view) == FRAME_PARSER_FRAME_READY &&
+            view.is_valid) {
+            recorder.record(1, view.word, view.payload, view.data_length, view.checksum, received_at);
+            received_at += std::chrono::milliseconds(1000 / DATA_FREQ_20);
+        }
+
+        offset += consumed;
+    }
+
+    recorder.close();
+
+    return recorder.get_statistics().frames_dropped == 0 ? RECORDER_OK : RECORDER_ERROR;
+}
+
+/**
+ * \brief Регистрация бенчмарков воспроизведения
+ *
+ * Запись воспроизводится по кругу без пауз, каждая итерация - один вызов get_target_data(), то есть
+ * разбор кадра read_frame() и декодирование целей (и облака точек) теми же функциями, что и для радара.
+ * Бенчмарк с расписанием показывает задержку обработки одного кадра при частоте кадров REPLAY_BENCH_RATE.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_replay_bench(BenchRunner &runner) {
+    if (make_replay_recording(REPLAY_BENCH_PATH) != RECORDER_OK) {
+        printf("replay: can't create %s\n", REPLAY_BENCH_PATH);
+        return;
+    }
+
+    {
+        SmartRoadRadarReplay radar(REPLAY_BENCH_PATH, REPLAY_AS_FAST_AS_POSSIBLE);
+        target_batch batch;
+        point_cloud_block cloud;
+
+        radar.set_loop(true);
+
+        runner.run("replay/get_target_data", "frames", 1, [&]() {
+            do_not_optimize(radar.get_target_data(&batch));
+        });
+
+        runner.run("replay/get_target_data/point_cloud", "frames", 1, [&]() {
+            do_not_optimize(radar.get_target_data(&batch, &cloud));
+        });
+
+        runner.run_paced("replay/get_target_data/paced", "frames", 1, REPLAY_BENCH_RATE, [&]() {
+            do_not_optimize(radar.get_target_data(&batch));
+        });
+    }
+
+    remove(REPLAY_BENCH_PATH);
+}
+
+#endif //SMART_ROAD_REPLAY_BENCH_HPP
@@ -0,0 +1,98 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки перевода целей в координаты дороги
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_ROAD_TRANSFORM_BENCH_HPP
+#define SMART_ROAD_ROAD_TRANSFORM_BENCH_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include "bench.hpp"
+#include "../src/road_transform.hpp"
+
+/**
+ * \brief Перевод целей в координаты дороги через std::sin и std::cos для каждой цели
+ *
+ * Так координаты вычислялись потребителями данных до появления RoadTransform.
+ *
+ * \param [in] calibration Калибровка установки радара
+ * \param [in,out] batch Пакет целей
+ */
+void transform_targets_sincos(const radar_calibration &calibration, target_batch *batch) {
+    for (int pos = 0; pos < batch->count; ++pos) {
+        float angle = (batch->angle[pos] + calibration.yaw + calibration.angle_offset) *
+                      (float) ROAD_TRANSFORM_DEGREES_TO_RADIANS;
+
+        float distance_squared = batch->distance[pos] * batch->distance[pos] - calibration.height * calibration.height;
+        float ground = distance_squared > 0 ? std::sqrt(distance_squared) : 0.0f;
+
+        batch->road_x[pos] = calibration.x + ground * std::sin(angle);
+        batch->road_y[pos] = calibration.y + ground * std::cos(angle);
+    }
+}
+
+/**
+ * \brief Регистрация бенчмарков перевода в координаты дороги
+ *
+ * Пакет из TARGET_BATCH_CAPACITY целей с углами, кратными разрешению радара, переводится через std::sin и std::cos
+ * и через таблицу RoadTransform. Печатается наибольшее расхождение координат между способами.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_road_transform_bench(BenchRunner &runner) {
+    radar_calibration calibration;
+    calibration.x = -7.0f;
+    calibration.y = -3.0f;
+    calibration.height = 6.0f;
+    calibration.yaw = -12.5f;
+    calibration.angle_offset = 0.3f;
+
+    std::unique_ptr<target_batch> batch(new target_batch());
+    unsigned int state = 1;
+
+    batch->count = TARGET_BATCH_CAPACITY;
+
+    for (int pos = 0; pos < batch->count; ++pos) {
+        state = state * 1664525u + 1013904223u;
+        batch->distance[pos] = (float) ((state >> 16) % 20000) * SCALE;
+
+        state = state * 1664525u + 1013904223u;
+        batch->angle[pos] = (float) ((int) ((state >> 16) % 12000) - 6000) * SCALE;
+    }
+
+    RoadTransform transform(calibration);
+
+    runner.run("road_transform/sincos/255_targets", "targets", TARGET_BATCH_CAPACITY, [&]() {
+        transform_targets_sincos(calibration, batch.get());
+        do_not_optimize(batch->road_x[0]);
+    });
+
+    runner.run("road_transform/table/255_targets", "targets", TARGET_BATCH_CAPACITY, [&]() {
+        transform.apply(batch.get());
+        do_not_optimize(batch->road_x[0]);
+    });
+
+    if (runner.is_selected("road_transform/")) {
+        std::unique_ptr<target_batch> reference(new target_batch(*batch));
+
+        transform.apply(batch.get());
+        transform_targets_sincos(calibration, reference.get());
+
+        float max_error = 0;
+
+        for (int pos = 0; pos < batch->count; ++pos) {
+            max_error = std::fmax(max_error, std::fabs(batch->road_x[pos] - reference->road_x[pos]));
+            max_error = std::fmax(max_error, std::fabs(batch->road_y[pos] - reference->road_y[pos]));
+        }
+
+        printf("road_transform: max difference from std::sin/std::cos %.4f m\n", max_error);
+    }
+}
+
+#endif //SMART_ROAD_ROAD_TRANSFORM_BENCH_HPP
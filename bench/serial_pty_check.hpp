@@ -0,0 +1,287 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий проверку последовательного порта POSIX на псевдотерминале
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_SERIAL_PTY_CHECK_HPP
+#define SMART_ROAD_SERIAL_PTY_CHECK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "bench.hpp"
+#include "synthetic_stream.hpp"
+#include "../src/smart_road_radar.hpp"
+
+/// Версия ПО, которую сообщает радар, эмулируемый на ведущей стороне псевдотерминала
+#define SERIAL_PTY_VERSION_MAJOR    3
+#define SERIAL_PTY_VERSION_MINOR    1
+#define SERIAL_PTY_VERSION_PATCH    4
+
+/// Срок ожидания данных из порта без данных, мс
+#define SERIAL_PTY_IDLE_TIMEOUT     300
+/// Наибольшее количество вызовов чтения за срок ожидания: порт должен ждать в epoll, а не опрашиваться в цикле
+#define SERIAL_PTY_IDLE_READ_CALLS  (SERIAL_PTY_IDLE_TIMEOUT / SERIAL_READ_POLL_TIMEOUT + 4)
+/// Наибольшее процессорное время потока за срок ожидания, мс
+#define SERIAL_PTY_IDLE_CPU_TIME    30
+
+#ifndef _WIN32
+
+/**
+ * \brief Открытие ведущей стороны псевдотерминала
+ *
+ * \return Дескриптор ведущей стороны или -1, если псевдотерминал не создан
+ */
+int open_pty_master() {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (master >= 0 && (grantpt(master) != 0 || unlockpt(master) != 0)) {
+        close(master);
+        return -1;
+    }
+
+    return master;
+}
+
+/**
+ * \brief Эмуляция радара на ведущей стороне псевдотерминала: ответ на каждый CMD_REQUEST_VERSION
+ *
+ * \param [in] master Дескриптор ведущей стороны
+ * \param [in] serving Флаг работы, после сброса функция завершается
+ */
+void serve_version_requests(int master, const std::atomic<bool> *serving) {
+    FrameParser command_parser;
+    u_byte_t received[256];
+
+    const u_byte_t version[] = {SERIAL_PTY_VERSION_MAJOR, SERIAL_PTY_VERSION_MINOR, SERIAL_PTY_VERSION_PATCH};
+    std::vector<u_byte_t> reply;
+
+    append_frame(reply, CMD_READ_VERSION, version, sizeof version);
+
+    while (serving->load()) {
+        pollfd descriptor{master, POLLIN, 0};
+
+        if (poll(&descriptor, 1, SERIAL_READ_POLL_TIMEOUT) <= 0) {
+            continue;
+        }
+
+        ssize_t size = read(master, received, sizeof received);
+
+        if (size <= 0) {
+            return;
+        }
+
+        const u_byte_t *data = received;
+        size_t length = (size_t) size;
+
+        while (length > 0) {
+            frame_view command;
+            size_t consumed = 0;
+
+            if (command_parser.parse(data, length, &consumed, &command) == FRAME_PARSER_FRAME_READY &&
+                command.is_valid && command.word == CMD_REQUEST_VERSION) {
+                ssize_t written = write(master, reply.data(), reply.size());
+                do_not_optimize(written);
+            }
+
+            data += consumed;
+            length -= consumed;
+        }
+    }
+}
+
+/**
+ * \brief Процессорное время текущего потока, мс
+ */
+double get_thread_cpu_time_ms() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+    return (double) time.tv_sec * 1e3 + (double) time.tv_nsec / 1e6;
+}
+
+/**
+ * \brief Запрос версии через SmartRoadRadar и разбор ответа, записанного в ведущую сторону
+ *
+ * Время одного обмена измеряется как бенчмарк serial/pty/version_round_trip.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \return BENCH_OK, если все ответы получены и совпали с версией эмулятора. В противном случае - BENCH_ERROR.
+ */
+int check_version_round_trip(BenchRunner &runner) {
+    int master = open_pty_master();
+
+    if (master < 0) {
+        printf("serial/pty/version_round_trip: can't open a pseudo terminal\n");
+        return BENCH_ERROR;
+    }
+
+    port_config config{230400, 8, ONESTOPBIT, NOPARITY};
+    SmartRoadRadar radar(ptsname(master), config);
+
+    std::atomic<bool> serving{true};
+    std::thread responder(serve_version_requests, master, &serving);
+
+    unsigned long long requests = 0;
+    unsigned long long failures = 0;
+
+    runner.run("serial/pty/version_round_trip", "requests", 1, [&]() {
+        u_byte_t version[3] = {};
+
+        ++requests;
+
+        if (radar.get_firmware_version(version) != SMART_ROAD_RADAR_OK ||
+            version[0] != SERIAL_PTY_VERSION_MAJOR ||
+            version[1] != SERIAL_PTY_VERSION_MINOR ||
+            version[2] != SERIAL_PTY_VERSION_PATCH) {
+            ++failures;
+        }
+    });
+
+    serving.store(false);
+    responder.join();
+    close(master);
+
+    if (requests == 0 || failures > 0) {
+        printf("serial/pty/version_round_trip: FAILED, %llu of %llu requests without a valid reply\n",
+               failures, requests);
+        return BENCH_ERROR;
+    }
+
+    return BENCH_OK;
+}
+
+/**
+ * \brief Ожидание данных из порта, в который ничего не пишут
+ *
+ * Чтение должно дождаться срока в epoll: вернуть SERIAL_TIMEOUT не раньше срока, выполнив не больше
+ * SERIAL_PTY_IDLE_READ_CALLS системных вызовов чтения и не больше SERIAL_PTY_IDLE_CPU_TIME мс процессорного времени.
+ *
+ * \return BENCH_OK, если проверка пройдена. В противном случае - BENCH_ERROR.
+ */
+int check_idle_read() {
+    int master = open_pty_master();
+
+    if (master < 0) {
+        printf("serial/pty/idle_read: can't open a pseudo terminal\n");
+        return BENCH_ERROR;
+    }
+
+    port_config config{230400, 8, ONESTOPBIT, NOPARITY};
+    Serial serial(ptsname(master), config);
+
+    const u_byte_t *chunk = nullptr;
+    auto start = std::chrono::steady_clock::now();
+    double cpu_start_ms = get_thread_cpu_time_ms();
+
+    serial.set_read_deadline(start + std::chrono::milliseconds(SERIAL_PTY_IDLE_TIMEOUT));
+
+    size_t length = serial.peek_u_bytes(&chunk);
+    int status = serial.get_read_status();
+
+    double cpu_ms = get_thread_cpu_time_ms() - cpu_start_ms;
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    unsigned long long read_calls = serial.get_statistics().read_calls;
+
+    close(master);
+
+    if (length != 0 || status != SERIAL_TIMEOUT || elapsed_ms < SERIAL_PTY_IDLE_TIMEOUT ||
+        read_calls > SERIAL_PTY_IDLE_READ_CALLS || cpu_ms > SERIAL_PTY_IDLE_CPU_TIME) {
+        printf("serial/pty/idle_read: FAILED, status %d after %.1f ms, %llu read calls, %.1f ms of CPU\n",
+               status, elapsed_ms, read_calls, cpu_ms);
+        return BENCH_ERROR;
+    }
+
+    printf("serial/pty/idle_read: ok, %llu read calls and %.1f ms of CPU in %.1f ms\n",
+           read_calls, cpu_ms, elapsed_ms);
+
+    return BENCH_OK;
+}
+
+/**
+ * \brief Чтение из порта после закрытия ведущей стороны
+ *
+ * Отключение устройства должно завершать ожидание с SERIAL_ERROR, а не SERIAL_TIMEOUT по сроку.
+ *
+ * \return BENCH_OK, если проверка пройдена. В противном случае - BENCH_ERROR.
+ */
+int check_hangup() {
+    int master = open_pty_master();
+
+    if (master < 0) {
+        printf("serial/pty/hangup: can't open a pseudo terminal\n");
+        return BENCH_ERROR;
+    }
+
+    port_config config{230400, 8, ONESTOPBIT, NOPARITY};
+    Serial serial(ptsname(master), config);
+
+    close(master);
+
+    const u_byte_t *chunk = nullptr;
+    auto start = std::chrono::steady_clock::now();
+
+    serial.set_read_deadline(start + std::chrono::milliseconds(SERIAL_PTY_IDLE_TIMEOUT));
+
+    size_t length = serial.peek_u_bytes(&chunk);
+    int status = serial.get_read_status();
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (length != 0 || status != SERIAL_ERROR) {
+        printf("serial/pty/hangup: FAILED, status %d after %.1f ms\n", status, elapsed_ms);
+        return BENCH_ERROR;
+    }
+
+    printf("serial/pty/hangup: ok, SERIAL_ERROR after %.1f ms\n", elapsed_ms);
+
+    return BENCH_OK;
+}
+
+#endif
+
+/**
+ * \brief Сквозная проверка последовательного порта POSIX на паре псевдотерминалов
+ *
+ * Ведущая сторона псевдотерминала играет роль радара, а Serial открывает ведомую сторону, как настоящий порт.
+ * Проверяются обмен запросом версии и ответом, ожидание в epoll на порту без данных и ошибка чтения после
+ * закрытия ведущей стороны. На Windows проверка не выполняется.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \return BENCH_OK, если выбранные фильтром проверки пройдены. В противном случае - BENCH_ERROR.
+ */
+int run_serial_pty_check(BenchRunner &runner) {
+    int status = BENCH_OK;
+
+#ifndef _WIN32
+    if (runner.is_selected("serial/pty/version_round_trip") && check_version_round_trip(runner) != BENCH_OK) {
+        status = BENCH_ERROR;
+    }
+
+    if (runner.is_selected("serial/pty/idle_read") && check_idle_read() != BENCH_OK) {
+        status = BENCH_ERROR;
+    }
+
+    if (runner.is_selected("serial/pty/hangup") && check_hangup() != BENCH_OK) {
+        status = BENCH_ERROR;
+    }
+#endif
+
+    return status;
+}
+
+#endif //SMART_ROAD_SERIAL_PTY_CHECK_HPP
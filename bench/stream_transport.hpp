@@ -0,0 +1,135 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий канал обмена, выдающий синтетический поток байт из памяти
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_STREAM_TRANSPORT_HPP
+#define SMART_ROAD_STREAM_TRANSPORT_HPP
+
+#include <utility>
+#include <vector>
+
+#include "../src/smart_road_radar.hpp"
+
+/**
+ * \brief Канал, выдающий поток байт из памяти по кругу
+ *
+ * Байты выдаются через peek_u_bytes() порциями не больше chunk_size, как их выдавал бы последовательный порт,
+ * после конца потока выдача начинается сначала. Отправляемые байты отбрасываются. Канал не ждёт данных,
+ * поэтому измеряется только разбор и декодирование.
+ */
+class StreamTransport : public Transport {
+
+private:
+    std::vector<u_byte_t> stream;
+    size_t stream_pos = 0;
+    size_t chunk_size;
+
+    serial_statistics statistics{};
+
+public:
+    /**
+     * \brief Конструктор с потоком байт.
+     *
+     * \param [in] new_stream Поток байт
+     * \param [in] new_chunk_size Наибольший размер порции, выдаваемой за одно чтение
+     */
+    explicit StreamTransport(std::vector<u_byte_t> new_stream, size_t new_chunk_size = 4096)
+            : stream(std::move(new_stream)), chunk_size(new_chunk_size) {}
+
+    size_t peek_u_bytes(const u_byte_t **chunk) override {
+        if (stream_pos == stream.size()) {
+            stream_pos = 0;
+        }
+
+        size_t length = stream.size() - stream_pos;
+
+        if (length > chunk_size) {
+            length = chunk_size;
+        }
+
+        ++statistics.read_calls;
+        statistics.bytes_received += length;
+
+        *chunk = stream.data() + stream_pos;
+
+        return length;
+    }
+
+    void skip_u_bytes(size_t count) override {
+        if (count > stream.size() - stream_pos) {
+            count = stream.size() - stream_pos;
+        }
+
+        stream_pos += count;
+    }
+
+    int write_u_bytes(u_byte_t * /*data*/, size_t length) override {
+        ++statistics.write_calls;
+        statistics.bytes_sent += length;
+
+        return SERIAL_OK;
+    }
+
+    bool is_open() const override {
+        return !stream.empty();
+    }
+
+    void cancel_reads() override {}
+
+    void resume_reads() override {}
+
+    void set_read_deadline(std::chrono::steady_clock::time_point /*deadline*/) override {}
+
+    void clear_read_deadline() override {}
+
+    void set_timeouts(const serial_timeouts & /*new_timeouts*/) override {}
+
+    int get_read_status() const override {
+        return SERIAL_OK;
+    }
+
+    serial_statistics get_statistics() const override {
+        return statistics;
+    }
+
+    void reset_statistics() override {
+        statistics = serial_statistics{};
+    }
+};
+
+/**
+ * \brief Радар, читающий кадры из StreamTransport
+ *
+ * Кадры проходят через неизменённые read_frame() и get_target_data() SmartRoadRadar. read_frame()
+ * открыта для бенчмарка разбора без декодирования.
+ */
+class StreamRadar : public SmartRoadRadar {
+
+private:
+    StreamTransport stream;
+
+public:
+    using SmartRoadRadar::read_frame;
+
+    /**
+     * \brief Конструктор с потоком байт.
+     *
+     * \param [in] new_stream Поток байт
+     * \param [in] chunk_size Наибольший размер порции, выдаваемой за одно чтение
+     */
+    explicit StreamRadar(std::vector<u_byte_t> new_stream, size_t chunk_size = 4096)
+            : stream(std::move(new_stream), chunk_size) {
+        set_transport(&stream);
+    }
+
+    ~StreamRadar() override {
+        stop_acquisition();
+        set_transport(nullptr);
+    }
+};
+
+#endif //SMART_ROAD_STREAM_TRANSPORT_HPP
@@ -0,0 +1,101 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий генератор синтетических потоков байт протокола радара
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_SYNTHETIC_STREAM_HPP
+#define SMART_ROAD_SYNTHETIC_STREAM_HPP
+
+#include <vector>
+
+#include "../src/smart_road_radar_utils.hpp"
+
+/**
+ * \brief Добавляет в поток кадр с заданным командным словом и полезной нагрузкой
+ *
+ * \param [in,out] stream Поток байт
+ * \param [in] word Командное слово
+ * \param [in] payload Полезная нагрузка
+ * \param [in] payload_length Размер полезной нагрузки
+ */
+void append_frame(std::vector<u_byte_t> &stream, u_byte_t word, const u_byte_t *payload, size_t payload_length) {
+    u_short_t data_length = (u_short_t) (payload_length + 1);
+    u_byte_t checksum = 0x00;
+
+    stream.push_back(HEADER_DATA_FRAME_1);
+    stream.push_back(HEADER_DATA_FRAME_2);
+
+    stream.push_back((u_byte_t) (data_length & 0xFF));
+    stream.push_back((u_byte_t) (data_length >> 8));
+    stream.push_back(word);
+
+    checksum += (u_byte_t) (data_length & 0xFF);
+    checksum += (u_byte_t) (data_length >> 8);
+    checksum += word;
+
+    for (size_t i = 0; i < payload_length; ++i) {
+        stream.push_back(payload[i]);
+        checksum += payload[i];
+    }
+
+    stream.push_back(checksum);
+}
+
+/**
+ * \brief Формирует полезную нагрузку кадра CMD_READ_TARGET_DATA
+ *
+ * Нагрузка состоит из пустого байта, облака точек размером TARGET_DATA_BYTE_OFFSET, записей о целях
+ * размером TARGET_DATA_BYTE_LENGTH и завершающего пустого байта.
+ *
+ * \param [in] target_count Количество целей
+ * \param [in] seed Начальное значение генератора значений
+ * \return Полезная нагрузка кадра
+ */
+std::vector<u_byte_t> make_target_payload(int target_count, unsigned int seed) {
+    std::vector<u_byte_t> payload(2 + TARGET_DATA_BYTE_OFFSET + TARGET_DATA_BYTE_LENGTH * target_count, 0x00);
+    unsigned int state = seed * 2654435761u + 1;
+
+    for (size_t i = 1; i < 1 + TARGET_DATA_BYTE_OFFSET; ++i) {
+        state = state * 1664525u + 1013904223u;
+        payload[i] = (u_byte_t) (state >> 24);
+    }
+
+    for (int target = 0; target < target_count; ++target) {
+        u_byte_t *record = payload.data() + 1 + TARGET_DATA_BYTE_OFFSET + TARGET_DATA_BYTE_LENGTH * target;
+
+        record[0] = (u_byte_t) (target + 1);
+
+        for (int field = 0; field < 4; ++field) {
+            state = state * 1664525u + 1013904223u;
+            short value = (short) ((state >> 16) % 2000) - (field == 2 ? 1000 : 0);
+
+            record[2 + 2 * field] = (u_byte_t) (value & 0xFF);
+            record[3 + 2 * field] = (u_byte_t) ((value >> 8) & 0xFF);
+        }
+    }
+
+    return payload;
+}
+
+/**
+ * \brief Формирует поток из кадров CMD_READ_TARGET_DATA
+ *
+ * \param [in] frame_count Количество кадров
+ * \param [in] target_count Количество целей в каждом кадре
+ * \return Поток байт
+ */
+std::vector<u_byte_t> make_target_stream(int frame_count, int target_count) {
+    std::vector<u_byte_t> stream;
+
+    for (int i = 0; i < frame_count; ++i) {
+        std::vector<u_byte_t> payload = make_target_payload(target_count, i);
+        append_frame(stream, CMD_READ_TARGET_DATA, payload.data(), payload.size());
+    }
+
+    return stream;
+}
+
+#endif //SMART_ROAD_SYNTHETIC_STREAM_HPP
@@ -0,0 +1,200 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки сопровождения целей TargetTracker
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_TRACKER_BENCH_HPP
+#define SMART_ROAD_TRACKER_BENCH_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "../src/target_tracker.hpp"
+
+/// Количество кадров в синтетической последовательности
+#define TRACKER_BENCH_FRAMES    400
+/// Количество радаров в бенчмарке с расписанием
+#define TRACKER_BENCH_RADARS    32
+/// Частота кадров одного радара, Гц (DATA_FREQ_20)
+#define TRACKER_BENCH_RATE      20
+/// Количество пакетов, доставляемых подряд за один проход RadarManager::drain()
+#define TRACKER_BENCH_BURST     4
+/// Интервал между отметками времени пакетов внутри пачки, мкс
+#define TRACKER_BENCH_BURST_GAP 5
+
+/**
+ * \brief Формирует последовательность пакетов с движущимися целями
+ *
+ * Цели расставлены по полосам шириной 4 м и движутся вдоль оси радара со скоростью, постоянной для полосы.
+ * Расстояние между целями больше строба, поэтому связывание однозначно. Выехавшая за 160 м цель возвращается
+ * на 10 м и порождает новую траекторию.
+ *
+ * \param [in] frame_count Количество кадров
+ * \param [in] target_count Количество целей в кадре, не больше TARGET_BATCH_CAPACITY
+ * \return Пакеты целей с периодом TRACKER_DEFAULT_PERIOD
+ */
+std::vector<target_batch> make_moving_targets(int frame_count, int target_count) {
+    std::vector<target_batch> batches(frame_count);
+
+    const int lanes = 17;
+
+    for (int frame_pos = 0; frame_pos < frame_count; ++frame_pos) {
+        target_batch &batch = batches[frame_pos];
+        float t = (float) frame_pos * TRACKER_DEFAULT_PERIOD;
+
+        batch.count = target_count;
+
+        for (int target = 0; target < target_count; ++target) {
+            int lane = target % lanes;
+            int row = target / lanes;
+
+            float speed = 10.0f + (float) lane;
+            float x = ((float) lane - (float) (lanes / 2)) * 4.0f;
+            float y = 10.0f + std::fmod((float) row * 10.0f + speed * t, 150.0f);
+
+            float distance = std::sqrt(x * x + y * y);
+
+            batch.num[target] = (u_byte_t) (target + 1);
+            batch.distance[target] = distance;
+            batch.angle[target] = std::atan2(x, y) / TRACKER_DEGREES_TO_RADIANS;
+            batch.speed[target] = speed * y / distance;
+            batch.snr[target] = 20.0f;
+        }
+    }
+
+    return batches;
+}
+
+/**
+ * \brief Бенчмарк одного трекера на непрерывной последовательности кадров
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \param [in] target_count Количество целей в кадре
+ */
+void run_tracker_update_bench(BenchRunner &runner, int target_count) {
+    std::string name = "tracker/update/" + std::to_string(target_count) + "_targets";
+
+    std::vector<target_batch> batches = make_moving_targets(TRACKER_BENCH_FRAMES, target_count);
+
+    std::unique_ptr<TargetTracker> tracker(new TargetTracker());
+    auto received_at = std::chrono::steady_clock::time_point{};
+    size_t frame_pos = 0;
+
+    runner.run(name, "targets", target_count, [&]() {
+        received_at += std::chrono::milliseconds(1000 / TRACKER_BENCH_RATE);
+
+        const track_batch &tracks = tracker->update(batches[frame_pos], received_at);
+        do_not_optimize(tracks.count);
+
+        if (++frame_pos == batches.size()) {
+            frame_pos = 0;
+        }
+    });
+
+    tracker_statistics statistics = tracker->get_statistics();
+
+    if (statistics.updates > 0 && runner.is_selected(name)) {
+        printf("%s: %d confirmed tracks for %d targets, %.3f tracks created per update\n",
+               name.c_str(),
+               tracker->get_tracks().count,
+               target_count,
+               (double) statistics.tracks_created / (double) statistics.updates);
+    }
+}
+
+/**
+ * \brief Бенчмарк трекера при доставке пакетов пачками
+ *
+ * Так пакеты приходят из RadarManager::drain(): накопившиеся в порту кадры декодируются подряд и получают
+ * отметки времени с разницей в несколько микросекунд, после чего следует пауза на всю пачку. Качество
+ * сопровождения оценивается по количеству созданных траекторий на обновление, которое должно оставаться
+ * таким же, как при равномерной доставке.
+ *
+ * При пачках длиннее TRACKER_MAX_LEAD / TRACKER_MIN_PERIOD кадров отметка времени первого пакета пачки
+ * опаздывает на всю задержку, и траектории быстрых целей выходят из строба независимо от шага фильтра.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ * \param [in] target_count Количество целей в кадре
+ */
+void run_tracker_burst_bench(BenchRunner &runner, int target_count) {
+    std::string name = "tracker/update/" + std::to_string(target_count) + "_targets/burst";
+
+    std::vector<target_batch> batches = make_moving_targets(TRACKER_BENCH_FRAMES, target_count);
+
+    std::unique_ptr<TargetTracker> tracker(new TargetTracker());
+    auto received_at = std::chrono::steady_clock::time_point{};
+    size_t frame_pos = 0;
+
+    runner.run(name, "targets", target_count, [&]() {
+        if (frame_pos % TRACKER_BENCH_BURST == 0) {
+            received_at += std::chrono::milliseconds(TRACKER_BENCH_BURST * 1000 / TRACKER_BENCH_RATE);
+        } else {
+            received_at += std::chrono::microseconds(TRACKER_BENCH_BURST_GAP);
+        }
+
+        const track_batch &tracks = tracker->update(batches[frame_pos], received_at);
+        do_not_optimize(tracks.count);
+
+        if (++frame_pos == batches.size()) {
+            frame_pos = 0;
+        }
+    });
+
+    tracker_statistics statistics = tracker->get_statistics();
+
+    if (statistics.updates > 0 && runner.is_selected(name)) {
+        printf("%s: %d confirmed tracks for %d targets, %.3f tracks created per update\n",
+               name.c_str(),
+               tracker->get_tracks().count,
+               target_count,
+               (double) statistics.tracks_created / (double) statistics.updates);
+    }
+}
+
+/**
+ * \brief Регистрация бенчмарков сопровождения целей
+ *
+ * Измеряется обработка одного пакета из 35 и 255 целей, обработка пакетов, доставленных пачками, а также
+ * задержка обновления при потоке пакетов по 255 целей от TRACKER_BENCH_RADARS радаров с частотой TRACKER_BENCH_RATE, каждый со своим трекером.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_tracker_bench(BenchRunner &runner) {
+    run_tracker_update_bench(runner, 35);
+    run_tracker_update_bench(runner, TARGET_BATCH_CAPACITY);
+    run_tracker_burst_bench(runner, 35);
+
+    std::vector<target_batch> batches = make_moving_targets(TRACKER_BENCH_FRAMES, TARGET_BATCH_CAPACITY);
+    std::vector<std::unique_ptr<TargetTracker>> trackers;
+
+    for (int radar = 0; radar < TRACKER_BENCH_RADARS; ++radar) {
+        trackers.emplace_back(new TargetTracker());
+    }
+
+    auto received_at = std::chrono::steady_clock::now();
+    size_t update = 0;
+
+    runner.run_paced("tracker/update/255_targets/paced", "targets", TARGET_BATCH_CAPACITY,
+                     TRACKER_BENCH_RADARS * TRACKER_BENCH_RATE, [&]() {
+                size_t radar = update % TRACKER_BENCH_RADARS;
+                size_t frame_pos = (update / TRACKER_BENCH_RADARS) % batches.size();
+
+                if (radar == 0) {
+                    received_at += std::chrono::milliseconds(1000 / TRACKER_BENCH_RATE);
+                }
+
+                const track_batch &tracks = trackers[radar]->update(batches[frame_pos], received_at);
+                do_not_optimize(tracks.count);
+
+                ++update;
+            });
+}
+
+#endif //SMART_ROAD_TRACKER_BENCH_HPP
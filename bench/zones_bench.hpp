@@ -0,0 +1,152 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий бенчмарки классификации целей по зонам ZoneMap
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_ZONES_BENCH_HPP
+#define SMART_ROAD_ZONES_BENCH_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "../src/detection_zones.hpp"
+#include "../src/target_decoder.hpp"
+
+/// Количество полос
+#define ZONES_BENCH_LANES       8
+/// Количество участков на полосе
+#define ZONES_BENCH_SEGMENTS    25
+/// Длина участка полосы, м
+#define ZONES_BENCH_SEGMENT     6.0f
+/// Ширина полосы, м
+#define ZONES_BENCH_LANE_WIDTH  3.5f
+/// Смещение полосы по x на метр длины, чтобы рёбра зон не совпадали с сеткой
+#define ZONES_BENCH_SKEW        0.02f
+
+/**
+ * \brief Формирует зоны: участки полос, стоп-линии и диагональный пешеходный переход
+ *
+ * \return Многоугольники зон в порядке номеров, номер зоны - индекс в векторе
+ */
+std::vector<std::vector<zone_point>> make_bench_zones() {
+    std::vector<std::vector<zone_point>> zones;
+
+    for (int lane = 0; lane < ZONES_BENCH_LANES; ++lane) {
+        float left = ((float) lane - ZONES_BENCH_LANES / 2) * ZONES_BENCH_LANE_WIDTH;
+        float right = left + ZONES_BENCH_LANE_WIDTH;
+
+        for (int segment = 0; segment < ZONES_BENCH_SEGMENTS; ++segment) {
+            float near_y = (float) segment * ZONES_BENCH_SEGMENT;
+            float far_y = near_y + ZONES_BENCH_SEGMENT;
+
+            zones.push_back({
+                    {left + near_y * ZONES_BENCH_SKEW,  near_y},
+                    {right + near_y * ZONES_BENCH_SKEW, near_y},
+                    {right + far_y * ZONES_BENCH_SKEW,  far_y},
+                    {left + far_y * ZONES_BENCH_SKEW,   far_y}
+            });
+        }
+
+        zones.push_back({
+                {left + 40.0f * ZONES_BENCH_SKEW,  40.0f},
+                {right + 40.0f * ZONES_BENCH_SKEW, 40.0f},
+                {right + 41.0f * ZONES_BENCH_SKEW, 41.0f},
+                {left + 41.0f * ZONES_BENCH_SKEW,  41.0f}
+        });
+    }
+
+    zones.push_back({{-16.0f, 60.0f}, {-12.0f, 58.0f}, {16.0f, 72.0f}, {12.0f, 74.0f}});
+
+    return zones;
+}
+
+/**
+ * \brief Проверка попадания точки в многоугольник по правилу чётности пересечений
+ */
+bool is_inside_polygon(const std::vector<zone_point> &polygon, float x, float y) {
+    bool inside = false;
+
+    for (size_t pos = 0, previous = polygon.size() - 1; pos < polygon.size(); previous = pos++) {
+        const zone_point &a = polygon[pos];
+        const zone_point &b = polygon[previous];
+
+        if ((a.y <= y) != (b.y <= y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+/**
+ * \brief Регистрация бенчмарков зон
+ *
+ * Сравнивается классификация пакета из TARGET_BATCH_CAPACITY точек по растру ZoneMap с проверкой каждой
+ * точки по всем многоугольникам.
+ *
+ * \param [in,out] runner Объект, запускающий бенчмарки
+ */
+void run_zones_bench(BenchRunner &runner) {
+    std::vector<std::vector<zone_point>> polygons = make_bench_zones();
+
+    ZoneMap zones;
+
+    for (size_t zone = 0; zone < polygons.size(); ++zone) {
+        zones.add_zone((u_short_t) zone, polygons[zone]);
+    }
+
+    auto build_start = std::chrono::steady_clock::now();
+
+    if (zones.build() != ZONES_OK) {
+        printf("zones: can't build zone map\n");
+        return;
+    }
+
+    double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build_start).count();
+
+    if (runner.is_selected("zones/")) {
+        printf("zones: %zu zones, %zu cells, %zu zone sets, built in %.1f ms\n",
+               polygons.size(),
+               zones.get_cell_count(),
+               zones.get_set_count(),
+               build_ms);
+    }
+
+    alignas(32) float x[TARGET_BATCH_CAPACITY];
+    alignas(32) float y[TARGET_BATCH_CAPACITY];
+    u_short_t sets[TARGET_BATCH_CAPACITY];
+
+    unsigned int state = 1;
+
+    for (int pos = 0; pos < TARGET_BATCH_CAPACITY; ++pos) {
+        state = state * 1664525u + 1013904223u;
+        x[pos] = (float) (state >> 16) / 65536.0f * 36.0f - 18.0f;
+
+        state = state * 1664525u + 1013904223u;
+        y[pos] = (float) (state >> 16) / 65536.0f * 160.0f;
+    }
+
+    runner.run("zones/classify/255_targets", "targets", TARGET_BATCH_CAPACITY, [&]() {
+        zones.classify(x, y, TARGET_BATCH_CAPACITY, sets);
+        do_not_optimize(sets[0]);
+    });
+
+    runner.run("zones/point_in_polygon/255_targets", "targets", TARGET_BATCH_CAPACITY, [&]() {
+        int matches = 0;
+
+        for (int pos = 0; pos < TARGET_BATCH_CAPACITY; ++pos) {
+            for (const std::vector<zone_point> &polygon: polygons) {
+                matches += is_inside_polygon(polygon, x[pos], y[pos]);
+            }
+        }
+
+        do_not_optimize(matches);
+    });
+}
+
+#endif //SMART_ROAD_ZONES_BENCH_HPP
@@ -0,0 +1,149 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий политику повторов команд и поток асинхронного выполнения команд CommandExecutor
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_COMMAND_EXECUTOR_HPP
+#define SMART_ROAD_COMMAND_EXECUTOR_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// Количество попыток отправки команды по умолчанию
+#define COMMAND_ATTEMPTS            10
+/// Срок выполнения команды по умолчанию, мс
+#define COMMAND_DEADLINE            2000
+/// Время ожидания ответа на одну попытку по умолчанию, мс
+#define COMMAND_ATTEMPT_TIMEOUT     200
+/// Пауза перед первой повторной попыткой по умолчанию, мс
+#define COMMAND_BACKOFF             10
+/// Максимальная пауза между попытками по умолчанию, мс
+#define COMMAND_MAX_BACKOFF         200
+
+/**
+ * \brief Политика выполнения команды
+ *
+ * Команда повторяется, пока радар не подтвердит её выполнение, не закончатся попытки
+ * или не истечёт срок. Пауза между попытками растёт в backoff_multiplier раз, но не больше max_backoff.
+ */
+struct command_policy {
+    int attempts = COMMAND_ATTEMPTS;                                        ///< Максимальное количество попыток
+    std::chrono::milliseconds deadline{COMMAND_DEADLINE};                   ///< Срок выполнения команды целиком
+    std::chrono::milliseconds attempt_timeout{COMMAND_ATTEMPT_TIMEOUT};     ///< Время ожидания ответа на одну попытку
+    std::chrono::milliseconds backoff{COMMAND_BACKOFF};                     ///< Пауза перед первой повторной попыткой
+    float backoff_multiplier = 2.0f;                                        ///< Множитель паузы
+    std::chrono::milliseconds max_backoff{COMMAND_MAX_BACKOFF};             ///< Максимальная пауза между попытками
+};
+
+/// Структура результата выполнения команды
+struct command_result {
+    int status = 0;                             ///< SMART_ROAD_RADAR_OK, SMART_ROAD_RADAR_ERROR или SMART_ROAD_RADAR_TIMEOUT
+    int attempts = 0;                           ///< Количество выполненных попыток
+    std::chrono::microseconds latency{};        ///< Время от постановки команды в очередь до получения результата
+};
+
+/// Функция, вызываемая по завершении асинхронной команды
+typedef std::function<void(const command_result &)> command_callback;
+
+/**
+ * \brief Поток последовательного выполнения команд
+ *
+ * Задачи выполняются в порядке постановки в очередь в отдельном потоке, который запускается
+ * при постановке первой задачи. У каждого радара свой поток, поэтому команды разным радарам
+ * выполняются одновременно, а команды одному радару - по очереди.
+ *
+ * **Пример**
+ * \code
+ * CommandExecutor executor;
+ *
+ * executor.submit([]() {
+ *     printf("Executed in background\n");
+ * });
+ * \endcode
+ */
+class CommandExecutor {
+
+private:
+    std::deque<std::function<void()>> tasks;
+
+    std::mutex tasks_mutex;
+    std::condition_variable tasks_signal;
+
+    std::thread worker;
+    bool stopping = false;
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(tasks_mutex);
+
+        while (true) {
+            tasks_signal.wait(lock, [this]() {
+                return stopping || !tasks.empty();
+            });
+
+            if (tasks.empty()) {
+                return;
+            }
+
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+public:
+    CommandExecutor() = default;
+
+    CommandExecutor(const CommandExecutor &) = delete;
+    CommandExecutor &operator=(const CommandExecutor &) = delete;
+
+    ~CommandExecutor() {
+        stop();
+    }
+
+    /**
+     * \brief Постановка задачи в очередь.
+     *
+     * \param [in] task Выполняемая задача
+     */
+    void submit(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+
+        if (!worker.joinable()) {
+            stopping = false;
+            worker = std::thread(&CommandExecutor::worker_loop, this);
+        }
+
+        tasks.push_back(std::move(task));
+        tasks_signal.notify_one();
+    }
+
+    /**
+     * \brief Остановка потока.
+     *
+     * Задачи, поставленные в очередь до вызова, выполняются до конца.
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+
+            stopping = true;
+            tasks_signal.notify_one();
+        }
+
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+};
+
+#endif //SMART_ROAD_COMMAND_EXECUTOR_HPP
@@ -0,0 +1,475 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий растровую карту зон детектирования ZoneMap
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_DETECTION_ZONES_HPP
+#define SMART_ROAD_DETECTION_ZONES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "target_decoder.hpp"
+
+/// Возвращаемое значение при успешной работе с зонами
+#define ZONES_OK        0
+/// Возвращаемое значение при ошибке работы с зонами
+#define ZONES_ERROR     1
+
+/// Размер ячейки растра по умолчанию, м
+#define ZONE_CELL_SIZE          0.25f
+/// Максимальное количество ячеек растра
+#define ZONE_MAX_CELLS          (16 * 1024 * 1024)
+/// Максимальное количество различных сочетаний зон в ячейках
+#define ZONE_MAX_SETS           65535
+/// Максимальное количество вершин многоугольника в файле зон
+#define ZONE_MAX_VERTICES       64
+/// Номер пустого сочетания зон, к которому относятся точки вне всех зон
+#define ZONE_SET_EMPTY          0
+
+/**
+ * \brief Вершина многоугольника зоны в координатах дороги, м
+ */
+struct zone_point {
+    float x;    ///< Поперечная координата
+    float y;    ///< Продольная координата
+};
+
+/**
+ * \brief Сочетание зон, которым принадлежит ячейка растра
+ *
+ * Номера зон упорядочены по возрастанию.
+ */
+struct zone_set {
+    const u_short_t *zones;     ///< Номера зон
+    int count;                  ///< Количество зон
+};
+
+/**
+ * \brief Растровая карта зон детектирования одного радара
+ *
+ * Многоугольники зон (полосы, стоп-линии) задаются в координатах дороги и при вызове build() растеризуются
+ * в сетку с ячейкой cell_size. Каждая ячейка хранит номер сочетания зон, которым принадлежит её центр,
+ * а сами сочетания хранятся один раз. Поэтому классификация цели - это вычисление индекса ячейки и чтение
+ * одного числа, без проверок попадания в многоугольники, независимо от количества зон.
+ *
+ * Граница зоны определяется с точностью до размера ячейки.
+ *
+ * **Пример**
+ * \code
+ * ZoneMap zones;
+ *
+ * zones.add_zone(1, {{-1.75f, 0.0f}, {1.75f, 0.0f}, {1.75f, 120.0f}, {-1.75f, 120.0f}});
+ * zones.add_zone(100, {{-1.75f, 40.0f}, {1.75f, 40.0f}, {1.75f, 41.0f}, {-1.75f, 41.0f}});
+ *
+ * if (zones.build() == ZONES_OK) {
+ *     zone_set set = zones.get_zone_set(zones.find_zone_set(0.5f, 40.5f));
+ *     printf("%d zones\n", set.count);
+ * }
+ * \endcode
+ */
+class ZoneMap {
+
+private:
+    /**
+     * \brief Описание зоны до растеризации
+     */
+    struct zone_polygon {
+        u_short_t zone_id;
+        std::vector<zone_point> vertices;
+    };
+
+    std::vector<zone_polygon> polygons;
+
+    float cell_size;
+    float inverse_cell_size;
+
+    /// Левый нижний угол растра
+    float origin_x = 0;
+    float origin_y = 0;
+
+    int width = 0;
+    int height = 0;
+
+    /// Номера сочетаний зон по ячейкам, строка за строкой
+    std::vector<u_short_t> cells;
+
+    /// Сочетания зон: начало сочетания в set_zones и его размер
+    std::vector<uint32_t> set_offsets;
+    std::vector<u_short_t> set_sizes;
+    std::vector<u_short_t> set_zones;
+
+    /**
+     * \brief Сочетание, получаемое добавлением зоны к существующему сочетанию
+     *
+     * Зоны растеризуются в порядке возрастания номеров, поэтому добавляемая зона всегда больше всех зон
+     * сочетания и сочетания остаются упорядоченными. Ячейка, уже содержащая зону (перекрывающиеся
+     * многоугольники одной зоны), не меняется.
+     *
+     * \param [in,out] transitions Уже построенные переходы (сочетание, зона) -> сочетание
+     * \param [in] set Исходное сочетание
+     * \param [in] zone_id Добавляемая зона
+     * \return Номер сочетания или -1, если превышено ZONE_MAX_SETS
+     */
+    int extend_set(std::map<std::pair<u_short_t, u_short_t>, u_short_t> &transitions, u_short_t set,
+                   u_short_t zone_id) {
+        if (set_sizes[set] > 0 && set_zones[set_offsets[set] + set_sizes[set] - 1] == zone_id) {
+            return set;
+        }
+
+        auto key = std::make_pair(set, zone_id);
+        auto found = transitions.find(key);
+
+        if (found != transitions.end()) {
+            return found->second;
+        }
+
+        if (set_sizes.size() >= ZONE_MAX_SETS) {
+            return -1;
+        }
+
+        auto extended = (u_short_t) set_sizes.size();
+
+        set_offsets.push_back((uint32_t) set_zones.size());
+        set_sizes.push_back((u_short_t) (set_sizes[set] + 1));
+
+        uint32_t offset = set_offsets[set];
+
+        for (u_short_t pos = 0; pos < set_sizes[set]; ++pos) {
+            set_zones.push_back(set_zones[offset + pos]);
+        }
+
+        set_zones.push_back(zone_id);
+
+        transitions.emplace(key, extended);
+
+        return extended;
+    }
+
+    /**
+     * \brief Растеризация многоугольника построчным заполнением по центрам ячеек
+     *
+     * \param [in] polygon Многоугольник зоны
+     * \param [in,out] transitions Переходы между сочетаниями
+     * \param [in,out] crossings Буфер для пересечений строки с рёбрами
+     * \return ZONES_OK или ZONES_ERROR, если превышено ZONE_MAX_SETS
+     */
+    int rasterize(const zone_polygon &polygon, std::map<std::pair<u_short_t, u_short_t>, u_short_t> &transitions,
+                  std::vector<float> &crossings) {
+        const std::vector<zone_point> &vertices = polygon.vertices;
+
+        float min_y = vertices[0].y;
+        float max_y = vertices[0].y;
+
+        for (const zone_point &vertex: vertices) {
+            min_y = std::min(min_y, vertex.y);
+            max_y = std::max(max_y, vertex.y);
+        }
+
+        int first_row = std::max(0, (int) std::floor((min_y - origin_y) * inverse_cell_size));
+        int last_row = std::min(height - 1, (int) std::floor((max_y - origin_y) * inverse_cell_size));
+
+        for (int row = first_row; row <= last_row; ++row) {
+            float center_y = origin_y + ((float) row + 0.5f) * cell_size;
+
+            crossings.clear();
+
+            for (size_t pos = 0; pos < vertices.size(); ++pos) {
+                const zone_point &a = vertices[pos];
+                const zone_point &b = vertices[(pos + 1) % vertices.size()];
+
+                /// Полуоткрытый интервал по y, чтобы вершина на строке не давала двух пересечений
+                if ((a.y <= center_y) != (b.y <= center_y)) {
+                    crossings.push_back(a.x + (center_y - a.y) * (b.x - a.x) / (b.y - a.y));
+                }
+            }
+
+            std::sort(crossings.begin(), crossings.end());
+
+            for (size_t pos = 0; pos + 1 < crossings.size(); pos += 2) {
+                int first_column = std::max(0, (int) std::ceil((crossings[pos] - origin_x) * inverse_cell_size - 0.5f));
+                int last_column = std::min(width - 1,
+                                           (int) std::floor((crossings[pos + 1] - origin_x) * inverse_cell_size - 0.5f));
+
+                u_short_t *row_cells = cells.data() + (size_t) row * width;
+
+                for (int column = first_column; column <= last_column; ++column) {
+                    int set = extend_set(transitions, row_cells[column], polygon.zone_id);
+
+                    if (set < 0) {
+                        return ZONES_ERROR;
+                    }
+
+                    row_cells[column] = (u_short_t) set;
+                }
+            }
+        }
+
+        return ZONES_OK;
+    }
+
+public:
+    /**
+     * \brief Конструктор карты.
+     *
+     * \param [in] cell Размер ячейки растра, м
+     */
+    explicit ZoneMap(float cell = ZONE_CELL_SIZE)
+            : cell_size(cell > 0 ? cell : ZONE_CELL_SIZE), inverse_cell_size(1.0f / cell_size) {
+        clear();
+    }
+
+    /**
+     * \brief Добавление зоны.
+     *
+     * Зона учитывается после следующего вызова build().
+     *
+     * \param [in] zone_id Номер зоны. Несколько многоугольников с одним номером образуют одну зону.
+     * \param [in] vertices Вершины многоугольника в координатах дороги, не менее трёх
+     * \return ZONES_OK или ZONES_ERROR, если вершин меньше трёх
+     */
+    int add_zone(u_short_t zone_id, const std::vector<zone_point> &vertices) {
+        if (vertices.size() < 3) {
+            return ZONES_ERROR;
+        }
+
+        polygons.push_back(zone_polygon{zone_id, vertices});
+
+        return ZONES_OK;
+    }
+
+    /**
+     * \brief Загрузка зон из текстового файла.
+     *
+     * Каждая строка файла описывает многоугольник: номер зоны, затем координаты вершин x y в метрах.
+     * Пустые строки и строки, начинающиеся с #, пропускаются.
+     *
+     * \code
+     * # полоса 1 и стоп-линия на 40 м
+     * 1   -1.75 0   1.75 0   1.75 120   -1.75 120
+     * 100 -1.75 40  1.75 40  1.75 41    -1.75 41
+     * \endcode
+     *
+     * \param [in] path Путь к файлу
+     * \return ZONES_OK, если все строки прочитаны. В противном случае - ZONES_ERROR.
+     */
+    int load(const char *path) {
+        FILE *file = fopen(path, "r");
+
+        if (file == nullptr) {
+            return ZONES_ERROR;
+        }
+
+        int result = ZONES_OK;
+        char line[ZONE_MAX_VERTICES * 32];
+
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            char *cursor = line + strspn(line, " \t\r\n");
+            int consumed = 0;
+            unsigned int zone_id;
+
+            if (*cursor == '\0' || *cursor == '#') {
+                continue;
+            }
+
+            if (sscanf(cursor, "%u%n", &zone_id, &consumed) != 1) {
+                result = ZONES_ERROR;
+                continue;
+            }
+
+            std::vector<zone_point> vertices;
+            zone_point vertex{};
+
+            cursor += consumed;
+
+            while (sscanf(cursor, " %f %f%n", &vertex.x, &vertex.y, &consumed) == 2) {
+                vertices.push_back(vertex);
+                cursor += consumed;
+            }
+
+            if (zone_id > 0xFFFF || add_zone((u_short_t) zone_id, vertices) != ZONES_OK) {
+                result = ZONES_ERROR;
+            }
+        }
+
+        fclose(file);
+
+        return result;
+    }
+
+    /**
+     * \brief Растеризация добавленных зон.
+     *
+     * Растр охватывает все многоугольники. Вызывается после добавления зон и до классификации.
+     *
+     * \return ZONES_OK. ZONES_ERROR, если растр превышает ZONE_MAX_CELLS ячеек или сочетаний зон больше ZONE_MAX_SETS.
+     */
+    int build() {
+        clear();
+
+        if (polygons.empty()) {
+            return ZONES_OK;
+        }
+
+        float min_x = polygons[0].vertices[0].x;
+        float max_x = min_x;
+        float min_y = polygons[0].vertices[0].y;
+        float max_y = min_y;
+
+        for (const zone_polygon &polygon: polygons) {
+            for (const zone_point &vertex: polygon.vertices) {
+                min_x = std::min(min_x, vertex.x);
+                max_x = std::max(max_x, vertex.x);
+                min_y = std::min(min_y, vertex.y);
+                max_y = std::max(max_y, vertex.y);
+            }
+        }
+
+        double columns = std::floor((max_x - min_x) * inverse_cell_size) + 1;
+        double rows = std::floor((max_y - min_y) * inverse_cell_size) + 1;
+
+        if (columns * rows > ZONE_MAX_CELLS) {
+            return ZONES_ERROR;
+        }
+
+        origin_x = min_x;
+        origin_y = min_y;
+        width = (int) columns;
+        height = (int) rows;
+
+        cells.assign((size_t) width * height, ZONE_SET_EMPTY);
+
+        std::vector<const zone_polygon *> ordered;
+
+        for (const zone_polygon &polygon: polygons) {
+            ordered.push_back(&polygon);
+        }
+
+        std::stable_sort(ordered.begin(), ordered.end(), [](const zone_polygon *a, const zone_polygon *b) {
+            return a->zone_id < b->zone_id;
+        });
+
+        std::map<std::pair<u_short_t, u_short_t>, u_short_t> transitions;
+        std::vector<float> crossings;
+
+        for (size_t pos = 0; pos < ordered.size(); ++pos) {
+            if (rasterize(*ordered[pos], transitions, crossings) != ZONES_OK) {
+                clear();
+                return ZONES_ERROR;
+            }
+        }
+
+        return ZONES_OK;
+    }
+
+    /**
+     * \brief Удаление растра. Добавленные зоны сохраняются.
+     */
+    void clear() {
+        width = 0;
+        height = 0;
+        cells.clear();
+
+        set_offsets.assign(1, 0);
+        set_sizes.assign(1, 0);
+        set_zones.clear();
+    }
+
+    /**
+     * \brief Номер сочетания зон, которым принадлежит точка.
+     *
+     * \param [in] x Поперечная координата, м
+     * \param [in] y Продольная координата, м
+     * \return Номер сочетания или ZONE_SET_EMPTY, если точка не принадлежит ни одной зоне
+     */
+    u_short_t find_zone_set(float x, float y) const {
+        float column = (x - origin_x) * inverse_cell_size;
+        float row = (y - origin_y) * inverse_cell_size;
+
+        /// Сравнение в float отсекает и NaN, и значения за пределами int
+        if (!(column >= 0 && row >= 0 && column < (float) width && row < (float) height)) {
+            return ZONE_SET_EMPTY;
+        }
+
+        return cells[(size_t) row * width + (size_t) column];
+    }
+
+    /**
+     * \brief Классификация массива точек.
+     *
+     * \param [in] x Поперечные координаты, м
+     * \param [in] y Продольные координаты, м
+     * \param [in] count Количество точек
+     * \param [out] sets Номера сочетаний зон для каждой точки
+     */
+    void classify(const float *x, const float *y, int count, u_short_t *sets) const {
+        for (int pos = 0; pos < count; ++pos) {
+            sets[pos] = find_zone_set(x[pos], y[pos]);
+        }
+    }
+
+    /**
+     * \brief Классификация пакета целей по координатам дороги.
+     *
+     * \param [in] batch Пакет целей, переведённый в координаты дороги RoadTransform
+     * \param [out] sets Номера сочетаний зон для каждой цели. Если координаты дороги не заполнены, то ZONE_SET_EMPTY.
+     */
+    void classify(const target_batch &batch, u_short_t *sets) const {
+        if (!batch.has_road_coordinates) {
+            std::fill(sets, sets + batch.count, (u_short_t) ZONE_SET_EMPTY);
+            return;
+        }
+
+        classify(batch.road_x, batch.road_y, batch.count, sets);
+    }
+
+    /**
+     * \brief Зоны, входящие в сочетание.
+     *
+     * \param [in] set Номер сочетания, полученный от find_zone_set() или classify()
+     */
+    zone_set get_zone_set(u_short_t set) const {
+        if (set >= set_sizes.size()) {
+            return zone_set{nullptr, 0};
+        }
+
+        return zone_set{set_zones.data() + set_offsets[set], set_sizes[set]};
+    }
+
+    /**
+     * \brief Проверка, входит ли зона в сочетание.
+     *
+     * \param [in] set Номер сочетания
+     * \param [in] zone_id Номер зоны
+     */
+    bool contains(u_short_t set, u_short_t zone_id) const {
+        zone_set zones = get_zone_set(set);
+
+        return std::binary_search(zones.zones, zones.zones + zones.count, zone_id);
+    }
+
+    /**
+     * \brief Количество различных сочетаний зон, включая пустое.
+     */
+    size_t get_set_count() const {
+        return set_sizes.size();
+    }
+
+    /**
+     * \brief Количество ячеек растра.
+     */
+    size_t get_cell_count() const {
+        return cells.size();
+    }
+};
+
+#endif //SMART_ROAD_DETECTION_ZONES_HPP
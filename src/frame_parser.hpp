@@ -0,0 +1,551 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий класс FrameParser для потокового разбора кадров протокола радара
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_FRAME_PARSER_HPP
+#define SMART_ROAD_FRAME_PARSER_HPP
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "smart_road_radar_utils.hpp"
+
+/// Кадр разобран, его описание записано в frame_view
+#define FRAME_PARSER_FRAME_READY    0
+/// Для завершения кадра требуются следующие порции байт
+#define FRAME_PARSER_NEED_MORE      1
+/// Кадр отброшен, его байты требуется разобрать повторно (используется внутри парсера)
+#define FRAME_PARSER_RESCAN         2
+
+/// Количество байт кадра между первым байтом заголовка и полезной нагрузкой (второй байт заголовка, длина, командное слово)
+#define FRAME_PARSER_PREFIX_LENGTH  (LENGTH_HEADER - 1 + LENGTH_DATA_LENGTH + LENGTH_COMMAND_WORD)
+
+/**
+ * \brief Описание разобранного кадра без копирования данных
+ *
+ * Указатель payload ссылается либо на переданную в FrameParser::parse() порцию байт, либо, если кадр
+ * пришёл несколькими порциями, на внутренний буфер парсера. Указатель действителен до следующего
+ * вызова FrameParser::parse() и до изменения памяти, в которой лежит порция.
+ */
+struct frame_view {
+    bool is_valid = false;              ///< Флаг совпадения контрольной суммы
+
+    u_short_t data_length{};            ///< Размер данных (командное слово и полезная нагрузка)
+    u_byte_t word{};                    ///< Командное слово
+
+    const u_byte_t *payload = nullptr;  ///< Полезная нагрузка размером data_length - 1 байт
+    u_byte_t checksum{};                ///< Принятая контрольная сумма
+};
+
+/// Структура статистики парсера
+struct frame_parser_statistics {
+    unsigned long long bytes_parsed = 0;        ///< Количество обработанных байт
+    unsigned long long frames_parsed = 0;       ///< Количество разобранных кадров
+    unsigned long long checksum_errors = 0;     ///< Количество кадров с неверной контрольной суммой
+    unsigned long long length_errors = 0;       ///< Количество кадров с недопустимым значением длины
+    unsigned long long frames_staged = 0;       ///< Количество кадров, данные которых пришли несколькими порциями
+    unsigned long long bytes_skipped = 0;       ///< Количество байт, пропущенных при поиске заголовка
+    unsigned long long frames_recovered = 0;    ///< Количество верных кадров, найденных после потери синхронизации
+};
+
+/**
+ * \brief Индекс младшего установленного бита ненулевой маски
+ */
+inline int count_trailing_zeros(unsigned int mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int) index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * \brief Поиск заголовка кадра
+ *
+ * Ищет пару байт HEADER_DATA_FRAME_1 HEADER_DATA_FRAME_2. При сборке с SSE2 за одну итерацию
+ * проверяется 16 позиций, остаток просматривается через memchr. Одиночный байт HEADER_DATA_FRAME_1
+ * в конце порции также считается найденным, так как пара может продолжиться в следующей порции.
+ *
+ * \param [in] data Порция байт
+ * \param [in] length Размер порции
+ * \return Индекс первого байта заголовка или length, если заголовок не найден
+ */
+size_t find_frame_header(const u_byte_t *data, size_t length) {
+    size_t pos = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i first = _mm_set1_epi8((char) HEADER_DATA_FRAME_1);
+    const __m128i second = _mm_set1_epi8((char) HEADER_DATA_FRAME_2);
+
+    for (; pos + 17 <= length; pos += 16) {
+        __m128i current = _mm_loadu_si128((const __m128i *) (data + pos));
+        __m128i next = _mm_loadu_si128((const __m128i *) (data + pos + 1));
+
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(current, first), _mm_cmpeq_epi8(next, second)));
+
+        if (mask != 0) {
+            return pos + count_trailing_zeros((unsigned int) mask);
+        }
+    }
+#endif
+
+    while (pos < length) {
+        const void *found = memchr(data + pos, HEADER_DATA_FRAME_1, length - pos);
+
+        if (found == nullptr) {
+            return length;
+        }
+
+        pos = (const u_byte_t *) found - data;
+
+        if (pos + 1 == length || data[pos + 1] == HEADER_DATA_FRAME_2) {
+            return pos;
+        }
+
+        ++pos;
+    }
+
+    return length;
+}
+
+/**
+ * \brief Потоковый парсер кадров протокола радара
+ *
+ * Парсер принимает порции байт произвольного размера и хранит состояние разбора (заголовок, длина,
+ * командное слово, данные, контрольная сумма) между вызовами. Если данные кадра целиком лежат в одной
+ * порции, то они не копируются. Внутренний буфер используется только для кадров, разрезанных между
+ * порциями, и выделяется один раз при создании парсера.
+ *
+ * Синхронизация восстанавливается без потерь: если у кадра недопустимая длина или неверная контрольная
+ * сумма, то отбрасывается только его первый байт, а остальные байты разбираются повторно, поэтому
+ * настоящий кадр, начавшийся внутри повреждённого, не теряется. Байты из уже обработанных порций
+ * повторно разбираются из внутреннего буфера.
+ *
+ * **Пример**
+ * \code
+ * FrameParser parser;
+ * frame_view view;
+ * size_t consumed;
+ *
+ * while (length > 0) {
+ *     if (parser.parse(chunk, length, &consumed, &view) == FRAME_PARSER_FRAME_READY && view.is_valid) {
+ *         printf("Frame 0x%02X, %d bytes\n", view.word, view.data_length);
+ *     }
+ *
+ *     chunk += consumed;
+ *     length -= consumed;
+ * }
+ * \endcode
+ */
+class FrameParser {
+
+private:
+    /// Состояния разбора кадра
+    enum parser_state {
+        STATE_HEADER_1,
+        STATE_HEADER_2,
+        STATE_LENGTH_1,
+        STATE_LENGTH_2,
+        STATE_WORD,
+        STATE_PAYLOAD,
+        STATE_CHECKSUM
+    };
+
+    parser_state state = STATE_HEADER_1;
+
+    /// Текущий кадр
+    frame_view current{};
+
+    /// Размер полезной нагрузки текущего кадра
+    size_t payload_length = 0;
+    /// Количество уже принятых байт полезной нагрузки
+    size_t payload_received = 0;
+
+    /// Контрольная сумма принятых байт текущего кадра
+    u_byte_t running_checksum = 0x00;
+
+    /// Буфер для кадров, пришедших несколькими порциями
+    std::vector<u_byte_t> staging;
+
+    /// Буфер байт отброшенного кадра, которые требуется разобрать повторно
+    std::vector<u_byte_t> replay;
+    /// Индекс следующего байта в replay
+    size_t replay_pos = 0;
+    /// Количество байт в replay
+    size_t replay_length = 0;
+
+    /// Количество байт текущего кадра (после первого байта заголовка), принятых в предыдущих порциях
+    size_t frame_bytes_before = 0;
+    /// Индекс начала байт текущего кадра в обрабатываемой порции
+    size_t segment_frame_start = 0;
+
+    /// Флаг потери синхронизации, сбрасывается на следующем верном кадре
+    bool resyncing = false;
+
+    /// Статистика парсера
+    frame_parser_statistics statistics{};
+
+    /**
+     * \brief Начало нового кадра после первого байта заголовка.
+     *
+     * \param [in] pos Индекс следующего байта порции
+     */
+    void start_frame(size_t pos) {
+        frame_bytes_before = 0;
+        segment_frame_start = pos;
+        state = STATE_HEADER_2;
+    }
+
+    /**
+     * \brief Байт текущего кадра с заданным индексом, принятый в предыдущих порциях.
+     *
+     * Байты восстанавливаются из полей кадра и буфера staging: в предыдущих порциях полезная
+     * нагрузка всегда копируется в staging.
+     *
+     * \param [in] index Индекс байта, отсчитываемый от второго байта заголовка
+     */
+    u_byte_t get_frame_byte(size_t index) const {
+        switch (index) {
+            case 0:
+                return HEADER_DATA_FRAME_2;
+            case 1:
+                return (u_byte_t) (current.data_length & 0xFF);
+            case 2:
+                return (u_byte_t) (current.data_length >> 8);
+            case 3:
+                return current.word;
+            default:
+                return staging[index - FRAME_PARSER_PREFIX_LENGTH];
+        }
+    }
+
+    /**
+     * \brief Отбрасывание первого байта текущего кадра и подготовка остальных байт к повторному разбору.
+     *
+     * Байты из предыдущих порций переносятся в replay, а позиция в текущей порции возвращается
+     * к началу байт кадра.
+     *
+     * \param [in,out] pos Позиция в текущей порции
+     */
+    void rescan_frame(size_t *pos) {
+        ++statistics.bytes_skipped;
+        resyncing = true;
+
+        if (frame_bytes_before > 0) {
+            for (size_t i = 0; i < frame_bytes_before; ++i) {
+                replay[i] = get_frame_byte(i);
+            }
+
+            replay_pos = 0;
+            replay_length = frame_bytes_before;
+        }
+
+        *pos = segment_frame_start;
+
+        frame_bytes_before = 0;
+        state = STATE_HEADER_1;
+    }
+
+    /**
+     * \brief Завершение кадра и проверка контрольной суммы.
+     *
+     * Контрольная сумма накапливается в running_checksum по мере приёма байт, поэтому повторного
+     * прохода по данным кадра не требуется.
+     *
+     * \param [out] view Описание разобранного кадра
+     */
+    void complete_frame(frame_view *view) {
+        current.is_valid = running_checksum == current.checksum;
+
+        if (!current.is_valid) {
+            ++statistics.checksum_errors;
+        } else if (resyncing) {
+            ++statistics.frames_recovered;
+            resyncing = false;
+        }
+
+        ++statistics.frames_parsed;
+
+        *view = current;
+        state = STATE_HEADER_1;
+    }
+
+    /**
+     * \brief Разбор одного непрерывного участка байт.
+     *
+     * \param [in] data Участок байт
+     * \param [in] length Размер участка
+     * \param [in,out] pos Позиция в участке
+     * \param [out] view Описание кадра, заполняется при возврате FRAME_PARSER_FRAME_READY
+     * \return FRAME_PARSER_FRAME_READY, если кадр завершён. FRAME_PARSER_RESCAN, если кадр с недопустимой
+     * длиной отброшен и его байты подготовлены к повторному разбору. В противном случае - FRAME_PARSER_NEED_MORE.
+     */
+    int parse_segment(const u_byte_t *data, size_t length, size_t *pos, frame_view *view) {
+        size_t i = *pos;
+
+        segment_frame_start = i;
+
+        while (i < length) {
+            switch (state) {
+                case STATE_HEADER_1: {
+                    size_t skipped = find_frame_header(data + i, length - i);
+
+                    if (skipped > 0) {
+                        statistics.bytes_skipped += skipped;
+                        resyncing = true;
+                    }
+
+                    i += skipped;
+
+                    if (i < length) {
+                        start_frame(++i);
+                    }
+                    break;
+                }
+
+                case STATE_HEADER_2:
+                    /// Байт, не продолжающий заголовок, не поглощается: он сам может быть началом кадра
+                    if (data[i] == HEADER_DATA_FRAME_2) {
+                        ++i;
+                        state = STATE_LENGTH_1;
+                    } else {
+                        ++statistics.bytes_skipped;
+                        resyncing = true;
+                        state = STATE_HEADER_1;
+                    }
+                    break;
+
+                case STATE_LENGTH_1:
+                    current = frame_view{};
+                    current.data_length = data[i];
+                    running_checksum = data[i++];
+                    state = STATE_LENGTH_2;
+                    break;
+
+                case STATE_LENGTH_2:
+                    current.data_length |= (u_short_t) (data[i] << 8);
+                    running_checksum += data[i++];
+
+                    if (current.data_length == 0 || current.data_length > FRAME_MAX_DATA_LENGTH) {
+                        ++statistics.length_errors;
+                        statistics.bytes_parsed += i - *pos;
+
+                        rescan_frame(&i);
+                        *pos = i;
+
+                        return FRAME_PARSER_RESCAN;
+                    }
+
+                    state = STATE_WORD;
+                    break;
+
+                case STATE_WORD:
+                    current.word = data[i];
+                    running_checksum += data[i++];
+
+                    payload_length = current.data_length - 1;
+                    payload_received = 0;
+                    current.payload = staging.data();
+
+                    state = payload_length > 0 ? STATE_PAYLOAD : STATE_CHECKSUM;
+                    break;
+
+                case STATE_PAYLOAD: {
+                    size_t available = length - i;
+
+                    /// Если данные кадра и контрольная сумма целиком лежат в порции, то данные не копируются
+                    if (payload_received == 0 && available > payload_length) {
+                        current.payload = data + i;
+                        running_checksum = update_checksum(running_checksum, data + i, payload_length);
+                        i += payload_length;
+                        state = STATE_CHECKSUM;
+                        break;
+                    }
+
+                    size_t span = payload_length - payload_received;
+
+                    if (span > available) {
+                        span = available;
+                    }
+
+                    if (payload_received == 0) {
+                        ++statistics.frames_staged;
+                    }
+
+                    memcpy(staging.data() + payload_received, data + i, span);
+                    running_checksum = update_checksum(running_checksum, data + i, span);
+
+                    i += span;
+                    payload_received += span;
+
+                    if (payload_received == payload_length) {
+                        state = STATE_CHECKSUM;
+                    }
+                    break;
+                }
+
+                case STATE_CHECKSUM:
+                    current.checksum = data[i++];
+                    complete_frame(view);
+
+                    statistics.bytes_parsed += i - *pos;
+
+                    /// Байты кадра с неверной контрольной суммой разбираются повторно после его выдачи
+                    if (!view->is_valid) {
+                        rescan_frame(&i);
+                    }
+
+                    *pos = i;
+
+                    return FRAME_PARSER_FRAME_READY;
+            }
+        }
+
+        if (state != STATE_HEADER_1 && length > segment_frame_start) {
+            frame_bytes_before += length - segment_frame_start;
+        }
+
+        statistics.bytes_parsed += i - *pos;
+        *pos = i;
+
+        return FRAME_PARSER_NEED_MORE;
+    }
+
+public:
+    /**
+     * \brief Стандартный конструктор
+     *
+     * Выделяет внутренние буферы размером FRAME_MAX_DATA_LENGTH.
+     *
+     * **Пример**
+     * \code
+     * FrameParser parser;
+     * \endcode
+     */
+    FrameParser() : staging(FRAME_MAX_DATA_LENGTH), replay(FRAME_PARSER_PREFIX_LENGTH + FRAME_MAX_DATA_LENGTH) {}
+
+    /**
+     * \brief Разбор очередной порции байт.
+     *
+     * Обрабатывает байты до тех пор, пока не будет завершён кадр или не закончится порция.
+     * Если после завершения кадра в порции остались байты, то их требуется передать в следующем вызове.
+     * Кадр с неверной контрольной суммой выдаётся с is_valid == false, при этом его байты, кроме первого,
+     * не считаются обработанными и разбираются повторно.
+     *
+     * \param [in] data Порция байт
+     * \param [in] length Размер порции
+     * \param [out] consumed Количество обработанных байт порции
+     * \param [out] view Описание кадра, заполняется при возврате FRAME_PARSER_FRAME_READY
+     * \return FRAME_PARSER_FRAME_READY, если кадр завершён. В противном случае - FRAME_PARSER_NEED_MORE.
+     */
+    int parse(const u_byte_t *data, size_t length, size_t *consumed, frame_view *view) {
+        size_t pos = 0;
+
+        while (true) {
+            /// Сначала разбираются байты отброшенного кадра из предыдущих порций
+            if (replay_pos < replay_length) {
+                int result = parse_segment(replay.data(), replay_length, &replay_pos, view);
+
+                if (result == FRAME_PARSER_FRAME_READY) {
+                    *consumed = pos;
+                    return result;
+                }
+
+                continue;
+            }
+
+            if (pos >= length) {
+                break;
+            }
+
+            int result = parse_segment(data, length, &pos, view);
+
+            if (result == FRAME_PARSER_FRAME_READY) {
+                *consumed = pos;
+                return result;
+            }
+
+            if (result == FRAME_PARSER_NEED_MORE) {
+                break;
+            }
+        }
+
+        *consumed = pos;
+
+        return FRAME_PARSER_NEED_MORE;
+    }
+
+    /**
+     * \brief Проверка, ожидает ли парсер начала нового кадра.
+     *
+     * \return false, если принята часть кадра (хотя бы первый байт заголовка).
+     */
+    bool is_idle() const {
+        return state == STATE_HEADER_1;
+    }
+
+    /**
+     * \brief Отбрасывание незавершённого кадра с повторным разбором его байт.
+     *
+     * Используется, если кадр не был завершён за отведённое время: первый байт заголовка отбрасывается,
+     * остальные принятые байты кадра будут разобраны при следующем вызове parse().
+     */
+    void resync() {
+        if (state == STATE_HEADER_1) {
+            return;
+        }
+
+        size_t pos = 0;
+
+        segment_frame_start = 0;
+        rescan_frame(&pos);
+    }
+
+    /**
+     * \brief Сброс состояния разбора.
+     *
+     * Незавершённый кадр и байты, ожидающие повторного разбора, отбрасываются, следующий байт ищется
+     * как начало заголовка.
+     */
+    void reset() {
+        state = STATE_HEADER_1;
+        payload_received = 0;
+
+        replay_pos = 0;
+        replay_length = 0;
+        frame_bytes_before = 0;
+    }
+
+    /**
+     * \brief Получение статистики парсера.
+     *
+     * \return Структура со статистикой с момента создания парсера или последнего вызова reset_statistics()
+     */
+    frame_parser_statistics get_statistics() const {
+        return statistics;
+    }
+
+    /**
+     * \brief Сброс статистики парсера.
+     */
+    void reset_statistics() {
+        statistics = frame_parser_statistics{};
+    }
+};
+
+
+#endif //SMART_ROAD_FRAME_PARSER_HPP
@@ -0,0 +1,336 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий пул буферов кадров FramePool и владеющий дескриптор FrameHandle
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_FRAME_POOL_HPP
+#define SMART_ROAD_FRAME_POOL_HPP
+
+#include <vector>
+
+#include "smart_road_radar_utils.hpp"
+
+/// Количество буферов в пуле по умолчанию
+#define FRAME_POOL_CAPACITY     4
+/// Размер одного буфера пула
+#define FRAME_POOL_BUFFER_SIZE  FRAME_MAX_DATA_LENGTH
+
+/// Структура статистики пула буферов
+struct frame_pool_statistics {
+    size_t capacity = 0;                    ///< Количество буферов в пуле
+    size_t in_use = 0;                      ///< Количество занятых буферов
+    size_t high_water = 0;                  ///< Максимальное количество одновременно занятых буферов
+    unsigned long long acquired = 0;        ///< Количество выданных буферов
+    unsigned long long exhausted = 0;       ///< Количество запросов, на которые не нашлось свободного буфера
+};
+
+class FramePool;
+
+/**
+ * \brief Владеющий дескриптор кадра, данные которого лежат в буфере пула
+ *
+ * Дескриптор можно только перемещать. При уничтожении дескриптора буфер возвращается в пул.
+ * Пустой дескриптор (is_empty() == true) не владеет буфером.
+ */
+class FrameHandle {
+
+    friend class FramePool;
+
+private:
+    FramePool *pool = nullptr;
+    int index = -1;
+
+    frame value{};
+
+    FrameHandle(FramePool *owner, int buffer_index, u_byte_t *buffer) : pool(owner), index(buffer_index) {
+        value.data = buffer;
+    }
+
+public:
+    /**
+     * \brief Стандартный конструктор, создающий пустой дескриптор
+     */
+    FrameHandle() = default;
+
+    FrameHandle(const FrameHandle &) = delete;
+    FrameHandle &operator=(const FrameHandle &) = delete;
+
+    FrameHandle(FrameHandle &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    FrameHandle &operator=(FrameHandle &&other) noexcept {
+        if (this != &other) {
+            release();
+
+            pool = other.pool;
+            index = other.index;
+            value = other.value;
+
+            other.pool = nullptr;
+            other.index = -1;
+            other.value = frame{};
+        }
+
+        return *this;
+    }
+
+    ~FrameHandle() {
+        release();
+    }
+
+    /**
+     * \brief Проверка, владеет ли дескриптор буфером.
+     */
+    bool is_empty() const {
+        return pool == nullptr;
+    }
+
+    frame *get() {
+        return &value;
+    }
+
+    const frame *get() const {
+        return &value;
+    }
+
+    frame &operator*() {
+        return value;
+    }
+
+    frame *operator->() {
+        return &value;
+    }
+
+    /**
+     * \brief Досрочный возврат буфера в пул.
+     */
+    void release();
+};
+
+/**
+ * \brief Пул буферов кадров фиксированного размера
+ *
+ * Все буферы выделяются одним блоком при создании пула, после чего выдача и возврат буферов не
+ * приводят к выделению памяти. Буферы выдаются в виде FrameHandle и возвращаются в пул автоматически.
+ *
+ * \warning Пул не защищён от одновременного использования из нескольких потоков.
+ *
+ * **Пример**
+ * \code
+ * FramePool pool;
+ *
+ * FrameHandle handle = configure_frame(&pool, CMD_SET_TARGET_NUM, 35);
+ * write_frame(*handle);
+ * \endcode
+ */
+class FramePool {
+
+    friend class FrameHandle;
+
+private:
+    std::vector<u_byte_t> storage;
+    std::vector<int> free_list;
+
+    size_t buffer_size;
+
+    frame_pool_statistics statistics{};
+
+    void release_buffer(int index) {
+        free_list.push_back(index);
+        --statistics.in_use;
+    }
+
+public:
+    /**
+     * \brief Конструктор пула.
+     *
+     * \param [in] capacity Количество буферов
+     * \param [in] size Размер одного буфера
+     *
+     * **Пример**
+     * \code
+     * FramePool pool(16);
+     * \endcode
+     */
+    explicit FramePool(size_t capacity = FRAME_POOL_CAPACITY, size_t size = FRAME_POOL_BUFFER_SIZE)
+            : storage(capacity * size), buffer_size(size) {
+        free_list.reserve(capacity);
+
+        for (size_t i = capacity; i > 0; --i) {
+            free_list.push_back((int) (i - 1));
+        }
+
+        statistics.capacity = capacity;
+    }
+
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    /**
+     * \brief Получение свободного буфера.
+     *
+     * \return Дескриптор кадра с пустыми полями, поле data указывает на буфер размером get_buffer_size().
+     * Если свободных буферов нет, то возвращается пустой дескриптор.
+     */
+    FrameHandle acquire() {
+        if (free_list.empty()) {
+            ++statistics.exhausted;
+            return FrameHandle{};
+        }
+
+        int index = free_list.back();
+        free_list.pop_back();
+
+        ++statistics.acquired;
+        ++statistics.in_use;
+
+        if (statistics.in_use > statistics.high_water) {
+            statistics.high_water = statistics.in_use;
+        }
+
+        return FrameHandle(this, index, storage.data() + (size_t) index * buffer_size);
+    }
+
+    /**
+     * \brief Копирование кадра в буфер пула.
+     *
+     * Позволяет сохранить кадр, данные которого ссылаются на приёмный буфер, дольше следующего чтения.
+     *
+     * \param [in] source Копируемый кадр
+     * \return Дескриптор копии. Если свободных буферов нет или данные не помещаются в буфер,
+     * то возвращается пустой дескриптор.
+     */
+    FrameHandle acquire_copy(const frame &source) {
+        int length = get_frame_data_size(source);
+
+        if ((size_t) length > buffer_size) {
+            ++statistics.exhausted;
+            return FrameHandle{};
+        }
+
+        FrameHandle handle = acquire();
+
+        if (handle.is_empty()) {
+            return handle;
+        }
+
+        u_byte_t *buffer = handle->data;
+
+        *handle = source;
+        handle->data = buffer;
+
+        if (length > 0) {
+            memcpy(buffer, source.data, length);
+        }
+
+        return handle;
+    }
+
+    /**
+     * \brief Размер одного буфера пула.
+     */
+    size_t get_buffer_size() const {
+        return buffer_size;
+    }
+
+    /**
+     * \brief Получение статистики заполненности пула.
+     */
+    frame_pool_statistics get_statistics() const {
+        return statistics;
+    }
+};
+
+inline void FrameHandle::release() {
+    if (pool != nullptr) {
+        pool->release_buffer(index);
+
+        pool = nullptr;
+        index = -1;
+        value = frame{};
+    }
+}
+
+/**
+ * Метод формирующий кадр, который состоит только из одного командного слова
+ *
+ * \param [in,out] pool Пул, из которого берётся буфер кадра
+ * \param [in] word Командное слово
+ * \return Готовый кадр с рассчитанной контрольной суммой. Пустой дескриптор, если в пуле нет свободных буферов.
+ */
+FrameHandle configure_frame(FramePool *pool, u_byte_t word) {
+    FrameHandle configured_frame = pool->acquire();
+
+    if (configured_frame.is_empty()) {
+        return configured_frame;
+    }
+
+    configured_frame->data_length.i = 1;
+    configured_frame->word = word;
+
+    configured_frame->checksum = calculate_checksum(*configured_frame);
+
+    return configured_frame;
+}
+
+/**
+ * Метод формирующий кадр, который состоит из командного слова и одного байта данных
+ *
+ * \param [in,out] pool Пул, из которого берётся буфер кадра
+ * \param [in] word Командное слово
+ * \param [in] data Один байт данных
+ * \return Готовый кадр с рассчитанной контрольной суммой. Пустой дескриптор, если в пуле нет свободных буферов.
+ */
+FrameHandle configure_frame(FramePool *pool, u_byte_t word, u_byte_t data) {
+    FrameHandle configured_frame = pool->acquire();
+
+    if (configured_frame.is_empty()) {
+        return configured_frame;
+    }
+
+    configured_frame->data_length.i = 2;
+    configured_frame->word = word;
+
+    configured_frame->data[0] = data;
+
+    configured_frame->checksum = calculate_checksum(*configured_frame);
+
+    return configured_frame;
+}
+
+/**
+ * Метод формирующий кадр, который состоит из командного слова и массива данных
+ *
+ * \param [in,out] pool Пул, из которого берётся буфер кадра
+ * \param [in] word Командное слово
+ * \param [in] data Указатель на массив данных
+ * \param [in] length Размер массива данных
+ * \return Готовый кадр с рассчитанной контрольной суммой. Пустой дескриптор, если в пуле нет свободных буферов
+ * или данные не помещаются в буфер.
+ */
+FrameHandle configure_frame(FramePool *pool, u_byte_t word, u_byte_t *data, u_short_t length) {
+    if (length > pool->get_buffer_size()) {
+        return FrameHandle{};
+    }
+
+    FrameHandle configured_frame = pool->acquire();
+
+    if (configured_frame.is_empty()) {
+        return configured_frame;
+    }
+
+    configured_frame->data_length.i = length + 1;
+    configured_frame->word = word;
+
+    memcpy(configured_frame->data, data, length);
+
+    configured_frame->checksum = calculate_checksum(*configured_frame);
+
+    return configured_frame;
+}
+
+#endif //SMART_ROAD_FRAME_POOL_HPP
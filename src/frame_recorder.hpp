@@ -0,0 +1,746 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий двоичный формат записи кадров, класс записи FrameRecorder и класс чтения FrameRecording
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_FRAME_RECORDER_HPP
+#define SMART_ROAD_FRAME_RECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "smart_road_radar_utils.hpp"
+#include "spsc_queue.hpp"
+
+/// Возвращаемое значение при успешной работе с записью
+#define RECORDER_OK     0
+/// Возвращаемое значение при ошибке работы с записью
+#define RECORDER_ERROR  1
+
+/// Размер блока записи (без заголовка блока)
+#define RECORDER_BLOCK_SIZE         65536
+/// Количество блоков в очереди на запись в файл
+#define RECORDER_QUEUE_CAPACITY     8
+/// Максимальное время, которое принятый кадр ожидает в незаполненном блоке, мс
+#define RECORDER_FLUSH_INTERVAL     1000
+/// Интервал проверки очереди потоком записи, мс
+#define RECORDER_POLL_INTERVAL      10
+
+/// Выравнивание записей кадров внутри блока
+#define RECORDER_ALIGNMENT          8
+
+/// Сигнатура файла записи
+#define RECORDER_FILE_MAGIC         "SRRADREC"
+/// Версия формата записи
+#define RECORDER_VERSION            1
+/// Сигнатура заголовка блока ("BLK1")
+#define RECORDER_BLOCK_MAGIC        0x314B4C42u
+/// Сигнатура индекса ("IDX1")
+#define RECORDER_INDEX_MAGIC        0x31584449u
+/// Сигнатура завершающей записи ("END1")
+#define RECORDER_TRAILER_MAGIC      0x31444E45u
+
+/**
+ * \brief Заголовок файла записи
+ *
+ * Файл записи состоит из заголовка файла, последовательности блоков с кадрами, индекса смещений кадров
+ * и завершающей записи. Все числа записываются в порядке байт от младшего к старшему.
+ */
+struct recording_file_header {
+    char magic[8];                  ///< RECORDER_FILE_MAGIC без завершающего нуля
+    uint32_t version;               ///< RECORDER_VERSION
+    uint32_t block_size;            ///< Максимальный размер блока без заголовка
+    uint64_t created_at;            ///< Время создания файла, нс с начала эпохи UNIX
+    uint64_t reserved;
+};
+
+/// Заголовок блока записи, за ним следуют payload_bytes байт записей кадров
+struct recording_block_header {
+    uint32_t magic;                 ///< RECORDER_BLOCK_MAGIC
+    uint32_t frame_count;           ///< Количество кадров в блоке
+    uint32_t payload_bytes;         ///< Размер записей кадров блока
+    uint32_t reserved;
+    uint64_t first_timestamp;       ///< Время приёма первого кадра блока, нс с начала эпохи UNIX
+    uint64_t last_timestamp;        ///< Время приёма последнего кадра блока, нс с начала эпохи UNIX
+};
+
+/**
+ * \brief Заголовок записи одного кадра
+ *
+ * За заголовком следуют data_length - 1 байт полезной нагрузки кадра, запись дополняется
+ * до границы RECORDER_ALIGNMENT байт.
+ */
+struct recording_frame_header {
+    uint64_t timestamp;             ///< Время приёма кадра, нс с начала эпохи UNIX
+    uint16_t port_id;               ///< Идентификатор порта радара
+    uint16_t data_length;           ///< Значение поля длины кадра
+    uint8_t word;                   ///< Командное слово
+    uint8_t checksum;               ///< Контрольная сумма кадра
+    uint16_t reserved;
+};
+
+/// Заголовок индекса, за ним следуют frame_count смещений кадров от начала файла (uint64_t)
+struct recording_index_header {
+    uint32_t magic;                 ///< RECORDER_INDEX_MAGIC
+    uint32_t reserved;
+    uint64_t frame_count;           ///< Количество кадров в записи
+};
+
+/// Завершающая запись файла
+struct recording_trailer {
+    uint32_t magic;                 ///< RECORDER_TRAILER_MAGIC
+    uint32_t reserved;
+    uint64_t index_offset;          ///< Смещение заголовка индекса от начала файла
+    uint64_t frame_count;           ///< Количество кадров в записи
+};
+
+/// Структура статистики записи
+struct recorder_statistics {
+    unsigned long long frames_recorded = 0;     ///< Количество кадров, записанных в блоки
+    unsigned long long frames_dropped = 0;      ///< Количество кадров, отброшенных из-за заполненной очереди блоков
+    unsigned long long blocks_written = 0;      ///< Количество блоков, записанных в файл
+    unsigned long long bytes_written = 0;       ///< Количество байт, записанных в файл
+    unsigned long long write_errors = 0;        ///< Количество ошибок записи в файл
+};
+
+/// Кадр, прочитанный из записи
+struct recorded_frame {
+    uint64_t timestamp = 0;             ///< Время приёма кадра, нс с начала эпохи UNIX
+    u_short_t port_id = 0;              ///< Идентификатор порта радара
+
+    u_short_t data_length = 0;          ///< Значение поля длины кадра
+    u_byte_t word = 0;                  ///< Командное слово
+    const u_byte_t *payload = nullptr;  ///< Полезная нагрузка размером data_length - 1 байт
+    u_byte_t checksum = 0;              ///< Контрольная сумма кадра
+};
+
+/**
+ * \brief Время в наносекундах с начала эпохи UNIX
+ */
+inline uint64_t get_recording_timestamp(std::chrono::system_clock::time_point time) {
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * \brief Размер записи кадра в блоке с учётом выравнивания
+ *
+ * \param [in] data_length Значение поля длины кадра
+ */
+inline size_t get_recorded_frame_size(size_t data_length) {
+    size_t size = sizeof(recording_frame_header) + (data_length > 0 ? data_length - 1 : 0);
+
+    return (size + RECORDER_ALIGNMENT - 1) & ~(size_t) (RECORDER_ALIGNMENT - 1);
+}
+
+/**
+ * \brief Объект для записи принятых кадров в двоичный файл
+ *
+ * Кадры копируются в заранее выделенные блоки, заполненные блоки передаются через lock-free очередь
+ * в отдельный поток, который записывает их в файл. Поток, принимающий кадры, не выполняет системных
+ * вызовов и не ждёт записи: если очередь блоков заполнена, то кадр отбрасывается с увеличением
+ * счётчика frames_dropped.
+ *
+ * Смещения кадров собираются потоком записи и при закрытии записываются в конец файла в виде индекса,
+ * который позволяет FrameRecording обращаться к кадру по номеру за O(1). Если файл не был закрыт,
+ * то индекс восстанавливается при открытии по заголовкам блоков.
+ *
+ * \warning Метод record() вызывается только из одного потока одновременно.
+ *
+ * **Пример**
+ * \code
+ * FrameRecorder recorder;
+ *
+ * if (recorder.open("radar.rec") == RECORDER_OK) {
+ *     recorder.record(1, view.word, view.payload, view.data_length, view.checksum, std::chrono::system_clock::now());
+ *     recorder.close();
+ * }
+ * \endcode
+ */
+class FrameRecorder {
+
+private:
+    /// Блок записей кадров, заполняемый на месте в ячейке очереди
+    struct recorder_block {
+        size_t length = 0;
+        uint32_t frame_count = 0;
+        uint64_t first_timestamp = 0;
+        uint64_t last_timestamp = 0;
+        std::chrono::steady_clock::time_point opened_at{};
+        alignas(RECORDER_ALIGNMENT) u_byte_t data[RECORDER_BLOCK_SIZE];
+    };
+
+    FILE *file = nullptr;
+
+    std::unique_ptr<SpscQueue<recorder_block>> blocks;
+    /// Заполняемый блок или nullptr, если свободного блока нет
+    recorder_block *current_block = nullptr;
+
+    std::thread writer;
+    std::atomic<bool> writer_running{false};
+
+    /// Смещение следующего блока от начала файла, изменяется только потоком записи
+    uint64_t file_offset = 0;
+    /// Смещения кадров, изменяются только потоком записи
+    std::vector<uint64_t> frame_offsets;
+
+    std::atomic<unsigned long long> frames_recorded{0};
+    std::atomic<unsigned long long> frames_dropped{0};
+    std::atomic<unsigned long long> blocks_written{0};
+    std::atomic<unsigned long long> bytes_written{0};
+    std::atomic<unsigned long long> write_errors{0};
+
+    bool write_bytes(const void *data, size_t length) {
+        if (fwrite(data, 1, length, file) != length) {
+            ++write_errors;
+            return false;
+        }
+
+        file_offset += length;
+        bytes_written += length;
+
+        return true;
+    }
+
+    void write_block(const recorder_block &block) {
+        recording_block_header header{};
+
+        header.magic = RECORDER_BLOCK_MAGIC;
+        header.frame_count = block.frame_count;
+        header.payload_bytes = (uint32_t) block.length;
+        header.first_timestamp = block.first_timestamp;
+        header.last_timestamp = block.last_timestamp;
+
+        uint64_t payload_offset = file_offset + sizeof(header);
+
+        if (!write_bytes(&header, sizeof(header)) || !write_bytes(block.data, block.length)) {
+            return;
+        }
+
+        for (size_t pos = 0; pos < block.length;) {
+            recording_frame_header frame_header;
+            memcpy(&frame_header, block.data + pos, sizeof(frame_header));
+
+            frame_offsets.push_back(payload_offset + pos);
+            pos += get_recorded_frame_size(frame_header.data_length);
+        }
+
+        ++blocks_written;
+    }
+
+    /**
+     * \brief Запись в файл всех блоков из очереди. Выполняется потоком записи.
+     */
+    void drain_blocks() {
+        recorder_block *block;
+
+        while ((block = blocks->acquire_read_slot()) != nullptr) {
+            write_block(*block);
+            blocks->release();
+        }
+    }
+
+    void writer_loop() {
+        while (writer_running.load()) {
+            drain_blocks();
+            std::this_thread::sleep_for(std::chrono::milliseconds(RECORDER_POLL_INTERVAL));
+        }
+
+        drain_blocks();
+    }
+
+    /**
+     * \brief Передача заполняемого блока потоку записи и получение следующего.
+     */
+    void commit_block() {
+        if (current_block != nullptr) {
+            if (current_block->frame_count == 0) {
+                return;
+            }
+
+            blocks->commit();
+        }
+
+        current_block = blocks->acquire_write_slot();
+
+        if (current_block != nullptr) {
+            current_block->length = 0;
+            current_block->frame_count = 0;
+        }
+    }
+
+public:
+    FrameRecorder() = default;
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    ~FrameRecorder() {
+        close();
+    }
+
+    /**
+     * \brief Создание файла записи и запуск потока записи.
+     *
+     * \param [in] path Путь к файлу. Существующий файл перезаписывается.
+     * \param [in] queue_capacity Количество блоков размером RECORDER_BLOCK_SIZE в очереди на запись
+     * \return RECORDER_OK, если файл создан. В противном случае - RECORDER_ERROR.
+     */
+    int open(const char *path, size_t queue_capacity = RECORDER_QUEUE_CAPACITY) {
+        close();
+
+        file = fopen(path, "wb");
+
+        if (file == nullptr) {
+            return RECORDER_ERROR;
+        }
+
+        recording_file_header header{};
+
+        memcpy(header.magic, RECORDER_FILE_MAGIC, sizeof(header.magic));
+        header.version = RECORDER_VERSION;
+        header.block_size = RECORDER_BLOCK_SIZE;
+        header.created_at = get_recording_timestamp(std::chrono::system_clock::now());
+
+        file_offset = 0;
+        frame_offsets.clear();
+
+        if (!write_bytes(&header, sizeof(header))) {
+            fclose(file);
+            file = nullptr;
+
+            return RECORDER_ERROR;
+        }
+
+        if (!blocks || blocks->capacity() < queue_capacity) {
+            blocks = std::make_unique<SpscQueue<recorder_block>>(queue_capacity);
+        } else {
+            blocks->clear();
+        }
+
+        current_block = nullptr;
+        commit_block();
+
+        writer_running.store(true);
+        writer = std::thread(&FrameRecorder::writer_loop, this);
+
+        return RECORDER_OK;
+    }
+
+    /**
+     * \brief Проверка, открыт ли файл записи.
+     */
+    bool is_open() const {
+        return file != nullptr;
+    }
+
+    /**
+     * \brief Добавление кадра в запись.
+     *
+     * Кадр копируется в текущий блок. Блок передаётся потоку записи, когда в нём не остаётся места для
+     * кадра или когда при добавлении кадра оказывается, что первый кадр в блоке старше RECORDER_FLUSH_INTERVAL.
+     *
+     * \param [in] port_id Идентификатор порта радара
+     * \param [in] word Командное слово
+     * \param [in] payload Полезная нагрузка размером data_length - 1 байт
+     * \param [in] data_length Значение поля длины кадра
+     * \param [in] checksum Контрольная сумма кадра
+     * \param [in] received_at Время приёма кадра
+     * \return RECORDER_OK, если кадр записан в блок. Если файл не открыт или свободных блоков нет - RECORDER_ERROR.
+     */
+    int record(u_short_t port_id, u_byte_t word, const u_byte_t *payload, u_short_t data_length, u_byte_t checksum,
+               std::chrono::system_clock::time_point received_at) {
+        if (file == nullptr || data_length == 0 || data_length > FRAME_MAX_DATA_LENGTH) {
+            return RECORDER_ERROR;
+        }
+
+        size_t size = get_recorded_frame_size(data_length);
+        auto now = std::chrono::steady_clock::now();
+
+        if (current_block == nullptr ||
+            (current_block->frame_count > 0 &&
+             (current_block->length + size > RECORDER_BLOCK_SIZE ||
+              now - current_block->opened_at >= std::chrono::milliseconds(RECORDER_FLUSH_INTERVAL)))) {
+            commit_block();
+        }
+
+        if (current_block == nullptr) {
+            ++frames_dropped;
+            return RECORDER_ERROR;
+        }
+
+        recording_frame_header header{};
+
+        header.timestamp = get_recording_timestamp(received_at);
+        header.port_id = port_id;
+        header.data_length = data_length;
+        header.word = word;
+        header.checksum = checksum;
+
+        u_byte_t *record = current_block->data + current_block->length;
+
+        memcpy(record, &header, sizeof(header));
+
+        if (data_length > 1) {
+            memcpy(record + sizeof(header), payload, data_length - 1);
+        }
+
+        if (current_block->frame_count == 0) {
+            current_block->first_timestamp = header.timestamp;
+            current_block->opened_at = now;
+        }
+
+        current_block->last_timestamp = header.timestamp;
+        current_block->length += size;
+        ++current_block->frame_count;
+
+        frames_recorded.fetch_add(1, std::memory_order_relaxed);
+
+        return RECORDER_OK;
+    }
+
+    /**
+     * \brief Завершение записи.
+     *
+     * Передаёт потоку записи незаполненный блок, дожидается записи всех блоков и дописывает
+     * индекс смещений кадров и завершающую запись.
+     */
+    void close() {
+        if (file == nullptr) {
+            return;
+        }
+
+        if (current_block != nullptr && current_block->frame_count > 0) {
+            blocks->commit();
+        }
+
+        current_block = nullptr;
+
+        writer_running.store(false);
+
+        if (writer.joinable()) {
+            writer.join();
+        }
+
+        recording_index_header index{};
+
+        index.magic = RECORDER_INDEX_MAGIC;
+        index.frame_count = frame_offsets.size();
+
+        recording_trailer trailer{};
+
+        trailer.magic = RECORDER_TRAILER_MAGIC;
+        trailer.index_offset = file_offset;
+        trailer.frame_count = frame_offsets.size();
+
+        write_bytes(&index, sizeof(index));
+        write_bytes(frame_offsets.data(), frame_offsets.size() * sizeof(uint64_t));
+        write_bytes(&trailer, sizeof(trailer));
+
+        fclose(file);
+        file = nullptr;
+    }
+
+    /**
+     * \brief Получение статистики записи.
+     */
+    recorder_statistics get_statistics() const {
+        recorder_statistics statistics{};
+
+        statistics.frames_recorded = frames_recorded.load();
+        statistics.frames_dropped = frames_dropped.load();
+        statistics.blocks_written = blocks_written.load();
+        statistics.bytes_written = bytes_written.load();
+        statistics.write_errors = write_errors.load();
+
+        return statistics;
+    }
+};
+
+/**
+ * \brief Объект для чтения файла записи кадров
+ *
+ * Файл отображается в память целиком, данные кадров не копируются: поле payload прочитанного кадра
+ * указывает на отображение и действительно до закрытия записи.
+ *
+ * **Пример**
+ * \code
+ * FrameRecording recording;
+ *
+ * if (recording.open("radar.rec") == RECORDER_OK) {
+ *     recorded_frame received_frame;
+ *
+ *     for (size_t i = 0; i < recording.get_frame_count(); ++i) {
+ *         recording.get_frame(i, &received_frame);
+ *         printf("0x%02X, %d bytes\n", received_frame.word, received_frame.data_length);
+ *     }
+ * }
+ * \endcode
+ */
+class FrameRecording {
+
+private:
+    const u_byte_t *mapping = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping_handle = nullptr;
+#endif
+
+    /// Смещения кадров из индекса файла
+    const u_byte_t *index = nullptr;
+    /// Смещения кадров, восстановленные по заголовкам блоков, если индекс не записан
+    std::vector<uint64_t> rebuilt_index;
+
+    size_t frame_count = 0;
+
+    int map_file(const char *path) {
+#ifdef _WIN32
+        file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            return RECORDER_ERROR;
+        }
+
+        LARGE_INTEGER file_size;
+
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+            return RECORDER_ERROR;
+        }
+
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping_handle == nullptr) {
+            return RECORDER_ERROR;
+        }
+
+        mapping = (const u_byte_t *) MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        size = (size_t) file_size.QuadPart;
+#else
+        int descriptor = ::open(path, O_RDONLY);
+
+        if (descriptor < 0) {
+            return RECORDER_ERROR;
+        }
+
+        struct stat file_stat{};
+
+        if (fstat(descriptor, &file_stat) != 0 || file_stat.st_size == 0) {
+            ::close(descriptor);
+            return RECORDER_ERROR;
+        }
+
+        void *address = mmap(nullptr, (size_t) file_stat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+
+        if (address == MAP_FAILED) {
+            return RECORDER_ERROR;
+        }
+
+        mapping = (const u_byte_t *) address;
+        size = (size_t) file_stat.st_size;
+#endif
+
+        return mapping != nullptr ? RECORDER_OK : RECORDER_ERROR;
+    }
+
+    /**
+     * \brief Чтение индекса, записанного при закрытии файла.
+     */
+    bool load_index() {
+        recording_trailer trailer;
+
+        if (size < sizeof(recording_file_header) + sizeof(recording_index_header) + sizeof(trailer)) {
+            return false;
+        }
+
+        memcpy(&trailer, mapping + size - sizeof(trailer), sizeof(trailer));
+
+        if (trailer.magic != RECORDER_TRAILER_MAGIC ||
+            trailer.index_offset + sizeof(recording_index_header) + trailer.frame_count * sizeof(uint64_t) +
+            sizeof(trailer) != size) {
+            return false;
+        }
+
+        recording_index_header header;
+        memcpy(&header, mapping + trailer.index_offset, sizeof(header));
+
+        if (header.magic != RECORDER_INDEX_MAGIC || header.frame_count != trailer.frame_count) {
+            return false;
+        }
+
+        index = mapping + trailer.index_offset + sizeof(header);
+        frame_count = (size_t) trailer.frame_count;
+
+        return true;
+    }
+
+    /**
+     * \brief Восстановление индекса по заголовкам блоков, если запись не была завершена.
+     *
+     * Незаписанный до конца последний блок отбрасывается.
+     */
+    void rebuild_index() {
+        size_t pos = sizeof(recording_file_header);
+
+        rebuilt_index.clear();
+
+        while (pos + sizeof(recording_block_header) <= size) {
+            recording_block_header header;
+            memcpy(&header, mapping + pos, sizeof(header));
+
+            if (header.magic != RECORDER_BLOCK_MAGIC || header.payload_bytes > size - pos - sizeof(header)) {
+                break;
+            }
+
+            size_t record = pos + sizeof(header);
+            size_t block_end = record + header.payload_bytes;
+
+            for (uint32_t i = 0; i < header.frame_count && record < block_end; ++i) {
+                recording_frame_header frame_header;
+                memcpy(&frame_header, mapping + record, sizeof(frame_header));
+
+                rebuilt_index.push_back(record);
+                record += get_recorded_frame_size(frame_header.data_length);
+            }
+
+            pos = block_end;
+        }
+
+        index = (const u_byte_t *) rebuilt_index.data();
+        frame_count = rebuilt_index.size();
+    }
+
+public:
+    FrameRecording() = default;
+
+    FrameRecording(const FrameRecording &) = delete;
+    FrameRecording &operator=(const FrameRecording &) = delete;
+
+    ~FrameRecording() {
+        close();
+    }
+
+    /**
+     * \brief Открытие файла записи.
+     *
+     * \param [in] path Путь к файлу
+     * \return RECORDER_OK, если файл открыт и имеет формат записи. В противном случае - RECORDER_ERROR.
+     */
+    int open(const char *path) {
+        close();
+
+        if (map_file(path) != RECORDER_OK || size < sizeof(recording_file_header)) {
+            close();
+            return RECORDER_ERROR;
+        }
+
+        recording_file_header header;
+        memcpy(&header, mapping, sizeof(header));
+
+        if (memcmp(header.magic, RECORDER_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != RECORDER_VERSION) {
+            close();
+            return RECORDER_ERROR;
+        }
+
+        if (!load_index()) {
+            rebuild_index();
+        }
+
+        return RECORDER_OK;
+    }
+
+    /**
+     * \brief Закрытие файла записи.
+     */
+    void close() {
+#ifdef _WIN32
+        if (mapping != nullptr) {
+            UnmapViewOfFile(mapping);
+        }
+
+        if (mapping_handle != nullptr) {
+            CloseHandle(mapping_handle);
+            mapping_handle = nullptr;
+        }
+
+        if (file_handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_handle);
+            file_handle = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (mapping != nullptr) {
+            munmap((void *) mapping, size);
+        }
+#endif
+
+        mapping = nullptr;
+        size = 0;
+
+        index = nullptr;
+        rebuilt_index.clear();
+        frame_count = 0;
+    }
+
+    /**
+     * \brief Количество кадров в записи.
+     */
+    size_t get_frame_count() const {
+        return frame_count;
+    }
+
+    /**
+     * \brief Чтение кадра по номеру.
+     *
+     * \param [in] number Номер кадра от 0 до get_frame_count() - 1
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр
+     * \return RECORDER_OK, если кадр прочитан. В противном случае - RECORDER_ERROR.
+     */
+    int get_frame(size_t number, recorded_frame *received_frame) const {
+        if (number >= frame_count) {
+            return RECORDER_ERROR;
+        }
+
+        uint64_t offset;
+        memcpy(&offset, index + number * sizeof(uint64_t), sizeof(offset));
+
+        recording_frame_header header;
+
+        if (offset + sizeof(header) > size) {
+            return RECORDER_ERROR;
+        }
+
+        memcpy(&header, mapping + offset, sizeof(header));
+
+        if (header.data_length == 0 || offset + sizeof(header) + header.data_length - 1 > size) {
+            return RECORDER_ERROR;
+        }
+
+        received_frame->timestamp = header.timestamp;
+        received_frame->port_id = header.port_id;
+        received_frame->data_length = header.data_length;
+        received_frame->word = header.word;
+        received_frame->payload = mapping + offset + sizeof(header);
+        received_frame->checksum = header.checksum;
+
+        return RECORDER_OK;
+    }
+};
+
+#endif //SMART_ROAD_FRAME_RECORDER_HPP
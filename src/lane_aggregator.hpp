@@ -0,0 +1,400 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий LaneAggregator для расчёта интенсивности, занятости и интервалов по полосам
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_LANE_AGGREGATOR_HPP
+#define SMART_ROAD_LANE_AGGREGATOR_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "detection_zones.hpp"
+
+/// Скользящее окно длиной 1 с
+#define AGGREGATOR_WINDOW_1S        0
+/// Скользящее окно длиной 1 мин
+#define AGGREGATOR_WINDOW_1MIN      1
+/// Скользящее окно длиной 15 мин
+#define AGGREGATOR_WINDOW_15MIN     2
+/// Количество скользящих окон
+#define AGGREGATOR_WINDOWS          3
+
+/// Наибольшая пауза между пакетами, которая засчитывается во время занятости полосы, мс
+#define AGGREGATOR_MAX_GAP          1000
+
+/// Признак зоны, не относящейся ни к одной полосе
+#define AGGREGATOR_NO_LANE          (-1)
+
+/**
+ * \brief Показатели полосы за окно
+ */
+struct lane_report {
+    int lane;                   ///< Номер полосы, возвращённый LaneAggregator::add_lane()
+    u_short_t zone_id;          ///< Зона детектора полосы
+    int window;                 ///< Окно: AGGREGATOR_WINDOW_1S, AGGREGATOR_WINDOW_1MIN или AGGREGATOR_WINDOW_15MIN
+    double window_seconds;      ///< Длина окна, с
+    /// Конец окна. Для отчёта по интервалу - граница интервала, для текущего отчёта - последний пакет.
+    std::chrono::steady_clock::time_point window_end;
+
+    unsigned long long vehicles;    ///< Количество въездов в зону детектора
+    double flow_per_hour;           ///< Интенсивность, авт/ч
+    double occupancy;               ///< Доля времени, когда зона была занята, %
+    double mean_headway;            ///< Средний интервал между въездами, с, или 0, если интервалов нет
+    double mean_speed;              ///< Средний модуль скорости при въезде
+};
+
+/// Функция, которой передаются отчёты по завершённым интервалам
+typedef std::function<void(const lane_report &)> lane_report_callback;
+
+/**
+ * \brief Объект расчёта показателей движения по полосам в реальном времени
+ *
+ * Каждая полоса задаётся зоной детектора в ZoneMap, как виртуальная индукционная петля. Полоса занята, если
+ * в пакете есть хотя бы одна цель в её зоне. Переход из свободного состояния в занятое считается въездом
+ * транспортного средства: по въездам считаются интенсивность, интервалы между въездами и средняя скорость,
+ * по времени занятости - процент занятости.
+ *
+ * Для каждой полосы ведутся скользящие окна 1 с, 1 мин и 15 мин, каждое из которых разбито на корзины
+ * в кольцевом буфере (10 по 100 мс, 60 по 1 с и 90 по 10 с). Вместе с корзинами хранятся суммы по окну:
+ * при переходе в новую корзину самая старая вычитается из суммы и обнуляется, поэтому обновление - O(1)
+ * на цель и на корзину, а отчёт читает только сумму. Память выделяется в add_lane().
+ *
+ * Когда время пакета пересекает границу интервала, кратного длине окна, отчёт за завершившийся интервал
+ * передаётся в lane_report_callback.
+ *
+ * **Пример**
+ * \code
+ * LaneAggregator aggregator(zones);
+ * aggregator.add_lane(1);
+ * aggregator.add_lane(2);
+ *
+ * aggregator.set_report_callback([](const lane_report &report) {
+ *     if (report.window == AGGREGATOR_WINDOW_1MIN) {
+ *         printf("lane %d: %.0f veh/h, %.1f%%\n", report.lane, report.flow_per_hour, report.occupancy);
+ *     }
+ * });
+ *
+ * while (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+ *     aggregator.update(batch, std::chrono::steady_clock::now());
+ * }
+ * \endcode
+ */
+class LaneAggregator {
+
+private:
+    /**
+     * \brief Накопленные значения корзины или окна
+     */
+    struct window_bucket {
+        unsigned long long vehicles = 0;
+        unsigned long long headways = 0;
+        double occupied_seconds = 0;
+        double headway_seconds = 0;
+        double speed_sum = 0;
+
+        void add(const window_bucket &other) {
+            vehicles += other.vehicles;
+            headways += other.headways;
+            occupied_seconds += other.occupied_seconds;
+            headway_seconds += other.headway_seconds;
+            speed_sum += other.speed_sum;
+        }
+
+        void subtract(const window_bucket &other) {
+            vehicles -= other.vehicles;
+            headways -= other.headways;
+            occupied_seconds -= other.occupied_seconds;
+            headway_seconds -= other.headway_seconds;
+            speed_sum -= other.speed_sum;
+        }
+    };
+
+    /**
+     * \brief Скользящее окно одной полосы
+     */
+    struct lane_window {
+        std::vector<window_bucket> buckets;
+        window_bucket total;
+        /// Абсолютный номер текущей корзины
+        long long current = 0;
+    };
+
+    /**
+     * \brief Состояние полосы
+     */
+    struct lane_state {
+        u_short_t zone_id = 0;
+        bool occupied = false;
+        bool has_arrival = false;
+        std::chrono::steady_clock::time_point last_arrival{};
+        /// Наибольшая скорость цели в зоне в текущем пакете
+        float speed = 0;
+        bool hit = false;
+        lane_window windows[AGGREGATOR_WINDOWS];
+    };
+
+    /// Длина корзины и количество корзин каждого окна
+    static constexpr long long bucket_ms[AGGREGATOR_WINDOWS] = {100, 1000, 10000};
+    static constexpr int bucket_count[AGGREGATOR_WINDOWS] = {10, 60, 90};
+
+    const ZoneMap &zones;
+
+    std::vector<lane_state> lanes;
+    /// Полоса для каждого номера зоны или AGGREGATOR_NO_LANE
+    std::vector<short> lane_of_zone;
+
+    u_short_t sets[TARGET_BATCH_CAPACITY]{};
+
+    bool started = false;
+    std::chrono::steady_clock::time_point epoch{};
+    std::chrono::steady_clock::time_point last_update{};
+
+    lane_report_callback callback;
+
+    /**
+     * \brief Отчёт по сумме окна
+     *
+     * \param [in] lane Номер полосы
+     * \param [in] window Номер окна
+     * \param [in] window_end Конец окна
+     */
+    lane_report make_report(int lane, int window, std::chrono::steady_clock::time_point window_end) const {
+        const window_bucket &total = lanes[lane].windows[window].total;
+        double seconds = (double) (bucket_ms[window] * bucket_count[window]) / 1000.0;
+
+        lane_report report{};
+
+        report.lane = lane;
+        report.zone_id = lanes[lane].zone_id;
+        report.window = window;
+        report.window_seconds = seconds;
+        report.window_end = window_end;
+        report.vehicles = total.vehicles;
+        report.flow_per_hour = (double) total.vehicles * 3600.0 / seconds;
+        report.occupancy = std::fmin(100.0, std::fmax(0.0, total.occupied_seconds * 100.0 / seconds));
+        report.mean_headway = total.headways > 0 ? total.headway_seconds / (double) total.headways : 0.0;
+        report.mean_speed = total.vehicles > 0 ? total.speed_sum / (double) total.vehicles : 0.0;
+
+        return report;
+    }
+
+    /**
+     * \brief Переход окна к корзине с номером target
+     *
+     * Старые корзины вычитаются из суммы и обнуляются. На границах интервалов, кратных длине окна,
+     * передаётся отчёт за завершившийся интервал.
+     *
+     * \param [in] lane Номер полосы
+     * \param [in] window Номер окна
+     * \param [in] target Абсолютный номер корзины, соответствующей времени пакета
+     */
+    void advance(int lane, int window, long long target) {
+        lane_window &state = lanes[lane].windows[window];
+        int count = bucket_count[window];
+
+        /// После паузы длиннее окна достаточно закрыть текущий интервал, интервалы паузы пусты и не передаются
+        long long last = target - state.current > count ? (state.current / count + 1) * count : target;
+
+        while (state.current < last) {
+            ++state.current;
+
+            if (callback && state.current % count == 0) {
+                emit(lane, window, state.current);
+            }
+
+            window_bucket &oldest = state.buckets[state.current % count];
+
+            state.total.subtract(oldest);
+            oldest = window_bucket{};
+        }
+
+        if (state.current < target) {
+            std::fill(state.buckets.begin(), state.buckets.end(), window_bucket{});
+            state.total = window_bucket{};
+            state.current = target;
+        }
+    }
+
+    /**
+     * \brief Передача отчёта за интервал, который заканчивается перед корзиной boundary
+     *
+     * \param [in] lane Номер полосы
+     * \param [in] window Номер окна
+     * \param [in] boundary Абсолютный номер первой корзины следующего интервала
+     */
+    void emit(int lane, int window, long long boundary) {
+        callback(make_report(lane, window, epoch + std::chrono::milliseconds(boundary * bucket_ms[window])));
+    }
+
+    /**
+     * \brief Добавление значений в текущую корзину и сумму окна
+     *
+     * \param [in,out] state Окно полосы
+     * \param [in] window Номер окна
+     * \param [in] values Добавляемые значения
+     */
+    static void add(lane_window &state, int window, const window_bucket &values) {
+        state.buckets[state.current % bucket_count[window]].add(values);
+        state.total.add(values);
+    }
+
+public:
+    /**
+     * \brief Конструктор.
+     *
+     * \param [in] zone_map Карта зон, по которой цели относятся к полосам. Должна существовать, пока используется объект.
+     */
+    explicit LaneAggregator(const ZoneMap &zone_map) : zones(zone_map), lane_of_zone(0x10000, AGGREGATOR_NO_LANE) {}
+
+    /**
+     * \brief Добавление полосы.
+     *
+     * Полосы добавляются до первого вызова update().
+     *
+     * \param [in] zone_id Зона детектора полосы в карте зон
+     * \return Номер полосы или -1, если зона уже используется или обработка уже начата
+     */
+    int add_lane(u_short_t zone_id) {
+        if (started || lane_of_zone[zone_id] != AGGREGATOR_NO_LANE) {
+            return -1;
+        }
+
+        lane_state lane;
+        lane.zone_id = zone_id;
+
+        for (int window = 0; window < AGGREGATOR_WINDOWS; ++window) {
+            lane.windows[window].buckets.resize(bucket_count[window]);
+        }
+
+        lane_of_zone[zone_id] = (short) lanes.size();
+        lanes.push_back(std::move(lane));
+
+        return (int) lanes.size() - 1;
+    }
+
+    /**
+     * \brief Установка функции, которой передаются отчёты по завершённым интервалам.
+     *
+     * \param [in] new_callback Функция, вызываемая из update()
+     */
+    void set_report_callback(lane_report_callback new_callback) {
+        callback = std::move(new_callback);
+    }
+
+    /**
+     * \brief Обработка пакета целей.
+     *
+     * Цели относятся к полосам по координатам дороги, поэтому пакет должен быть переведён RoadTransform.
+     *
+     * \param [in] batch Пакет целей
+     * \param [in] received_at Время приёма пакета, не убывает между вызовами
+     */
+    void update(const target_batch &batch, std::chrono::steady_clock::time_point received_at) {
+        if (!started) {
+            started = true;
+            epoch = received_at;
+            last_update = received_at;
+        }
+
+        if (received_at < last_update) {
+            received_at = last_update;
+        }
+
+        double elapsed = std::chrono::duration<double>(received_at - last_update).count();
+
+        if (elapsed > AGGREGATOR_MAX_GAP / 1000.0) {
+            elapsed = 0;
+        }
+
+        long long now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(received_at - epoch).count();
+
+        for (int lane = 0; lane < (int) lanes.size(); ++lane) {
+            for (int window = 0; window < AGGREGATOR_WINDOWS; ++window) {
+                advance(lane, window, now_ms / bucket_ms[window]);
+            }
+
+            lanes[lane].hit = false;
+            lanes[lane].speed = 0;
+        }
+
+        zones.classify(batch, sets);
+
+        for (int pos = 0; pos < batch.count; ++pos) {
+            if (sets[pos] == ZONE_SET_EMPTY) {
+                continue;
+            }
+
+            zone_set set = zones.get_zone_set(sets[pos]);
+
+            for (int zone = 0; zone < set.count; ++zone) {
+                short lane = lane_of_zone[set.zones[zone]];
+
+                if (lane != AGGREGATOR_NO_LANE) {
+                    lanes[lane].hit = true;
+                    lanes[lane].speed = std::fmax(lanes[lane].speed, std::fabs(batch.speed[pos]));
+                }
+            }
+        }
+
+        for (lane_state &lane: lanes) {
+            window_bucket values;
+
+            /// Время до текущего пакета относится к состоянию, определённому предыдущим пакетом
+            if (lane.occupied) {
+                values.occupied_seconds = elapsed;
+            }
+
+            if (lane.hit && !lane.occupied) {
+                values.vehicles = 1;
+                values.speed_sum = lane.speed;
+
+                if (lane.has_arrival) {
+                    values.headways = 1;
+                    values.headway_seconds = std::chrono::duration<double>(received_at - lane.last_arrival).count();
+                }
+
+                lane.has_arrival = true;
+                lane.last_arrival = received_at;
+            }
+
+            lane.occupied = lane.hit;
+
+            for (int window = 0; window < AGGREGATOR_WINDOWS; ++window) {
+                add(lane.windows[window], window, values);
+            }
+        }
+
+        last_update = received_at;
+    }
+
+    /**
+     * \brief Показатели полосы за последнее окно.
+     *
+     * Сумма окна уже накоплена, поэтому отчёт не просматривает историю.
+     *
+     * \param [in] lane Номер полосы
+     * \param [in] window AGGREGATOR_WINDOW_1S, AGGREGATOR_WINDOW_1MIN или AGGREGATOR_WINDOW_15MIN
+     * \return Отчёт или пустой отчёт, если номер неверный
+     */
+    lane_report get_report(int lane, int window) const {
+        if (lane < 0 || lane >= (int) lanes.size() || window < 0 || window >= AGGREGATOR_WINDOWS) {
+            return lane_report{};
+        }
+
+        return make_report(lane, window, last_update);
+    }
+
+    size_t get_lane_count() const {
+        return lanes.size();
+    }
+};
+
+#endif //SMART_ROAD_LANE_AGGREGATOR_HPP
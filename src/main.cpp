@@ -1,11 +1,20 @@
 #include "smart_road_radar_cli.hpp"
 
 #define DEMO_ADDRESS "DEMO"
+#define REPLAY_ADDRESS "REPLAY"
+#define LOOPBACK_ADDRESS "LOOPBACK"
 
 void usage() {
     printf("SmartRoadRadar-CLI\n\n");
     printf("Run with COM-port name and baud rate as arguments.\n");
     printf("Example: smart_road_radar.exe COM1 230400\n");
+    printf("Example: ./smart_road_radar /dev/ttyUSB0 230400\n");
+    printf("Run with REPLAY and a recording file to replay recorded frames.\n");
+    printf("Example: ./smart_road_radar REPLAY radar.rec\n");
+    printf("Run with DEMO and a frame rate (or max) to generate targets at that rate with a fixed seed.\n");
+    printf("Example: ./smart_road_radar DEMO 5000\n");
+    printf("Run with LOOPBACK and a seed to emulate a radar through the full protocol path.\n");
+    printf("Example: ./smart_road_radar LOOPBACK 42\n");
 }
 
 int main(int argc, char* argv[]) {
@@ -18,7 +27,17 @@ int main(int argc, char* argv[]) {
     SmartRoadRadarCLI *radar_cli;
 
     if (strcmp(argv[1], DEMO_ADDRESS) == 0) {
-        radar_cli = new SmartRoadRadarCLI();
+        double rate = strcmp(argv[2], "max") == 0 ? GENERATOR_RATE_UNLIMITED : atof(argv[2]);
+
+        if (rate == GENERATOR_RATE_UNLIMITED || rate > 0) {
+            radar_cli = new SmartRoadRadarCLI(new SmartRoadRadarDemo(1, rate));
+        } else {
+            radar_cli = new SmartRoadRadarCLI();
+        }
+    } else if (strcmp(argv[1], REPLAY_ADDRESS) == 0) {
+        radar_cli = new SmartRoadRadarCLI(new SmartRoadRadarReplay(argv[2]));
+    } else if (strcmp(argv[1], LOOPBACK_ADDRESS) == 0) {
+        radar_cli = new SmartRoadRadarCLI(new SmartRoadRadarLoopback((unsigned int) strtoul(argv[2], nullptr, 10)));
     } else {
         port_config config{};
 
@@ -0,0 +1,526 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий экспорт показателей радаров в текстовом формате Prometheus MetricsExporter
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_METRICS_EXPORTER_HPP
+#define SMART_ROAD_METRICS_EXPORTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "smart_road_radar.hpp"
+
+/// Возвращаемое значение при успешной работе экспорта показателей
+#define METRICS_EXPORTER_OK     0
+/// Возвращаемое значение при ошибке работы экспорта показателей
+#define METRICS_EXPORTER_ERROR  1
+
+/// Интервал проверки флага остановки потока экспорта, мс
+#define METRICS_EXPORTER_POLL_TIMEOUT       100
+/// Время ожидания запроса от подключившегося клиента, мс
+#define METRICS_EXPORTER_REQUEST_TIMEOUT    1000
+/// Размер буфера для чтения запроса
+#define METRICS_EXPORTER_REQUEST_SIZE       1024
+
+/**
+ * \brief Экспорт показателей радаров в текстовом формате Prometheus
+ *
+ * Поток экспорта принимает подключения на локальном TCP-порту или Unix-сокете и на каждый HTTP-запрос
+ * отвечает текущими показателями всех добавленных радаров:
+ *
+ * - количество принятых кадров и кадров в секунду;
+ * - количество кадров с неверной контрольной суммой и их доля;
+ * - количество восстановлений синхронизации, пропущенных байт и кадров, отброшенных по таймауту;
+ * - время выполнения команд (медиана, 99-й процентиль, сумма и количество);
+ * - заполненность очереди фонового чтения и количество отброшенных из-за её переполнения кадров;
+ * - количество целей в последнем пакете.
+ *
+ * Показатели читаются через SmartRoadRadar::get_health() и PipelineStats только из атомарных счётчиков,
+ * поэтому запрос показателей не захватывает мьютексы радара и не задерживает приём кадров. Частота кадров
+ * и доля ошибок считаются по изменению счётчиков с предыдущего запроса. PipelineStats не сбрасывается
+ * командой stats, поэтому счётчики ошибок и времени выполнения команд остаются монотонными.
+ *
+ * Экспорт доступен только на POSIX-системах, на Windows функции запуска возвращают METRICS_EXPORTER_ERROR.
+ *
+ * **Пример**
+ * \code
+ * SmartRoadRadar radar("/dev/ttyUSB0");
+ * MetricsExporter exporter;
+ *
+ * exporter.add_radar(&radar, "north");
+ *
+ * if (exporter.start_tcp(9464) == METRICS_EXPORTER_OK) {
+ *     // curl http://127.0.0.1:9464/metrics
+ * }
+ * \endcode
+ */
+class MetricsExporter {
+
+private:
+    /// Радар и значения счётчиков при предыдущем запросе
+    struct exported_radar {
+        SmartRoadRadar *radar = nullptr;
+        std::string label;
+
+        unsigned long long last_frames = 0;
+        unsigned long long last_checksum_failures = 0;
+        std::chrono::steady_clock::time_point last_scrape{};
+    };
+
+    std::vector<exported_radar> radars;
+
+    /// Сокет, на котором принимаются подключения
+    int listen_fd = -1;
+    /// Путь Unix-сокета, который удаляется при остановке
+    std::string socket_path;
+
+    std::thread server_thread;
+    std::atomic<bool> running{false};
+
+    /// Буфер ответа, переиспользуемый между запросами
+    std::string body;
+
+    /**
+     * \brief Экранирование значения метки.
+     *
+     * \param [in] value Значение
+     * \return Значение, в котором экранированы обратная косая черта, кавычка и перевод строки
+     */
+    static std::string escape_label(const std::string &value) {
+        std::string escaped;
+
+        for (char symbol : value) {
+            if (symbol == '\\' || symbol == '"') {
+                escaped += '\\';
+                escaped += symbol;
+            } else if (symbol == '\n') {
+                escaped += "\\n";
+            } else {
+                escaped += symbol;
+            }
+        }
+
+        return escaped;
+    }
+
+    /**
+     * \brief Добавление строки к ответу.
+     *
+     * Строка форматируется сразу в конец ответа: первый вызов snprintf() определяет её длину,
+     * поэтому длинные метки не обрезаются вместе с завершающим переводом строки.
+     */
+    template<typename... Args>
+    void append(const char *format, Args... args) {
+        int length = snprintf(nullptr, 0, format, args...);
+
+        if (length <= 0) {
+            return;
+        }
+
+        size_t offset = body.size();
+
+        /// Место под завершающий нуль, который пишет snprintf()
+        body.resize(offset + (size_t) length + 1);
+        snprintf(&body[offset], (size_t) length + 1, format, args...);
+        body.resize(offset + (size_t) length);
+    }
+
+    /**
+     * \brief Добавление описания показателя.
+     */
+    void append_header(const char *name, const char *type, const char *help) {
+        append("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+
+    /**
+     * \brief Формирование текста с показателями всех радаров.
+     */
+    void render() {
+        auto now = std::chrono::steady_clock::now();
+
+        std::vector<radar_health> health(radars.size());
+        std::vector<pipeline_stage_summary> commands(radars.size());
+
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            health[pos] = radars[pos].radar->get_health();
+            commands[pos] = radars[pos].radar->get_pipeline_stats().get_summary(PIPELINE_STAGE_COMMAND);
+        }
+
+        body.clear();
+
+        append_header("smart_road_frames_received_total", "counter", "Frames received from the radar.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_frames_received_total{radar=\"%s\"} %llu\n",
+                   radars[pos].label.c_str(), health[pos].frames_received);
+        }
+
+        append_header("smart_road_frames_per_second", "gauge", "Frame rate since the previous scrape.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            exported_radar &radar = radars[pos];
+            double seconds = std::chrono::duration<double>(now - radar.last_scrape).count();
+            unsigned long long frames = health[pos].frames_received - radar.last_frames;
+
+            /// Счётчики могли быть сброшены между запросами
+            if (health[pos].frames_received < radar.last_frames) {
+                frames = health[pos].frames_received;
+            }
+
+            append("smart_road_frames_per_second{radar=\"%s\"} %.3f\n",
+                   radar.label.c_str(), seconds > 0 ? (double) frames / seconds : 0.0);
+        }
+
+        append_header("smart_road_checksum_failures_total", "counter", "Frames with an invalid checksum.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_checksum_failures_total{radar=\"%s\"} %llu\n",
+                   radars[pos].label.c_str(), health[pos].checksum_failures);
+        }
+
+        append_header("smart_road_checksum_error_ratio", "gauge",
+                      "Share of frames with an invalid checksum since the previous scrape.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            exported_radar &radar = radars[pos];
+            double ratio = 0;
+
+            if (health[pos].frames_received > radar.last_frames &&
+                health[pos].checksum_failures >= radar.last_checksum_failures) {
+                ratio = (double) (health[pos].checksum_failures - radar.last_checksum_failures) /
+                        (double) (health[pos].frames_received - radar.last_frames);
+            }
+
+            append("smart_road_checksum_error_ratio{radar=\"%s\"} %.6f\n", radar.label.c_str(), ratio);
+        }
+
+        append_header("smart_road_resync_total", "counter", "Valid frames found after losing synchronization.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_resync_total{radar=\"%s\"} %llu\n",
+                   radars[pos].label.c_str(), health[pos].frames_recovered);
+        }
+
+        append_header("smart_road_bytes_skipped_total", "counter", "Bytes skipped while searching for a header.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_bytes_skipped_total{radar=\"%s\"} %llu\n",
+                   radars[pos].label.c_str(), health[pos].bytes_skipped);
+        }
+
+        append_header("smart_road_frame_timeouts_total", "counter", "Partial frames dropped on a read timeout.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_frame_timeouts_total{radar=\"%s\"} %llu\n",
+                   radars[pos].label.c_str(), health[pos].frame_timeouts);
+        }
+
+        append_header("smart_road_command_round_trip_seconds", "summary",
+                      "Time from sending a command to receiving its status frame.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            const char *label = radars[pos].label.c_str();
+            const pipeline_stage_summary &summary = commands[pos];
+
+            append("smart_road_command_round_trip_seconds{radar=\"%s\",quantile=\"0.5\"} %.9f\n",
+                   label, summary.p50 / 1e9);
+            append("smart_road_command_round_trip_seconds{radar=\"%s\",quantile=\"0.99\"} %.9f\n",
+                   label, summary.p99 / 1e9);
+            append("smart_road_command_round_trip_seconds_sum{radar=\"%s\"} %.9f\n",
+                   label, summary.mean * (double) summary.count / 1e9);
+            append("smart_road_command_round_trip_seconds_count{radar=\"%s\"} %llu\n",
+                   label, summary.count);
+        }
+
+        append_header("smart_road_acquisition_queue_depth", "gauge", "Frames waiting in the acquisition queue.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_acquisition_queue_depth{radar=\"%s\"} %zu\n",
+                   radars[pos].label.c_str(), health[pos].queue_depth);
+        }
+
+        append_header("smart_road_acquisition_dropped_total", "counter",
+                      "Frames dropped because the acquisition queue was full.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_acquisition_dropped_total{radar=\"%s\"} %llu\n",
+                   radars[pos].label.c_str(), health[pos].frames_dropped);
+        }
+
+        append_header("smart_road_targets", "gauge", "Targets in the most recent batch.");
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            append("smart_road_targets{radar=\"%s\"} %d\n", radars[pos].label.c_str(), health[pos].target_count);
+        }
+
+        for (size_t pos = 0; pos < radars.size(); ++pos) {
+            radars[pos].last_frames = health[pos].frames_received;
+            radars[pos].last_checksum_failures = health[pos].checksum_failures;
+            radars[pos].last_scrape = now;
+        }
+    }
+
+#ifndef _WIN32
+    /**
+     * \brief Обслуживание одного подключения.
+     *
+     * Запрос читается до пустой строки, его путь не проверяется: на любой запрос возвращаются показатели.
+     *
+     * \param [in] client_fd Сокет клиента
+     */
+    void serve(int client_fd) {
+        char request[METRICS_EXPORTER_REQUEST_SIZE];
+        size_t received = 0;
+
+        while (received < sizeof(request) - 1) {
+            pollfd descriptor{client_fd, POLLIN, 0};
+
+            if (poll(&descriptor, 1, METRICS_EXPORTER_REQUEST_TIMEOUT) <= 0) {
+                return;
+            }
+
+            ssize_t size = ::recv(client_fd, request + received, sizeof(request) - 1 - received, 0);
+
+            if (size <= 0) {
+                return;
+            }
+
+            received += (size_t) size;
+            request[received] = '\0';
+
+            if (strstr(request, "\r\n\r\n") != nullptr || strstr(request, "\n\n") != nullptr) {
+                break;
+            }
+        }
+
+        render();
+
+        char header[128];
+        int header_length = snprintf(header, sizeof(header),
+                                     "HTTP/1.1 200 OK\r\n"
+                                     "Content-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: %zu\r\n"
+                                     "Connection: close\r\n\r\n",
+                                     body.size());
+
+        /// Заголовок и тело отправляются одним вызовом
+        body.insert(0, header, (size_t) header_length);
+
+        size_t sent = 0;
+
+        while (sent < body.size()) {
+            ssize_t size = ::send(client_fd, body.data() + sent, body.size() - sent, MSG_NOSIGNAL);
+
+            if (size <= 0) {
+                return;
+            }
+
+            sent += (size_t) size;
+        }
+    }
+
+    /**
+     * \brief Тело потока экспорта.
+     */
+    void server_loop() {
+        while (running.load()) {
+            pollfd descriptor{listen_fd, POLLIN, 0};
+
+            if (poll(&descriptor, 1, METRICS_EXPORTER_POLL_TIMEOUT) <= 0) {
+                continue;
+            }
+
+            int client_fd = ::accept(listen_fd, nullptr, nullptr);
+
+            if (client_fd < 0) {
+                continue;
+            }
+
+            serve(client_fd);
+            ::close(client_fd);
+        }
+    }
+
+    /**
+     * \brief Запуск потока экспорта на подготовленном сокете.
+     *
+     * \param [in] fd Сокет, привязанный к адресу
+     */
+    int listen_on(int fd) {
+        if (::listen(fd, 4) != 0) {
+            ::close(fd);
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        listen_fd = fd;
+
+        auto now = std::chrono::steady_clock::now();
+
+        for (exported_radar &radar : radars) {
+            radar_health health = radar.radar->get_health();
+
+            radar.last_frames = health.frames_received;
+            radar.last_checksum_failures = health.checksum_failures;
+            radar.last_scrape = now;
+        }
+
+        running.store(true);
+        server_thread = std::thread(&MetricsExporter::server_loop, this);
+
+        return METRICS_EXPORTER_OK;
+    }
+#endif
+
+public:
+    MetricsExporter() = default;
+
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    ~MetricsExporter() {
+        stop();
+    }
+
+    /**
+     * \brief Добавление радара.
+     *
+     * Радары добавляются до запуска экспорта и должны существовать до вызова stop().
+     *
+     * \param [in] radar Радар
+     * \param [in] name Значение метки radar в показателях
+     * \return METRICS_EXPORTER_OK или METRICS_EXPORTER_ERROR, если экспорт уже запущен или радар не передан
+     */
+    int add_radar(SmartRoadRadar *radar, const std::string &name) {
+        if (radar == nullptr || running.load()) {
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        exported_radar exported;
+        exported.radar = radar;
+        exported.label = escape_label(name);
+
+        radars.push_back(exported);
+
+        return METRICS_EXPORTER_OK;
+    }
+
+    /**
+     * \brief Запуск экспорта на TCP-порту локального интерфейса 127.0.0.1.
+     *
+     * \param [in] port Номер порта
+     * \return METRICS_EXPORTER_OK или METRICS_EXPORTER_ERROR, если экспорт уже запущен или порт занят
+     */
+    int start_tcp(u_short_t port) {
+#ifdef _WIN32
+        return METRICS_EXPORTER_ERROR;
+#else
+        if (running.load()) {
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+        if (fd < 0) {
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (::bind(fd, (sockaddr *) &address, sizeof(address)) != 0) {
+            ::close(fd);
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        return listen_on(fd);
+#endif
+    }
+
+    /**
+     * \brief Запуск экспорта на Unix-сокете.
+     *
+     * Существующий файл по этому пути заменяется, при остановке сокет удаляется.
+     *
+     * \param [in] path Путь к сокету
+     * \return METRICS_EXPORTER_OK или METRICS_EXPORTER_ERROR, если экспорт уже запущен или сокет не создан
+     */
+    int start_unix(const std::string &path) {
+#ifdef _WIN32
+        return METRICS_EXPORTER_ERROR;
+#else
+        sockaddr_un address{};
+
+        if (running.load() || path.empty() || path.size() >= sizeof(address.sun_path)) {
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (fd < 0) {
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        address.sun_family = AF_UNIX;
+        memcpy(address.sun_path, path.c_str(), path.size());
+
+        ::unlink(path.c_str());
+
+        if (::bind(fd, (sockaddr *) &address, sizeof(address)) != 0) {
+            ::close(fd);
+            return METRICS_EXPORTER_ERROR;
+        }
+
+        socket_path = path;
+
+        return listen_on(fd);
+#endif
+    }
+
+    /**
+     * \brief Остановка экспорта.
+     *
+     * Поток экспорта завершается не позднее чем через METRICS_EXPORTER_POLL_TIMEOUT после обслуживания
+     * текущего подключения.
+     */
+    void stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+
+        if (server_thread.joinable()) {
+            server_thread.join();
+        }
+
+#ifndef _WIN32
+        ::close(listen_fd);
+
+        if (!socket_path.empty()) {
+            ::unlink(socket_path.c_str());
+            socket_path.clear();
+        }
+#endif
+
+        listen_fd = -1;
+    }
+
+    /**
+     * \brief Проверка, работает ли экспорт.
+     */
+    bool is_running() const {
+        return running.load();
+    }
+};
+
+#endif //SMART_ROAD_METRICS_EXPORTER_HPP
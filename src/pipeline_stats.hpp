@@ -0,0 +1,413 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий счётчики и гистограммы задержек этапов обработки кадров PipelineStats
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_PIPELINE_STATS_HPP
+#define SMART_ROAD_PIPELINE_STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "spsc_queue.hpp"
+
+/// Чтение байт из порта, учитываются только вызовы, вернувшие данные
+#define PIPELINE_STAGE_SERIAL_READ      0
+/// Разбор кадра парсером
+#define PIPELINE_STAGE_FRAME_PARSE      1
+/// Декодирование целей и облака точек
+#define PIPELINE_STAGE_DECODE           2
+/// Вывод целей на экран
+#define PIPELINE_STAGE_RENDER           3
+/// Отправка команды и приём ответа со статусом
+#define PIPELINE_STAGE_COMMAND          4
+/// Количество этапов
+#define PIPELINE_STAGE_COUNT            5
+
+/// Кадры с неверной контрольной суммой
+#define PIPELINE_COUNTER_CHECKSUM_FAILURES  0
+/// Кадры, пропущенные read_expected_frame() из-за другого командного слова
+#define PIPELINE_COUNTER_FRAME_DISCARDS     1
+/// Количество счётчиков
+#define PIPELINE_COUNTER_COUNT              2
+
+/// Количество ячеек, между которыми распределяются потоки
+#define PIPELINE_STATS_SLOTS            8
+/// Количество поддиапазонов в каждой степени двойки
+#define PIPELINE_STATS_SUB_BUCKETS      4
+/// Количество интервалов гистограммы, последний покрывает длительности от 2^40 нс
+#define PIPELINE_STATS_BUCKETS          160
+
+/// Сводка по этапу обработки, длительности в наносекундах
+struct pipeline_stage_summary {
+    unsigned long long count = 0;   ///< Количество измерений
+    double mean = 0;                ///< Средняя длительность
+    double p50 = 0;                 ///< Медиана
+    double p99 = 0;                 ///< 99-й процентиль
+    double max = 0;                 ///< Максимальная длительность
+};
+
+/// Накопленные значения одного этапа, длительности в наносекундах
+struct pipeline_stage_snapshot {
+    uint64_t count = 0;                             ///< Количество измерений
+    uint64_t total = 0;                             ///< Сумма длительностей
+    uint64_t max = 0;                               ///< Максимальная длительность
+    uint64_t buckets[PIPELINE_STATS_BUCKETS] = {};  ///< Гистограмма
+};
+
+/// Накопленные значения всех этапов и счётчиков, от которых отсчитывается сводка
+struct pipeline_stats_snapshot {
+    pipeline_stage_snapshot stages[PIPELINE_STAGE_COUNT];       ///< Этапы PIPELINE_STAGE_*
+    unsigned long long counters[PIPELINE_COUNTER_COUNT] = {};   ///< Счётчики PIPELINE_COUNTER_*
+};
+
+/**
+ * \brief Счётчики и гистограммы задержек этапов обработки кадров
+ *
+ * Каждый поток пишет в свою ячейку, выровненную по строке кэша, поэтому запись не требует блокировок
+ * и не вызывает ложного разделения между потоком фонового чтения и потоком вывода. Если потоков
+ * больше PIPELINE_STATS_SLOTS, то ячейки используются несколькими потоками, и значения остаются
+ * верными благодаря атомарному сложению.
+ *
+ * Длительности собираются в логарифмическую гистограмму: каждая степень двойки делится на
+ * PIPELINE_STATS_SUB_BUCKETS интервалов, поэтому относительная погрешность процентилей не превышает 12,5%.
+ * Ячейки суммируются только при запросе сводки.
+ *
+ * Значения только накапливаются и не сбрасываются, поэтому их можно экспортировать как монотонные счётчики.
+ * Сводка за период строится по разности с сохранённым снимком get_snapshot(), у каждого читателя свой снимок.
+ *
+ * **Пример**
+ * \code
+ * PipelineStats stats;
+ *
+ * {
+ *     PipelineStats::Timer timer(&stats, PIPELINE_STAGE_DECODE);
+ *     decode_targets(data, count, &batch);
+ * }
+ *
+ * pipeline_stage_summary summary = stats.get_summary(PIPELINE_STAGE_DECODE);
+ * printf("p99 = %.0f ns\n", summary.p99);
+ * \endcode
+ */
+class PipelineStats {
+
+private:
+    /// Данные одного этапа в ячейке
+    struct stage_slot {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> max{0};
+        std::atomic<uint64_t> buckets[PIPELINE_STATS_BUCKETS]{};
+    };
+
+    /// Ячейка одной группы потоков
+    struct alignas(CACHE_LINE_SIZE) slot {
+        stage_slot stages[PIPELINE_STAGE_COUNT];
+        std::atomic<uint64_t> counters[PIPELINE_COUNTER_COUNT]{};
+    };
+
+    std::unique_ptr<slot[]> slots;
+
+    /// Счётчик, из которого потоки получают номер ячейки
+    inline static std::atomic<unsigned> next_thread_index{0};
+
+    /**
+     * \brief Ячейка текущего потока.
+     */
+    slot &get_slot() {
+        thread_local unsigned thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+
+        return slots[thread_index % PIPELINE_STATS_SLOTS];
+    }
+
+    /**
+     * \brief Номер интервала гистограммы для длительности.
+     *
+     * \param [in] value Длительность в наносекундах
+     */
+    static int get_bucket(uint64_t value) {
+        if (value < PIPELINE_STATS_SUB_BUCKETS) {
+            return (int) value;
+        }
+
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        int power = (int) index;
+#else
+        int power = 63 - __builtin_clzll(value);
+#endif
+        int sub_bucket = (int) (value >> (power - 2)) & (PIPELINE_STATS_SUB_BUCKETS - 1);
+        int bucket = (power - 1) * PIPELINE_STATS_SUB_BUCKETS + sub_bucket;
+
+        return bucket < PIPELINE_STATS_BUCKETS ? bucket : PIPELINE_STATS_BUCKETS - 1;
+    }
+
+    /**
+     * \brief Середина интервала гистограммы.
+     *
+     * \param [in] bucket Номер интервала
+     */
+    static double get_bucket_value(int bucket) {
+        if (bucket < PIPELINE_STATS_SUB_BUCKETS) {
+            return bucket;
+        }
+
+        int power = bucket / PIPELINE_STATS_SUB_BUCKETS + 1;
+        int sub_bucket = bucket % PIPELINE_STATS_SUB_BUCKETS;
+        double width = (double) (1ull << (power - 2));
+
+        return (double) (1ull << power) + width * (sub_bucket + 0.5);
+    }
+
+    /**
+     * \brief Верхняя граница интервала гистограммы.
+     *
+     * \param [in] bucket Номер интервала
+     */
+    static uint64_t get_bucket_limit(int bucket) {
+        if (bucket < PIPELINE_STATS_SUB_BUCKETS) {
+            return (uint64_t) bucket;
+        }
+
+        int power = bucket / PIPELINE_STATS_SUB_BUCKETS + 1;
+        int sub_bucket = bucket % PIPELINE_STATS_SUB_BUCKETS;
+
+        return (1ull << power) + (1ull << (power - 2)) * (uint64_t) (sub_bucket + 1) - 1;
+    }
+
+    /**
+     * \brief Сложение значений этапа из всех ячеек.
+     *
+     * \param [in] stage Этап PIPELINE_STAGE_*
+     * \param [out] snapshot Накопленные значения этапа
+     */
+    void collect_stage(int stage, pipeline_stage_snapshot *snapshot) const {
+        *snapshot = pipeline_stage_snapshot{};
+
+        for (int index = 0; index < PIPELINE_STATS_SLOTS; ++index) {
+            const stage_slot &source = slots[index].stages[stage];
+
+            snapshot->count += source.count.load(std::memory_order_relaxed);
+            snapshot->total += source.total.load(std::memory_order_relaxed);
+
+            uint64_t slot_max = source.max.load(std::memory_order_relaxed);
+            snapshot->max = slot_max > snapshot->max ? slot_max : snapshot->max;
+
+            for (int bucket = 0; bucket < PIPELINE_STATS_BUCKETS; ++bucket) {
+                snapshot->buckets[bucket] += source.buckets[bucket].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * \brief Сводка по накопленным значениям этапа.
+     *
+     * \param [in] snapshot Накопленные значения этапа
+     */
+    static pipeline_stage_summary summarize(const pipeline_stage_snapshot &snapshot) {
+        pipeline_stage_summary summary{};
+        uint64_t histogram_count = 0;
+
+        summary.count = snapshot.count;
+
+        for (uint64_t value : snapshot.buckets) {
+            histogram_count += value;
+        }
+
+        if (histogram_count == 0 || snapshot.count == 0) {
+            return summary;
+        }
+
+        summary.mean = (double) snapshot.total / (double) snapshot.count;
+        summary.max = (double) snapshot.max;
+
+        /// Процентили ограничены сверху максимумом, поскольку середина интервала может его превышать
+        auto percentile = [&](double fraction) {
+            uint64_t rank = (uint64_t) (fraction * (double) (histogram_count - 1)) + 1;
+            uint64_t seen = 0;
+
+            for (int bucket = 0; bucket < PIPELINE_STATS_BUCKETS; ++bucket) {
+                seen += snapshot.buckets[bucket];
+
+                if (seen >= rank) {
+                    double value = get_bucket_value(bucket);
+                    return value < summary.max ? value : summary.max;
+                }
+            }
+
+            return summary.max;
+        };
+
+        summary.p50 = percentile(0.50);
+        summary.p99 = percentile(0.99);
+
+        return summary;
+    }
+
+public:
+    /**
+     * \brief Измерение длительности этапа от создания до уничтожения объекта
+     */
+    class Timer {
+
+    private:
+        PipelineStats *stats;
+        int stage;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        Timer(PipelineStats *target_stats, int target_stage)
+                : stats(target_stats), stage(target_stage), start(std::chrono::steady_clock::now()) {}
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        ~Timer() {
+            stats->record(stage, std::chrono::steady_clock::now() - start);
+        }
+    };
+
+    PipelineStats() : slots(new slot[PIPELINE_STATS_SLOTS]) {}
+
+    /**
+     * \brief Учёт длительности этапа.
+     *
+     * \param [in] stage Этап PIPELINE_STAGE_*
+     * \param [in] nanoseconds Длительность в наносекундах
+     */
+    void record(int stage, uint64_t nanoseconds) {
+        stage_slot &target = get_slot().stages[stage];
+
+        target.count.fetch_add(1, std::memory_order_relaxed);
+        target.total.fetch_add(nanoseconds, std::memory_order_relaxed);
+        target.buckets[get_bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = target.max.load(std::memory_order_relaxed);
+
+        while (nanoseconds > max && !target.max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed));
+    }
+
+    /**
+     * \brief Учёт длительности этапа.
+     *
+     * \param [in] stage Этап PIPELINE_STAGE_*
+     * \param [in] duration Длительность
+     */
+    void record(int stage, std::chrono::steady_clock::duration duration) {
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+
+        record(stage, (uint64_t) (nanoseconds > 0 ? nanoseconds : 0));
+    }
+
+    /**
+     * \brief Увеличение счётчика.
+     *
+     * \param [in] counter Счётчик PIPELINE_COUNTER_*
+     */
+    void increment(int counter) {
+        get_slot().counters[counter].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Сводка по этапу за всё время работы, собранная из всех ячеек.
+     *
+     * \param [in] stage Этап PIPELINE_STAGE_*
+     */
+    pipeline_stage_summary get_summary(int stage) const {
+        pipeline_stage_snapshot current;
+        collect_stage(stage, &current);
+
+        return summarize(current);
+    }
+
+    /**
+     * \brief Сводка по этапу за время, прошедшее после снимка.
+     *
+     * Если максимум после снимка не вырос, то он оценивается верхней границей старшего непустого интервала
+     * гистограммы с той же погрешностью, что и процентили.
+     *
+     * \param [in] stage Этап PIPELINE_STAGE_*
+     * \param [in] since Снимок, полученный get_snapshot()
+     */
+    pipeline_stage_summary get_summary(int stage, const pipeline_stats_snapshot &since) const {
+        const pipeline_stage_snapshot &base = since.stages[stage];
+        pipeline_stage_snapshot current;
+        collect_stage(stage, &current);
+
+        uint64_t max = current.max;
+
+        current.count -= base.count;
+        current.total -= base.total;
+        current.max = 0;
+
+        for (int bucket = 0; bucket < PIPELINE_STATS_BUCKETS; ++bucket) {
+            current.buckets[bucket] -= base.buckets[bucket];
+
+            if (current.buckets[bucket] > 0) {
+                uint64_t limit = get_bucket_limit(bucket);
+                current.max = limit < max ? limit : max;
+            }
+        }
+
+        if (max > base.max) {
+            current.max = max;
+        }
+
+        return summarize(current);
+    }
+
+    /**
+     * \brief Значение счётчика за всё время работы, собранное из всех ячеек.
+     *
+     * \param [in] counter Счётчик PIPELINE_COUNTER_*
+     */
+    unsigned long long get_counter(int counter) const {
+        unsigned long long value = 0;
+
+        for (int index = 0; index < PIPELINE_STATS_SLOTS; ++index) {
+            value += slots[index].counters[counter].load(std::memory_order_relaxed);
+        }
+
+        return value;
+    }
+
+    /**
+     * \brief Прирост счётчика за время, прошедшее после снимка.
+     *
+     * \param [in] counter Счётчик PIPELINE_COUNTER_*
+     * \param [in] since Снимок, полученный get_snapshot()
+     */
+    unsigned long long get_counter(int counter, const pipeline_stats_snapshot &since) const {
+        return get_counter(counter) - since.counters[counter];
+    }
+
+    /**
+     * \brief Снимок накопленных значений, от которого отсчитываются сводки за период.
+     *
+     * Измерения, выполняемые другими потоками во время снимка, могут попасть в него частично
+     * и будут учтены в следующей сводке.
+     *
+     * \param [out] snapshot Снимок
+     */
+    void get_snapshot(pipeline_stats_snapshot *snapshot) const {
+        for (int stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+            collect_stage(stage, &snapshot->stages[stage]);
+        }
+
+        for (int counter = 0; counter < PIPELINE_COUNTER_COUNT; ++counter) {
+            snapshot->counters[counter] = get_counter(counter);
+        }
+    }
+};
+
+#endif //SMART_ROAD_PIPELINE_STATS_HPP
@@ -0,0 +1,402 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий класс RadarManager для обслуживания нескольких радаров одним циклом событий
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_RADAR_MANAGER_HPP
+#define SMART_ROAD_RADAR_MANAGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+#include "smart_road_radar.hpp"
+
+/// Возвращаемое значение при успешной работе менеджера радаров
+#define RADAR_MANAGER_OK        0
+/// Возвращаемое значение при ошибке работы менеджера радаров
+#define RADAR_MANAGER_ERROR     1
+
+/// Количество потоков цикла событий по умолчанию
+#define RADAR_MANAGER_THREADS       1
+/// Максимальное количество событий, забираемых одним вызовом epoll_wait()
+#define RADAR_MANAGER_MAX_EVENTS    64
+/// Максимальное количество пакетов, читаемых с одного радара за проход цикла
+#define RADAR_MANAGER_DRAIN_LIMIT   16
+/// Интервал опроса радаров, для которых недоступно ожидание через epoll, мс
+#define RADAR_MANAGER_POLL_INTERVAL 1
+
+/**
+ * \brief Пакет целей, принятый от одного из радаров менеджера
+ *
+ * Указатели действительны только во время вызова batch_callback.
+ */
+struct radar_batch {
+    /// Идентификатор радара, возвращённый RadarManager::add_radar()
+    int radar_id;
+    /// Время декодирования пакета
+    std::chrono::steady_clock::time_point received_at;
+    /// Пакет целей
+    const target_batch *batch;
+    /// Блок облака точек или nullptr, если для радара блок не запрашивается
+    const point_cloud_block *cloud;
+};
+
+/// Функция, которой менеджер передаёт принятые пакеты целей
+typedef std::function<void(const radar_batch &)> batch_callback;
+
+/**
+ * \brief Статистика обслуживания одного радара
+ */
+struct radar_manager_statistics {
+    /// Количество переданных пакетов целей
+    unsigned long long batches_delivered;
+    /// Количество пробуждений цикла событий по готовности порта
+    unsigned long long ready_events;
+    /// Количество ошибок чтения, после которых радар перестаёт обслуживаться
+    unsigned long long read_errors;
+};
+
+/**
+ * \brief Объект, обслуживающий несколько радаров небольшим фиксированным числом потоков
+ *
+ * Радары распределяются между потоками цикла событий по кругу. На POSIX-системах каждый поток ожидает
+ * готовности портов своих радаров одним вызовом epoll_wait() и читает только уже принятые байты через
+ * SmartRoadRadar::poll_target_data(), поэтому число потоков не зависит от числа портов. Радары, канал которых
+ * не предоставляет дескриптор (воспроизведение записи, порты на Windows), опрашиваются с интервалом
+ * RADAR_MANAGER_POLL_INTERVAL.
+ *
+ * Каждый декодированный пакет целей передаётся в batch_callback вместе с идентификатором радара. Функция
+ * вызывается в потоке цикла событий и должна быстро возвращать управление, а при нескольких потоках может
+ * вызываться одновременно для разных радаров.
+ *
+ * Менеджер не владеет радарами: они должны существовать до вызова stop(). Команды радарам можно отправлять
+ * из других потоков во время работы менеджера, на время команды чтение этого радара приостанавливается.
+ * Фоновое чтение start_acquisition() с менеджером не используется.
+ *
+ * **Пример**
+ * \code
+ * SmartRoadRadar north("/dev/ttyUSB0");
+ * SmartRoadRadar south("/dev/ttyUSB1");
+ *
+ * RadarManager manager;
+ * manager.add_radar(&north);
+ * manager.add_radar(&south);
+ *
+ * manager.set_batch_callback([](const radar_batch &received) {
+ *     printf("radar %d: %d targets\n", received.radar_id, received.batch->count);
+ * });
+ *
+ * manager.start();
+ * \endcode
+ */
+class RadarManager {
+
+private:
+    /**
+     * \brief Радар и буферы, в которые декодируются его пакеты
+     */
+    struct managed_radar {
+        SmartRoadRadar *radar = nullptr;
+        int radar_id = 0;
+        bool decode_cloud = false;
+        /// Флаг ошибки чтения, после которой радар не обслуживается
+        bool failed = false;
+
+        target_batch batch{};
+        point_cloud_block cloud{};
+
+        std::atomic<unsigned long long> batches_delivered{0};
+        std::atomic<unsigned long long> ready_events{0};
+        std::atomic<unsigned long long> read_errors{0};
+    };
+
+    std::vector<std::unique_ptr<managed_radar>> radars;
+
+    size_t thread_count;
+    std::vector<std::thread> threads;
+    std::atomic<bool> running{false};
+
+    batch_callback callback;
+
+    /**
+     * \brief Чтение пакетов, уже принятых радаром.
+     *
+     * \param [in,out] slot Обслуживаемый радар
+     * \return true, если прочитано RADAR_MANAGER_DRAIN_LIMIT пакетов и в порту могут остаться данные
+     */
+    bool drain(managed_radar *slot) {
+        for (int delivered = 0; delivered < RADAR_MANAGER_DRAIN_LIMIT; ++delivered) {
+            int status = slot->radar->poll_target_data(&slot->batch, slot->decode_cloud ? &slot->cloud : nullptr);
+
+            if (status == SMART_ROAD_RADAR_ERROR) {
+                slot->failed = true;
+                slot->read_errors.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (status != SMART_ROAD_RADAR_OK) {
+                return false;
+            }
+
+            slot->batches_delivered.fetch_add(1, std::memory_order_relaxed);
+
+            if (callback) {
+                callback(radar_batch{
+                        slot->radar_id,
+                        std::chrono::steady_clock::now(),
+                        &slot->batch,
+                        slot->decode_cloud ? &slot->cloud : nullptr
+                });
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * \brief Тело потока цикла событий.
+     *
+     * \param [in] loop_index Номер потока, обслуживающего радары с номерами loop_index, loop_index + thread_count, ...
+     */
+    void event_loop(size_t loop_index) {
+        /// Радары без дескриптора, которые опрашиваются на каждом проходе
+        std::vector<managed_radar *> polled;
+        /// Радары, с которых за прошлый проход прочитаны не все данные
+        std::vector<managed_radar *> pending;
+        std::vector<managed_radar *> next_pending;
+
+#ifndef _WIN32
+        int epoll_fd = epoll_create1(0);
+        epoll_event events[RADAR_MANAGER_MAX_EVENTS];
+#endif
+
+        for (size_t pos = loop_index; pos < radars.size(); pos += thread_count) {
+            managed_radar *slot = radars[pos].get();
+
+#ifndef _WIN32
+            int descriptor = slot->radar->get_poll_descriptor();
+
+            if (epoll_fd >= 0 && descriptor >= 0) {
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLET;
+                event.data.ptr = slot;
+
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, descriptor, &event) == 0) {
+                    /// Данные, принятые до регистрации, не создадут события
+                    pending.push_back(slot);
+                    continue;
+                }
+            }
+#endif
+
+            polled.push_back(slot);
+        }
+
+        while (running.load()) {
+            /// Ожидание уже выполнено в epoll_wait() или на опрашиваемых радарах остались данные
+            bool busy = false;
+
+            next_pending.clear();
+
+#ifndef _WIN32
+            if (epoll_fd >= 0) {
+                int timeout = !pending.empty() ? 0 : polled.empty() ? SERIAL_READ_POLL_TIMEOUT : RADAR_MANAGER_POLL_INTERVAL;
+                int count = epoll_wait(epoll_fd, events, RADAR_MANAGER_MAX_EVENTS, timeout);
+
+                for (int pos = 0; pos < count; ++pos) {
+                    auto *slot = (managed_radar *) events[pos].data.ptr;
+                    slot->ready_events.fetch_add(1, std::memory_order_relaxed);
+
+                    if (!slot->failed && drain(slot)) {
+                        next_pending.push_back(slot);
+                    }
+
+                    if (slot->failed) {
+                        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, slot->radar->get_poll_descriptor(), nullptr);
+                    }
+                }
+
+                busy = true;
+            }
+#endif
+
+            /// Радар из pending мог уже быть прочитан по событию, повторный вызов drain() просто ничего не найдёт
+            for (managed_radar *slot: pending) {
+                if (!slot->failed && drain(slot)) {
+                    next_pending.push_back(slot);
+                }
+            }
+
+            for (managed_radar *slot: polled) {
+                if (!slot->failed && drain(slot)) {
+                    busy = true;
+                }
+            }
+
+            pending.swap(next_pending);
+
+            if (!busy && pending.empty()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(RADAR_MANAGER_POLL_INTERVAL));
+            }
+        }
+
+#ifndef _WIN32
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+        }
+#endif
+    }
+
+public:
+    /**
+     * \brief Конструктор менеджера.
+     *
+     * \param [in] threads_number Количество потоков цикла событий
+     */
+    explicit RadarManager(size_t threads_number = RADAR_MANAGER_THREADS)
+            : thread_count(threads_number > 0 ? threads_number : 1) {}
+
+    RadarManager(const RadarManager &) = delete;
+
+    RadarManager &operator=(const RadarManager &) = delete;
+
+    ~RadarManager() {
+        stop();
+    }
+
+    /**
+     * \brief Добавление радара.
+     *
+     * Радары добавляются до вызова start().
+     *
+     * \param [in] radar Указатель на радар
+     * \param [in] decode_cloud Передавать ли в radar_batch блок облака точек этого радара
+     * \return Идентификатор радара, который передаётся в radar_batch, или -1, если менеджер запущен
+     */
+    int add_radar(SmartRoadRadar *radar, bool decode_cloud = false) {
+        if (radar == nullptr || running.load()) {
+            return -1;
+        }
+
+        std::unique_ptr<managed_radar> slot(new managed_radar());
+
+        slot->radar = radar;
+        slot->radar_id = (int) radars.size();
+        slot->decode_cloud = decode_cloud;
+
+        radars.push_back(std::move(slot));
+
+        return radars.back()->radar_id;
+    }
+
+    /**
+     * \brief Установка функции, которой передаются принятые пакеты.
+     *
+     * Функция устанавливается до вызова start().
+     *
+     * \param [in] new_callback Функция, вызываемая в потоке цикла событий для каждого пакета целей
+     */
+    void set_batch_callback(batch_callback new_callback) {
+        if (!running.load()) {
+            callback = std::move(new_callback);
+        }
+    }
+
+    /**
+     * \brief Запуск потоков цикла событий.
+     *
+     * \return RADAR_MANAGER_OK или RADAR_MANAGER_ERROR, если менеджер уже запущен
+     */
+    int start() {
+        if (running.load()) {
+            return RADAR_MANAGER_ERROR;
+        }
+
+        for (auto &slot: radars) {
+            slot->failed = false;
+        }
+
+        running.store(true);
+
+        size_t loops = thread_count < radars.size() ? thread_count : radars.size();
+
+        for (size_t loop_index = 0; loop_index < loops; ++loop_index) {
+            threads.emplace_back(&RadarManager::event_loop, this, loop_index);
+        }
+
+        return RADAR_MANAGER_OK;
+    }
+
+    /**
+     * \brief Остановка потоков цикла событий.
+     *
+     * Возвращает управление после завершения всех потоков, не позже чем через SERIAL_READ_POLL_TIMEOUT.
+     */
+    void stop() {
+        running.store(false);
+
+        for (std::thread &thread: threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        threads.clear();
+    }
+
+    bool is_running() const {
+        return running.load();
+    }
+
+    size_t get_radar_count() const {
+        return radars.size();
+    }
+
+    /**
+     * \brief Получение радара по идентификатору.
+     *
+     * \param [in] radar_id Идентификатор, возвращённый add_radar()
+     * \return Указатель на радар или nullptr, если идентификатор неверный
+     */
+    SmartRoadRadar *get_radar(int radar_id) const {
+        if (radar_id < 0 || (size_t) radar_id >= radars.size()) {
+            return nullptr;
+        }
+
+        return radars[radar_id]->radar;
+    }
+
+    /**
+     * \brief Статистика обслуживания радара.
+     *
+     * \param [in] radar_id Идентификатор, возвращённый add_radar()
+     * \return Статистика радара или нулевая статистика, если идентификатор неверный
+     */
+    radar_manager_statistics get_statistics(int radar_id) const {
+        if (radar_id < 0 || (size_t) radar_id >= radars.size()) {
+            return radar_manager_statistics{};
+        }
+
+        const managed_radar &slot = *radars[radar_id];
+
+        return radar_manager_statistics{
+                slot.batches_delivered.load(std::memory_order_relaxed),
+                slot.ready_events.load(std::memory_order_relaxed),
+                slot.read_errors.load(std::memory_order_relaxed)
+        };
+    }
+};
+
+#endif //SMART_ROAD_RADAR_MANAGER_HPP
@@ -0,0 +1,270 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий векторизованный перевод целей из полярных координат радара в координаты дороги
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_ROAD_TRANSFORM_HPP
+#define SMART_ROAD_ROAD_TRANSFORM_HPP
+
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "target_decoder.hpp"
+
+/// Границы таблицы синусов по углу, градусы: таблица покрывает [-ROAD_TRANSFORM_MAX_ANGLE, ROAD_TRANSFORM_MAX_ANGLE]
+#define ROAD_TRANSFORM_MAX_ANGLE    180.0f
+/// Шаг таблицы синусов, равный разрешению угла в кадре радара, градусы
+#define ROAD_TRANSFORM_RESOLUTION   SCALE
+/// Количество элементов таблицы синусов
+#define ROAD_TRANSFORM_TABLE_SIZE   ((int) (2 * ROAD_TRANSFORM_MAX_ANGLE / ROAD_TRANSFORM_RESOLUTION + 1.5f))
+
+/// Перевод градусов в радианы
+#define ROAD_TRANSFORM_DEGREES_TO_RADIANS   0.017453292519943295
+
+/**
+ * \brief Калибровка установки радара
+ *
+ * Координаты дороги: ось y направлена вдоль дороги, ось x - поперёк неё вправо, начало - выбранная точка дороги.
+ */
+struct radar_calibration {
+    float x = 0;                ///< Поперечная координата точки установки радара, м
+    float y = 0;                ///< Продольная координата точки установки радара, м
+    float height = 0;           ///< Высота радара над дорогой, м. Наклонная дальность переводится в дальность по дороге.
+    float yaw = 0;              ///< Поворот оси радара относительно оси y по часовой стрелке, градусы
+    float angle_offset = 0;     ///< Поправка нуля угла радара, градусы
+};
+
+/**
+ * \brief Перевод пакета целей в координаты дороги для одного радара
+ *
+ * При установке калибровки строится таблица синусов и косинусов с шагом разрешения угла радара, в которую
+ * уже включены поворот и поправка угла, поэтому перевод цели - это выборка из таблицы, учёт высоты и сдвиг:
+ *
+ *     ground = sqrt(max(distance^2 - height^2, 0))
+ *     road_x = x + ground * sin(angle + yaw + angle_offset)
+ *     road_y = y + ground * cos(angle + yaw + angle_offset)
+ *
+ * Результат записывается в поля road_x и road_y пакета. При сборке с AVX2 цели обрабатываются блоками
+ * по восемь с выборкой из таблицы через gather, с SSE2 - по четыре, остаток - скалярным кодом.
+ *
+ * **Пример**
+ * \code
+ * radar_calibration calibration;
+ * calibration.height = 6.0f;
+ * calibration.yaw = -12.5f;
+ *
+ * RoadTransform transform(calibration);
+ *
+ * if (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+ *     transform.apply(&batch);
+ *     printf("%.2f %.2f\n", batch.road_x[0], batch.road_y[0]);
+ * }
+ * \endcode
+ */
+class RoadTransform {
+
+private:
+    radar_calibration calibration{};
+    float height_squared = 0;
+
+    std::vector<float> sin_table;
+    std::vector<float> cos_table;
+
+    /**
+     * \brief Индекс угла в таблице
+     *
+     * \param [in] angle Угол радара, градусы
+     */
+    static int get_table_index(float angle) {
+        float index = (angle + ROAD_TRANSFORM_MAX_ANGLE) * (1.0f / ROAD_TRANSFORM_RESOLUTION) + 0.5f;
+
+        if (!(index >= 0)) {
+            return 0;
+        }
+
+        if (index > (float) (ROAD_TRANSFORM_TABLE_SIZE - 1)) {
+            return ROAD_TRANSFORM_TABLE_SIZE - 1;
+        }
+
+        return (int) index;
+    }
+
+    /**
+     * \brief Скалярный перевод целей
+     *
+     * \param [in,out] batch Пакет целей
+     * \param [in] first Индекс первой цели
+     */
+    void apply_scalar(target_batch *batch, int first) const {
+        for (int pos = first; pos < batch->count; ++pos) {
+            int index = get_table_index(batch->angle[pos]);
+
+            float distance_squared = batch->distance[pos] * batch->distance[pos] - height_squared;
+            float ground = distance_squared > 0 ? std::sqrt(distance_squared) : 0.0f;
+
+            batch->road_x[pos] = calibration.x + ground * sin_table[index];
+            batch->road_y[pos] = calibration.y + ground * cos_table[index];
+        }
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    /**
+     * \brief Перевод целей блоками по четыре с помощью SSE2
+     *
+     * \param [in,out] batch Пакет целей
+     * \param [in] first Индекс первой цели
+     * \return Индекс первой цели, которая не была переведена
+     */
+    int apply_sse2(target_batch *batch, int first) const {
+        const __m128 offset = _mm_set1_ps(ROAD_TRANSFORM_MAX_ANGLE);
+        const __m128 inverse_resolution = _mm_set1_ps(1.0f / ROAD_TRANSFORM_RESOLUTION);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 last_index = _mm_set1_ps((float) (ROAD_TRANSFORM_TABLE_SIZE - 1));
+        const __m128 height = _mm_set1_ps(height_squared);
+        const __m128 origin_x = _mm_set1_ps(calibration.x);
+        const __m128 origin_y = _mm_set1_ps(calibration.y);
+
+        const float *sin_values = sin_table.data();
+        const float *cos_values = cos_table.data();
+
+        int pos = first;
+
+        for (; pos + 4 <= batch->count; pos += 4) {
+            __m128 index = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(batch->angle + pos), offset),
+                                                 inverse_resolution), half);
+
+            /// Ограничение до перевода в целые: min и max для 32-битных целых в SSE2 нет
+            index = _mm_min_ps(_mm_max_ps(index, zero), last_index);
+
+            alignas(16) int indices[4];
+            _mm_store_si128((__m128i *) indices, _mm_cvttps_epi32(index));
+
+            __m128 sin_angle = _mm_setr_ps(sin_values[indices[0]], sin_values[indices[1]],
+                                           sin_values[indices[2]], sin_values[indices[3]]);
+            __m128 cos_angle = _mm_setr_ps(cos_values[indices[0]], cos_values[indices[1]],
+                                           cos_values[indices[2]], cos_values[indices[3]]);
+
+            __m128 distance = _mm_loadu_ps(batch->distance + pos);
+            __m128 ground = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_mul_ps(distance, distance), height), zero));
+
+            _mm_storeu_ps(batch->road_x + pos, _mm_add_ps(origin_x, _mm_mul_ps(ground, sin_angle)));
+            _mm_storeu_ps(batch->road_y + pos, _mm_add_ps(origin_y, _mm_mul_ps(ground, cos_angle)));
+        }
+
+        return pos;
+    }
+#endif
+
+#if defined(__AVX2__)
+    /**
+     * \brief Перевод целей блоками по восемь с помощью AVX2
+     *
+     * \param [in,out] batch Пакет целей
+     * \param [in] first Индекс первой цели
+     * \return Индекс первой цели, которая не была переведена
+     */
+    int apply_avx2(target_batch *batch, int first) const {
+        const __m256 offset = _mm256_set1_ps(ROAD_TRANSFORM_MAX_ANGLE);
+        const __m256 inverse_resolution = _mm256_set1_ps(1.0f / ROAD_TRANSFORM_RESOLUTION);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 last_index = _mm256_set1_ps((float) (ROAD_TRANSFORM_TABLE_SIZE - 1));
+        const __m256 height = _mm256_set1_ps(height_squared);
+        const __m256 origin_x = _mm256_set1_ps(calibration.x);
+        const __m256 origin_y = _mm256_set1_ps(calibration.y);
+
+        int pos = first;
+
+        for (; pos + 8 <= batch->count; pos += 8) {
+            __m256 index = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(batch->angle + pos), offset),
+                                                       inverse_resolution), half);
+
+            __m256i indices = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(index, zero), last_index));
+
+            __m256 sin_angle = _mm256_i32gather_ps(sin_table.data(), indices, 4);
+            __m256 cos_angle = _mm256_i32gather_ps(cos_table.data(), indices, 4);
+
+            __m256 distance = _mm256_loadu_ps(batch->distance + pos);
+            __m256 ground = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_mul_ps(distance, distance), height), zero));
+
+            _mm256_storeu_ps(batch->road_x + pos, _mm256_add_ps(origin_x, _mm256_mul_ps(ground, sin_angle)));
+            _mm256_storeu_ps(batch->road_y + pos, _mm256_add_ps(origin_y, _mm256_mul_ps(ground, cos_angle)));
+        }
+
+        return pos;
+    }
+#endif
+
+public:
+    /**
+     * \brief Конструктор с калибровкой.
+     *
+     * \param [in] new_calibration Калибровка установки радара
+     */
+    explicit RoadTransform(const radar_calibration &new_calibration = radar_calibration{}) {
+        set_calibration(new_calibration);
+    }
+
+    /**
+     * \brief Установка калибровки с перестроением таблицы синусов.
+     *
+     * \param [in] new_calibration Калибровка установки радара
+     */
+    void set_calibration(const radar_calibration &new_calibration) {
+        calibration = new_calibration;
+        height_squared = calibration.height * calibration.height;
+
+        sin_table.resize(ROAD_TRANSFORM_TABLE_SIZE);
+        cos_table.resize(ROAD_TRANSFORM_TABLE_SIZE);
+
+        for (int index = 0; index < ROAD_TRANSFORM_TABLE_SIZE; ++index) {
+            double angle = (double) index * ROAD_TRANSFORM_RESOLUTION - ROAD_TRANSFORM_MAX_ANGLE +
+                           calibration.yaw + calibration.angle_offset;
+
+            sin_table[index] = (float) std::sin(angle * ROAD_TRANSFORM_DEGREES_TO_RADIANS);
+            cos_table[index] = (float) std::cos(angle * ROAD_TRANSFORM_DEGREES_TO_RADIANS);
+        }
+    }
+
+    const radar_calibration &get_calibration() const {
+        return calibration;
+    }
+
+    /**
+     * \brief Перевод всех целей пакета в координаты дороги.
+     *
+     * Заполняет road_x и road_y для первых batch->count целей и устанавливает has_road_coordinates.
+     * Углы за пределами таблицы ограничиваются её границами.
+     *
+     * \param [in,out] batch Пакет целей
+     */
+    void apply(target_batch *batch) const {
+        int pos = 0;
+
+#if defined(__AVX2__)
+        pos = apply_avx2(batch, pos);
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        pos = apply_sse2(batch, pos);
+#endif
+
+        apply_scalar(batch, pos);
+
+        batch->has_road_coordinates = true;
+    }
+};
+
+#endif //SMART_ROAD_ROAD_TRANSFORM_HPP
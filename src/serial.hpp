@@ -9,8 +9,45 @@
 #ifndef SMART_ROAD_SERIAL_HPP
 #define SMART_ROAD_SERIAL_HPP
 
-#include <windows.h>
 #include <iostream>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+/// Тип беззнакового 32-битного числа, совместимый с WinAPI
+typedef unsigned long DWORD;
+/// Тип строки с адресом устройства, совместимый с WinAPI
+typedef char *LPTSTR;
+
+/// Один стоп-бит
+#define ONESTOPBIT      0
+/// Полтора стоп-бита
+#define ONE5STOPBITS    1
+/// Два стоп-бита
+#define TWOSTOPBITS     2
+
+/// Без контроля чётности
+#define NOPARITY        0
+/// Контроль нечётности
+#define ODDPARITY       1
+/// Контроль чётности
+#define EVENPARITY      2
+/// Бит чётности всегда равен единице
+#define MARKPARITY      3
+/// Бит чётности всегда равен нулю
+#define SPACEPARITY     4
+#endif
 
 #include "utils.hpp"
 
@@ -31,8 +68,23 @@
 #define SERIAL_OK       0
 /// Возвращаемый код при невыполненной операции
 #define SERIAL_ERROR    1
+/// Возвращаемый код, если данные не пришли до истечения времени ожидания
+#define SERIAL_TIMEOUT  2
+
+/// Размер приёмного кольцевого буфера (должен быть степенью двойки)
+#define SERIAL_RX_BUFFER_SIZE   4096
+/// Маска индекса приёмного кольцевого буфера
+#define SERIAL_RX_BUFFER_MASK   (SERIAL_RX_BUFFER_SIZE - 1)
+
+/// Время ожидания первого байта при пополнении буфера, мс
+#define SERIAL_READ_POLL_TIMEOUT    50
 
-/** Структура настроек для создания подключения */
+/**
+ * Структура настроек для создания подключения
+ *
+ * Значения stop_bits и parity задаются константами WinAPI (ONESTOPBIT, NOPARITY и т.д.),
+ * на POSIX-системах они транслируются в соответствующие флаги termios.
+ */
 struct port_config {
     DWORD baud_rate;    ///<Скорость передачи данных
     DWORD byte_size;    ///<Размер байта
@@ -40,16 +92,664 @@ struct port_config {
     DWORD parity;       ///<Бит чётности
 };
 
+/**
+ * Структура таймаутов чтения
+ *
+ * Значения задаются в миллисекундах, ноль означает отсутствие ограничения.
+ */
+struct serial_timeouts {
+    DWORD inter_byte_timeout = 0;   ///< Максимальный интервал между поступлением байт
+    DWORD total_timeout = 0;        ///< Максимальное время одной операции чтения
+};
+
+/** Счётчики операций ввода-вывода последовательного порта */
+struct serial_statistics {
+    unsigned long long read_calls = 0;      ///< Количество системных вызовов чтения
+    unsigned long long bytes_received = 0;  ///< Количество принятых байт
+    unsigned long long write_calls = 0;     ///< Количество системных вызовов записи
+    unsigned long long bytes_sent = 0;      ///< Количество отправленных байт
+};
+
+/**
+ * \brief Интерфейс канала обмена байтами с радаром
+ *
+ * SmartRoadRadar читает и отправляет кадры только через этот интерфейс, поэтому вместо последовательного
+ * порта можно подставить другой источник байт (например, воспроизведение записи или канал в памяти).
+ * Назначение функций совпадает с одноимёнными функциями Serial.
+ */
+class Transport {
+
+public:
+    virtual ~Transport() = default;
+
+    /**
+     * \brief Доступ к принятым байтам без копирования.
+     *
+     * \param [out] chunk Указатель на начало непрерывного участка непрочитанных байт
+     * \return Размер участка. Ноль, если данных нет до истечения срока или чтение невозможно,
+     * причину можно узнать через get_read_status().
+     */
+    virtual size_t peek_u_bytes(const u_byte_t **chunk) = 0;
+
+    /**
+     * \brief Отметка байт, полученных через peek_u_bytes(), как прочитанных.
+     *
+     * \param [in] count Количество пропускаемых байт
+     */
+    virtual void skip_u_bytes(size_t count) = 0;
+
+    /**
+     * \brief Отправка массива байт.
+     *
+     * \return SERIAL_OK, если массив был передан. В противном случае - SERIAL_ERROR.
+     */
+    virtual int write_u_bytes(u_byte_t *data, size_t length) = 0;
+
+    /**
+     * \brief Проверка, готов ли канал к обмену.
+     */
+    virtual bool is_open() const = 0;
+
+    /**
+     * \brief Прерывание ожидания данных, может вызываться из другого потока.
+     */
+    virtual void cancel_reads() = 0;
+
+    /**
+     * \brief Разрешение операций чтения после cancel_reads().
+     */
+    virtual void resume_reads() = 0;
+
+    /**
+     * \brief Ограничение времени ожидания данных.
+     *
+     * \param [in] deadline Момент времени, после которого ожидание данных прекращается
+     */
+    virtual void set_read_deadline(std::chrono::steady_clock::time_point deadline) = 0;
+
+    /**
+     * \brief Снятие ограничения времени ожидания данных.
+     */
+    virtual void clear_read_deadline() = 0;
+
+    /**
+     * \brief Установка таймаутов чтения.
+     */
+    virtual void set_timeouts(const serial_timeouts &new_timeouts) = 0;
+
+    /**
+     * \brief Дескриптор, готовность которого к чтению можно ожидать через epoll.
+     *
+     * \return Дескриптор или -1, если канал не поддерживает ожидание через epoll и должен опрашиваться.
+     */
+    virtual int get_poll_descriptor() const {
+        return -1;
+    }
+
+    /**
+     * \brief Результат последней операции чтения: SERIAL_OK, SERIAL_TIMEOUT или SERIAL_ERROR.
+     */
+    virtual int get_read_status() const = 0;
+
+    /**
+     * \brief Получение счётчиков операций ввода-вывода.
+     */
+    virtual serial_statistics get_statistics() const = 0;
+
+    /**
+     * \brief Сброс счётчиков операций ввода-вывода.
+     */
+    virtual void reset_statistics() = 0;
+};
+
 /**
  * \brief Объект для общения с устройствами по последовательному интерфейсу
  *
  * Объект содержит в себе конструкторы для инициализации подключения и функции для отправки и чтения
- * данных типа byte_t и u_byte_t
+ * данных типа byte_t и u_byte_t.
+ *
+ * Принятые данные накапливаются в кольцевом буфере, который пополняется чтением всех доступных
+ * в порту байт за один системный вызов. Функции read_byte(), read_u_byte(), read_bytes() и read_u_bytes()
+ * обслуживаются из этого буфера.
+ *
+ * На Windows используется WinAPI (CreateFile, DCB, ReadFile). На POSIX-системах порт открывается
+ * в неблокирующем режиме, настраивается через termios в raw-режим, а ожидание данных выполняется
+ * через epoll. В качестве адреса может быть передано имя любого терминального устройства,
+ * в том числе ведомой стороны псевдотерминала.
+ *
+ * Объект владеет дескриптором порта и закрывает его при уничтожении, поэтому может быть только перемещён.
  */
-class Serial {
+class Serial : public Transport {
 
 private:
-    HANDLE h_serial;
+#ifdef _WIN32
+    HANDLE h_serial = INVALID_HANDLE_VALUE;
+#else
+    /// Дескриптор порта
+    int port_fd = -1;
+    /// Дескриптор epoll, ожидающий готовности порта к чтению
+    int epoll_fd = -1;
+#endif
+
+    /// Приёмный кольцевой буфер
+    u_byte_t rx_buffer[SERIAL_RX_BUFFER_SIZE]{};
+    /// Счётчик прочитанных из буфера байт
+    size_t rx_head = 0;
+    /// Счётчик записанных в буфер байт
+    size_t rx_tail = 0;
+
+    /// Счётчики операций ввода-вывода
+    serial_statistics statistics{};
+
+    /// Флаг прерывания ожидания данных
+    std::atomic<bool> reads_cancelled{false};
+
+    /// Момент времени, после которого ожидание данных прекращается
+    std::chrono::steady_clock::time_point read_deadline = std::chrono::steady_clock::time_point::max();
+
+    /// Таймауты чтения
+    serial_timeouts timeouts{};
+    /// Результат последнего пополнения приёмного буфера
+    int last_read_status = SERIAL_OK;
+
+#ifdef _WIN32
+    /**
+     * \brief Открытие и настройка порта.
+     *
+     * \param [in] address Адрес устройства
+     * \param [in] config Настройки подключения
+     */
+    void open_port(LPTSTR address, port_config config) {
+        h_serial = ::CreateFile(
+                address,
+                GENERIC_READ | GENERIC_WRITE,
+                0,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+
+        if (h_serial == INVALID_HANDLE_VALUE) {
+            printf("Can't open port %s\n", address);
+            return;
+        }
+
+        DCB dcbSerialParameters = {0};
+
+        dcbSerialParameters.DCBlength = sizeof dcbSerialParameters;
+        dcbSerialParameters.BaudRate =  config.baud_rate;
+        dcbSerialParameters.ByteSize =  config.byte_size;
+        dcbSerialParameters.StopBits =  config.stop_bits;
+        dcbSerialParameters.Parity =    config.parity;
+
+        SetCommState(h_serial, &dcbSerialParameters);
+
+        set_read_timeouts(SERIAL_READ_POLL_TIMEOUT);
+    }
+
+    /**
+     * \brief Закрытие порта.
+     */
+    void close_port() {
+        if (h_serial != INVALID_HANDLE_VALUE) {
+            CloseHandle(h_serial);
+            h_serial = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    /**
+     * \brief Передача владения портом от другого объекта.
+     *
+     * \param [in,out] other Объект, у которого забирается порт
+     */
+    void take_port(Serial &other) {
+        h_serial = other.h_serial;
+        other.h_serial = INVALID_HANDLE_VALUE;
+    }
+
+    /**
+     * \brief Настройка таймаутов чтения.
+     *
+     * ReadFile возвращает управление сразу, как только в порту есть хотя бы один байт, забирая все
+     * доступные байты. Если данных нет, то ожидание длится не дольше wait_timeout.
+     *
+     * \param [in] wait_timeout Время ожидания первого байта, мс
+     */
+    void set_read_timeouts(DWORD wait_timeout) {
+        COMMTIMEOUTS comm_timeouts = {0};
+
+        comm_timeouts.ReadIntervalTimeout =          MAXDWORD;
+        comm_timeouts.ReadTotalTimeoutMultiplier =   MAXDWORD;
+        comm_timeouts.ReadTotalTimeoutConstant =     wait_timeout;
+
+        SetCommTimeouts(h_serial, &comm_timeouts);
+    }
+
+    /**
+     * \brief Один системный вызов чтения.
+     *
+     * Время ожидания задаётся через COMMTIMEOUTS в set_read_timeouts(), поэтому параметр wait_timeout
+     * учитывается только при нулевом значении: тогда читаются лишь байты, уже находящиеся в очереди драйвера.
+     *
+     * \param [out] buffer Буфер для принятых байт
+     * \param [in] length Максимальное количество байт
+     * \param [out] received Количество принятых байт
+     * \param [in] wait_timeout Время ожидания данных, мс
+     * \return Возвращает SERIAL_OK, если вызов завершился без ошибки. В противном случае - SERIAL_ERROR.
+     */
+    int read_raw(u_byte_t *buffer, size_t length, size_t *received, int wait_timeout) {
+        DWORD size = 0;
+
+        if (wait_timeout == 0) {
+            DWORD errors = 0;
+            COMSTAT status{};
+
+            if (!ClearCommError(h_serial, &errors, &status)) {
+                return SERIAL_ERROR;
+            }
+
+            if (status.cbInQue == 0) {
+                *received = 0;
+                return SERIAL_OK;
+            }
+
+            if (length > status.cbInQue) {
+                length = status.cbInQue;
+            }
+        }
+
+        BOOL result = ReadFile(
+                h_serial,
+                buffer,
+                (DWORD) length,
+                &size,
+                nullptr);
+
+        ++statistics.read_calls;
+        statistics.bytes_received += size;
+
+        *received = size;
+
+        return result ? SERIAL_OK : SERIAL_ERROR;
+    }
+
+    /**
+     * \brief Один системный вызов записи.
+     *
+     * \param [in] data Отправляемые байты
+     * \param [in] length Количество отправляемых байт
+     * \return Возвращает SERIAL_OK, если были отправлены все байты. В противном случае - SERIAL_ERROR.
+     */
+    int write_raw(const void *data, size_t length) {
+        DWORD dw_bytes_written = 0;
+
+        WriteFile(
+                h_serial,
+                data,
+                (DWORD) length,
+                &dw_bytes_written,
+                nullptr);
+
+        ++statistics.write_calls;
+        statistics.bytes_sent += dw_bytes_written;
+
+        if (length == dw_bytes_written) {
+            return SERIAL_OK;
+        } else {
+            return SERIAL_ERROR;
+        }
+    }
+#else
+    /**
+     * \brief Перевод скорости передачи данных в константу termios.
+     *
+     * \param [in] baud_rate Скорость передачи данных
+     * \return Константа вида B115200. Для неподдерживаемой скорости возвращается B0.
+     */
+    static speed_t to_speed(DWORD baud_rate) {
+        switch (baud_rate) {
+            case 1200:      return B1200;
+            case 2400:      return B2400;
+            case 4800:      return B4800;
+            case 9600:      return B9600;
+            case 19200:     return B19200;
+            case 38400:     return B38400;
+            case 57600:     return B57600;
+            case 115200:    return B115200;
+            case 230400:    return B230400;
+#ifdef B460800
+            case 460800:    return B460800;
+#endif
+#ifdef B921600
+            case 921600:    return B921600;
+#endif
+            default:        return B0;
+        }
+    }
+
+    /**
+     * \brief Открытие и настройка порта.
+     *
+     * Порт переводится в raw-режим: без эха, без канонической обработки строк и без преобразования
+     * символов. Размер байта, количество стоп-битов и чётность берутся из port_config.
+     *
+     * \param [in] address Адрес устройства
+     * \param [in] config Настройки подключения
+     */
+    void open_port(LPTSTR address, port_config config) {
+        port_fd = ::open(address, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+        if (port_fd < 0) {
+            printf("Can't open port %s\n", address);
+            return;
+        }
+
+        termios tty{};
+
+        if (tcgetattr(port_fd, &tty) == 0) {
+            cfmakeraw(&tty);
+
+            speed_t speed = to_speed(config.baud_rate);
+
+            if (speed == B0) {
+                printf("Unsupported baud rate %lu, using %d\n", config.baud_rate, DEFAULT_BAUD_RATE);
+                speed = B115200;
+            }
+
+            cfsetispeed(&tty, speed);
+            cfsetospeed(&tty, speed);
+
+            tty.c_cflag &= ~(CSIZE | CSTOPB | PARENB | PARODD);
+            tty.c_cflag |= CLOCAL | CREAD;
+
+            switch (config.byte_size) {
+                case 5:     tty.c_cflag |= CS5; break;
+                case 6:     tty.c_cflag |= CS6; break;
+                case 7:     tty.c_cflag |= CS7; break;
+                default:    tty.c_cflag |= CS8; break;
+            }
+
+            if (config.stop_bits == TWOSTOPBITS || config.stop_bits == ONE5STOPBITS) {
+                tty.c_cflag |= CSTOPB;
+            }
+
+            switch (config.parity) {
+                case ODDPARITY:
+                    tty.c_cflag |= PARENB | PARODD;
+                    break;
+                case EVENPARITY:
+                    tty.c_cflag |= PARENB;
+                    break;
+#ifdef CMSPAR
+                case MARKPARITY:
+                    tty.c_cflag |= PARENB | PARODD | CMSPAR;
+                    break;
+                case SPACEPARITY:
+                    tty.c_cflag |= PARENB | CMSPAR;
+                    break;
+#endif
+                default:
+                    break;
+            }
+
+            /// При VMIN = 0 пустой порт возвращает ноль байт, как и отключённый. При VMIN = 1 в неблокирующем
+            /// режиме отсутствие данных возвращается как EAGAIN, а ноль означает отключение устройства.
+            tty.c_cc[VMIN] = 1;
+            tty.c_cc[VTIME] = 0;
+
+            tcsetattr(port_fd, TCSANOW, &tty);
+            tcflush(port_fd, TCIFLUSH);
+        }
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (epoll_fd >= 0) {
+            epoll_event event{};
+
+            event.events = EPOLLIN;
+            event.data.fd = port_fd;
+
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, port_fd, &event);
+        }
+    }
+
+    /**
+     * \brief Закрытие порта.
+     */
+    void close_port() {
+        if (epoll_fd >= 0) {
+            ::close(epoll_fd);
+            epoll_fd = -1;
+        }
+
+        if (port_fd >= 0) {
+            ::close(port_fd);
+            port_fd = -1;
+        }
+    }
+
+    /**
+     * \brief Передача владения портом от другого объекта.
+     *
+     * \param [in,out] other Объект, у которого забирается порт
+     */
+    void take_port(Serial &other) {
+        port_fd = other.port_fd;
+        epoll_fd = other.epoll_fd;
+
+        other.port_fd = -1;
+        other.epoll_fd = -1;
+    }
+
+    /**
+     * \brief Один системный вызов чтения.
+     *
+     * Если данных в порту нет, то ожидает их появления через epoll не дольше wait_timeout
+     * и повторяет чтение.
+     *
+     * Порт открыт в неблокирующем режиме, поэтому при отсутствии данных read() возвращает EAGAIN, а ноль
+     * означает, что устройство отключено. Отключение, как и EPOLLHUP или EPOLLERR, считается ошибкой,
+     * иначе ожидание данных от отключённого устройства превращается в цикл без пауз.
+     *
+     * \param [out] buffer Буфер для принятых байт
+     * \param [in] length Максимальное количество байт, больше нуля
+     * \param [out] received Количество принятых байт
+     * \param [in] wait_timeout Время ожидания данных, мс
+     * \return Возвращает SERIAL_OK, если вызов завершился без ошибки. В противном случае - SERIAL_ERROR.
+     */
+    int read_raw(u_byte_t *buffer, size_t length, size_t *received, int wait_timeout) {
+        *received = 0;
+
+        if (port_fd < 0) {
+            return SERIAL_ERROR;
+        }
+
+        ssize_t size = ::read(port_fd, buffer, length);
+        ++statistics.read_calls;
+
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            if (wait_timeout == 0) {
+                return SERIAL_OK;
+            }
+
+            epoll_event event{};
+
+            if (epoll_wait(epoll_fd, &event, 1, wait_timeout) <= 0) {
+                return SERIAL_OK;
+            }
+
+            if ((event.events & (EPOLLHUP | EPOLLERR)) && !(event.events & EPOLLIN)) {
+                return SERIAL_ERROR;
+            }
+
+            size = ::read(port_fd, buffer, length);
+            ++statistics.read_calls;
+
+            if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                return SERIAL_OK;
+            }
+        }
+
+        if (size <= 0) {
+            return SERIAL_ERROR;
+        }
+
+        statistics.bytes_received += size;
+        *received = size;
+
+        return SERIAL_OK;
+    }
+
+    /**
+     * \brief Запись массива байт в неблокирующий порт.
+     *
+     * Если буфер передачи драйвера заполнен, то ожидает готовности порта к записи.
+     *
+     * \param [in] data Отправляемые байты
+     * \param [in] length Количество отправляемых байт
+     * \return Возвращает SERIAL_OK, если были отправлены все байты. В противном случае - SERIAL_ERROR.
+     */
+    int write_raw(const void *data, size_t length) {
+        const u_byte_t *bytes = (const u_byte_t *) data;
+        size_t written = 0;
+
+        if (port_fd < 0) {
+            return SERIAL_ERROR;
+        }
+
+        while (written < length) {
+            ssize_t size = ::write(port_fd, bytes + written, length - written);
+            ++statistics.write_calls;
+
+            if (size > 0) {
+                written += size;
+                statistics.bytes_sent += size;
+            } else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                pollfd descriptor{port_fd, POLLOUT, 0};
+
+                if (poll(&descriptor, 1, SERIAL_READ_POLL_TIMEOUT) < 0 && errno != EINTR) {
+                    return SERIAL_ERROR;
+                }
+            } else {
+                return SERIAL_ERROR;
+            }
+        }
+
+        return SERIAL_OK;
+    }
+#endif
+
+    /**
+     * \brief Пополнение приёмного буфера.
+     *
+     * Дочитывает в свободную непрерывную часть кольцевого буфера все байты, доступные в порту.
+     * Ожидает, пока не будет принят хотя бы один байт, не будет вызвана cancel_reads()
+     * или не наступит более ранний из сроков deadline и заданного set_read_deadline(). Если срок уже
+     * истёк, то без ожидания забираются байты, которые уже есть в порту.
+     * Результат сохраняется в last_read_status.
+     *
+     * \param [in] deadline Срок текущей операции чтения
+     * \return Количество байт, добавленных в буфер. Ноль, если чтение из порта невозможно или срок истёк.
+     */
+    size_t fill_rx_buffer(std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) {
+        if (rx_head == rx_tail) {
+            rx_head = 0;
+            rx_tail = 0;
+        }
+
+        size_t start = rx_tail & SERIAL_RX_BUFFER_MASK;
+        size_t free_space = SERIAL_RX_BUFFER_SIZE - (rx_tail - rx_head);
+        size_t span = SERIAL_RX_BUFFER_SIZE - start;
+
+        if (span > free_space) {
+            span = free_space;
+        }
+
+        if (read_deadline < deadline) {
+            deadline = read_deadline;
+        }
+
+        size_t received = 0;
+
+        while (received == 0) {
+            if (reads_cancelled.load(std::memory_order_relaxed)) {
+                last_read_status = SERIAL_ERROR;
+                return 0;
+            }
+
+            int wait_timeout = get_wait_timeout(deadline);
+
+            /// Срок истёк: забираются только байты, уже принятые портом, без ожидания
+            if (wait_timeout == 0) {
+                if (read_raw(rx_buffer + start, span, &received, 0) != SERIAL_OK) {
+                    last_read_status = SERIAL_ERROR;
+                    return 0;
+                }
+
+                if (received == 0) {
+                    last_read_status = SERIAL_TIMEOUT;
+                    return 0;
+                }
+
+                break;
+            }
+
+            if (read_raw(rx_buffer + start, span, &received, wait_timeout) != SERIAL_OK) {
+                last_read_status = SERIAL_ERROR;
+                return 0;
+            }
+        }
+
+        rx_tail += received;
+        last_read_status = SERIAL_OK;
+
+        return received;
+    }
+
+    /**
+     * \brief Время ожидания данных в одном системном вызове.
+     *
+     * \param [in] deadline Срок операции чтения
+     * \return Не больше SERIAL_READ_POLL_TIMEOUT и не больше времени до срока, округлённого вверх. Ноль, если срок истёк.
+     */
+    static int get_wait_timeout(std::chrono::steady_clock::time_point deadline) {
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            return SERIAL_READ_POLL_TIMEOUT;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+
+        /// Сравнение до вычитания: разность с time_point::min() переполняется
+        if (deadline <= now) {
+            return 0;
+        }
+
+        auto remaining = deadline - now;
+
+        auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count() + 1;
+
+        return remaining_ms < SERIAL_READ_POLL_TIMEOUT ? (int) remaining_ms : SERIAL_READ_POLL_TIMEOUT;
+    }
+
+    /**
+     * \brief Срок операции чтения с учётом таймаута.
+     *
+     * \param [in] timeout Таймаут, мс. Ноль означает отсутствие ограничения.
+     */
+    static std::chrono::steady_clock::time_point get_timeout_deadline(DWORD timeout) {
+        if (timeout == 0) {
+            return std::chrono::steady_clock::time_point::max();
+        }
+
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    }
+
+    /**
+     * \brief Количество байт, находящихся в приёмном буфере.
+     */
+    size_t rx_available() const {
+        return rx_tail - rx_head;
+    }
 
 public:
     /** \brief Стандартный конструктор
@@ -78,29 +778,14 @@ public:
      * \endcode
      */
     explicit Serial(LPTSTR address) {
-        h_serial = ::CreateFile(
-                address,
-                GENERIC_READ | GENERIC_WRITE,
-                0,
-                nullptr,
-                OPEN_EXISTING,
-                FILE_ATTRIBUTE_NORMAL,
-                nullptr);
+        port_config config{};
 
-        if (h_serial == INVALID_HANDLE_VALUE) {
-            printf("Can't open port %s\n", address);
-            return;
-        }
-
-        DCB dcbSerialParameters = {0};
+        config.baud_rate = DEFAULT_BAUD_RATE;
+        config.byte_size = BYTE_SIZE;
+        config.stop_bits = ONESTOPBIT;
+        config.parity = NOPARITY;
 
-        dcbSerialParameters.DCBlength = sizeof dcbSerialParameters;
-        dcbSerialParameters.BaudRate =  DEFAULT_BAUD_RATE;
-        dcbSerialParameters.ByteSize =  BYTE_SIZE;
-        dcbSerialParameters.StopBits =  ONESTOPBIT;
-        dcbSerialParameters.Parity =    NOPARITY;
-
-        SetCommState(h_serial, &dcbSerialParameters);
+        open_port(address, config);
     }
 
     /**
@@ -124,29 +809,61 @@ public:
      * \endcode
      */
     Serial(LPTSTR address, port_config config) {
-        h_serial = ::CreateFile(
-                address,
-                GENERIC_READ | GENERIC_WRITE,
-                0,
-                nullptr,
-                OPEN_EXISTING,
-                FILE_ATTRIBUTE_NORMAL,
-                nullptr);
+        open_port(address, config);
+    }
 
-        if (h_serial == INVALID_HANDLE_VALUE) {
-            printf("Can't open port %s\n", address);
-            return;
-        }
+    Serial(const Serial &) = delete;
+    Serial &operator=(const Serial &) = delete;
 
-        DCB dcbSerialParameters = {0};
+    /**
+     * \brief Конструктор перемещения.
+     *
+     * Забирает у другого объекта открытый порт и непрочитанные данные приёмного буфера.
+     *
+     * \param [in,out] other Перемещаемый объект
+     */
+    Serial(Serial &&other) noexcept {
+        *this = std::move(other);
+    }
 
-        dcbSerialParameters.DCBlength = sizeof dcbSerialParameters;
-        dcbSerialParameters.BaudRate =  config.baud_rate;
-        dcbSerialParameters.ByteSize =  config.byte_size;
-        dcbSerialParameters.StopBits =  config.stop_bits;
-        dcbSerialParameters.Parity =    config.parity;
+    /**
+     * \brief Оператор перемещения.
+     *
+     * Закрывает текущий порт и забирает у другого объекта открытый порт, непрочитанные данные
+     * приёмного буфера, срок чтения и флаг прерывания ожидания.
+     *
+     * \param [in,out] other Перемещаемый объект
+     * \return Ссылка на текущий объект
+     */
+    Serial &operator=(Serial &&other) noexcept {
+        if (this != &other) {
+            close_port();
+            take_port(other);
 
-        SetCommState(h_serial, &dcbSerialParameters);
+            memcpy(rx_buffer, other.rx_buffer, SERIAL_RX_BUFFER_SIZE);
+            rx_head = other.rx_head;
+            rx_tail = other.rx_tail;
+            statistics = other.statistics;
+            timeouts = other.timeouts;
+            reads_cancelled.store(other.reads_cancelled.load());
+            read_deadline = other.read_deadline;
+            last_read_status = other.last_read_status;
+
+            other.rx_head = 0;
+            other.rx_tail = 0;
+            other.reads_cancelled.store(false);
+            other.read_deadline = std::chrono::steady_clock::time_point::max();
+            other.last_read_status = SERIAL_OK;
+        }
+
+        return *this;
+    }
+
+    /**
+     * \brief Деструктор, закрывающий порт.
+     */
+    ~Serial() override {
+        close_port();
     }
 
     /**
@@ -158,21 +875,7 @@ public:
      * \return Возвращает SERIAL_OK, если байт был успешно передан. В противнм случае - SERIAL_ERROR.
      */
     int write_byte(byte_t data) {
-        DWORD dw_size = 1;
-        DWORD dw_bytes_written;
-
-        WriteFile(
-                h_serial,
-                &data,
-                dw_size,
-                &dw_bytes_written,
-                nullptr);
-
-        if (dw_size == dw_bytes_written) {
-            return SERIAL_OK;
-        } else {
-            return SERIAL_ERROR;
-        }
+        return write_raw(&data, 1);
     }
 
     /**
@@ -185,20 +888,7 @@ public:
      * \return Возвращает SERIAL_OK, если массив был успешно передан. В противнм случае - SERIAL_ERROR.
      */
     int write_bytes(byte_t *data, size_t length) {
-        DWORD dw_bytes_written;
-
-        WriteFile(
-                h_serial,
-                data,
-                length,
-                &dw_bytes_written,
-                nullptr);
-
-        if (length == dw_bytes_written) {
-            return SERIAL_OK;
-        } else {
-            return SERIAL_ERROR;
-        }
+        return write_raw(data, length);
     }
 
     /**
@@ -210,21 +900,7 @@ public:
      * \return Возвращает SERIAL_OK, если байт был успешно передан. В противнм случае - SERIAL_ERROR.
      */
     int write_u_byte(u_byte_t data) {
-        DWORD dw_size = 1;
-        DWORD dw_bytes_written;
-
-        WriteFile(
-                h_serial,
-                &data,
-                dw_size,
-                &dw_bytes_written,
-                nullptr);
-
-        if (dw_size == dw_bytes_written) {
-            return SERIAL_OK;
-        } else {
-            return SERIAL_ERROR;
-        }
+        return write_raw(&data, 1);
     }
 
     /**
@@ -236,21 +912,8 @@ public:
      * \param [in] length Размер отправляемого массива
      * \return Возвращает SERIAL_OK, если массив был успешно передан. В противнм случае - SERIAL_ERROR.
      */
-    int write_u_bytes(u_byte_t *data, size_t length) {
-        DWORD dw_bytes_written;
-
-        WriteFile(
-                h_serial,
-                data,
-                length,
-                &dw_bytes_written,
-                nullptr);
-
-        if (length == dw_bytes_written) {
-            return SERIAL_OK;
-        } else {
-            return SERIAL_ERROR;
-        }
+    int write_u_bytes(u_byte_t *data, size_t length) override {
+        return write_raw(data, length);
     }
 
     /**
@@ -261,19 +924,7 @@ public:
      * \return Возвращает байт типа byte_t.
      */
     byte_t read_byte() {
-        DWORD size;
-        byte_t received_byte;
-
-        ReadFile(
-                h_serial,
-                &received_byte,
-                1,
-                &size,
-                nullptr);
-
-        if (size > 0) {
-            return received_byte;
-        }
+        return (byte_t) read_u_byte();
     }
 
     /**
@@ -285,33 +936,26 @@ public:
      * \param [in] buffer_length Размер буфера
      */
     void read_bytes(byte_t *buffer, size_t buffer_length) {
-        byte_t received_byte;
-
-        for (size_t pos = 0; pos < buffer_length; ++pos) {
-            received_byte = read_byte();
-            buffer[pos] = received_byte;
-        }
+        read_u_bytes((u_byte_t *) buffer, buffer_length);
     }
 
     /**
      * \brief Чтение одного байта.
      *
-     * Считывает один байт типа u_byte_t, отправленный устройством.
+     * Считывает один байт типа u_byte_t, отправленный устройством. Ожидание ограничено
+     * total_timeout, результат можно узнать через get_read_status().
      *
      * \return Возвращает байт типа u_byte_t.
      */
     u_byte_t read_u_byte() {
-        DWORD size;
-        u_byte_t received_byte = 0x00;
-
-        ReadFile(
-                h_serial,
-                &received_byte,
-                1,
-                &size,
-                nullptr);
+        if (rx_available() > 0) {
+            last_read_status = SERIAL_OK;
+        } else if (fill_rx_buffer(get_timeout_deadline(timeouts.total_timeout)) == 0) {
+            return 0x00;
+        }
 
-        //printf("%02X ", received_byte);
+        u_byte_t received_byte = rx_buffer[rx_head & SERIAL_RX_BUFFER_MASK];
+        ++rx_head;
 
         return received_byte;
     }
@@ -319,19 +963,261 @@ public:
     /**
      * \brief Чтение массива байтов.
      *
-     * Считывает массив байтов типа u_byte_t, отправленный устройством.
+     * Считывает массив байтов типа u_byte_t, отправленный устройством. Байты копируются из приёмного
+     * буфера непрерывными участками. Если буфер пуст, а запрошено не меньше SERIAL_RX_BUFFER_SIZE байт,
+     * то данные читаются из порта сразу в переданный буфер.
+     *
+     * Время всей операции ограничено total_timeout, а пауза между поступлением байт - inter_byte_timeout.
+     * Результат можно узнать через get_read_status().
      *
      * \param [out] buffer Указатель на буфер, в который записываются принятые байты.
      * \param [in] buffer_length Размер буфера
      */
     void read_u_bytes(u_byte_t *buffer, size_t buffer_length) {
-        u_byte_t received_byte;
+        size_t pos = 0;
+
+        auto total_deadline = get_timeout_deadline(timeouts.total_timeout);
+        last_read_status = SERIAL_OK;
+
+        while (pos < buffer_length && !reads_cancelled.load(std::memory_order_relaxed)) {
+            size_t remaining = buffer_length - pos;
+
+            if (rx_available() == 0) {
+                auto deadline = total_deadline;
+
+                /// Межбайтовый интервал отсчитывается только после первого принятого байта
+                if (pos > 0) {
+                    auto inter_byte_deadline = get_timeout_deadline(timeouts.inter_byte_timeout);
+
+                    if (inter_byte_deadline < deadline) {
+                        deadline = inter_byte_deadline;
+                    }
+                }
+
+                if (remaining >= SERIAL_RX_BUFFER_SIZE) {
+                    size_t received = 0;
+                    int wait_timeout = get_wait_timeout(read_deadline < deadline ? read_deadline : deadline);
+
+                    if (wait_timeout == 0) {
+                        last_read_status = SERIAL_TIMEOUT;
+                        break;
+                    }
+
+                    if (read_raw(buffer + pos, remaining, &received, wait_timeout) != SERIAL_OK) {
+                        last_read_status = SERIAL_ERROR;
+                        break;
+                    }
+
+                    pos += received;
+                    continue;
+                }
+
+                if (fill_rx_buffer(deadline) == 0) {
+                    break;
+                }
+            }
+
+            size_t start = rx_head & SERIAL_RX_BUFFER_MASK;
+            size_t span = SERIAL_RX_BUFFER_SIZE - start;
+
+            if (span > rx_available()) {
+                span = rx_available();
+            }
+
+            if (span > remaining) {
+                span = remaining;
+            }
+
+            memcpy(buffer + pos, rx_buffer + start, span);
+
+            rx_head += span;
+            pos += span;
+        }
+
+        /// Недополученные байты заполняются нулями, как и при неудачном побайтовом чтении
+        if (pos < buffer_length) {
+            if (last_read_status == SERIAL_OK) {
+                last_read_status = SERIAL_ERROR;
+            }
+
+            memset(buffer + pos, 0x00, buffer_length - pos);
+        }
+    }
+
+    /**
+     * \brief Доступ к принятым байтам без копирования.
+     *
+     * Возвращает непрерывный участок приёмного буфера с ещё не прочитанными байтами. Если буфер пуст,
+     * то ожидает поступления данных. Байты остаются в буфере до вызова skip_u_bytes().
+     *
+     * \warning Указатель действителен до следующего вызова функций чтения.
+     *
+     * Ожидание ограничено только сроком set_read_deadline(), так как границы операции определяет вызывающий код.
+     *
+     * \param [out] chunk Указатель на начало участка
+     * \return Размер участка. Ноль, если чтение из порта невозможно или срок истёк, причину можно узнать
+     * через get_read_status().
+     */
+    size_t peek_u_bytes(const u_byte_t **chunk) override {
+        if (rx_available() == 0 && fill_rx_buffer() == 0) {
+            *chunk = nullptr;
+            return 0;
+        }
+
+        size_t start = rx_head & SERIAL_RX_BUFFER_MASK;
+        size_t span = SERIAL_RX_BUFFER_SIZE - start;
+
+        if (span > rx_available()) {
+            span = rx_available();
+        }
+
+        *chunk = rx_buffer + start;
+
+        return span;
+    }
+
+    /**
+     * \brief Пропуск принятых байтов.
+     *
+     * Отмечает байты, полученные через peek_u_bytes(), как прочитанные.
+     *
+     * \param [in] count Количество пропускаемых байт
+     */
+    void skip_u_bytes(size_t count) override {
+        if (count > rx_available()) {
+            count = rx_available();
+        }
+
+        rx_head += count;
+    }
+
+    /**
+     * \brief Проверка, открыт ли порт.
+     */
+    bool is_open() const override {
+#ifdef _WIN32
+        return h_serial != INVALID_HANDLE_VALUE;
+#else
+        return port_fd >= 0;
+#endif
+    }
+
+    /**
+     * \brief Дескриптор порта для ожидания готовности к чтению во внешнем цикле epoll.
+     *
+     * \return Дескриптор порта на POSIX-системах. На Windows и для закрытого порта - -1.
+     */
+    int get_poll_descriptor() const override {
+#ifdef _WIN32
+        return -1;
+#else
+        return port_fd;
+#endif
+    }
+
+    /**
+     * \brief Прерывание ожидания данных.
+     *
+     * Может вызываться из другого потока. Ожидающие и последующие операции чтения завершаются
+     * не позднее чем через SERIAL_READ_POLL_TIMEOUT, как при невозможности чтения из порта,
+     * до вызова resume_reads().
+     */
+    void cancel_reads() override {
+        reads_cancelled.store(true);
+    }
+
+    /**
+     * \brief Разрешение операций чтения после cancel_reads().
+     */
+    void resume_reads() override {
+        reads_cancelled.store(false);
+    }
+
+    /**
+     * \brief Ограничение времени ожидания данных.
+     *
+     * Пока срок не снят вызовом clear_read_deadline(), операции чтения, которым не хватает данных
+     * в приёмном буфере, завершаются не позднее чем через SERIAL_READ_POLL_TIMEOUT после наступления срока.
+     *
+     * \param [in] deadline Момент времени, после которого ожидание данных прекращается
+     */
+    void set_read_deadline(std::chrono::steady_clock::time_point deadline) override {
+        read_deadline = deadline;
+    }
+
+    /**
+     * \brief Снятие ограничения времени ожидания данных.
+     */
+    void clear_read_deadline() override {
+        read_deadline = std::chrono::steady_clock::time_point::max();
+    }
+
+    /**
+     * \brief Установка таймаутов чтения.
+     *
+     * На Windows время ожидания одного вызова ReadFile (COMMTIMEOUTS) уменьшается до inter_byte_timeout,
+     * если он меньше SERIAL_READ_POLL_TIMEOUT. На POSIX-системах время ожидания epoll рассчитывается
+     * для каждого вызова.
+     *
+     * \param [in] new_timeouts Таймауты чтения
+     *
+     * **Пример**
+     * \code
+     * serial_timeouts timeouts;
+     * timeouts.inter_byte_timeout = 5;
+     * timeouts.total_timeout = 100;
+     *
+     * data_bus.set_timeouts(timeouts);
+     * \endcode
+     */
+    void set_timeouts(const serial_timeouts &new_timeouts) override {
+        timeouts = new_timeouts;
+
+#ifdef _WIN32
+        if (is_open()) {
+            DWORD wait_timeout = SERIAL_READ_POLL_TIMEOUT;
 
-        for (size_t pos = 0; pos < buffer_length; ++pos) {
-            received_byte = read_u_byte();
-            //buffer[pos] = received_byte;
-            *(buffer + pos) = received_byte;
+            if (timeouts.inter_byte_timeout > 0 && timeouts.inter_byte_timeout < wait_timeout) {
+                wait_timeout = timeouts.inter_byte_timeout;
+            }
+
+            set_read_timeouts(wait_timeout);
         }
+#endif
+    }
+
+    /**
+     * \brief Получение таймаутов чтения.
+     */
+    serial_timeouts get_timeouts() const {
+        return timeouts;
+    }
+
+    /**
+     * \brief Результат последней операции чтения.
+     *
+     * \return SERIAL_OK, если данные были получены, SERIAL_TIMEOUT, если истекло время ожидания.
+     * В противном случае - SERIAL_ERROR.
+     */
+    int get_read_status() const override {
+        return last_read_status;
+    }
+
+    /**
+     * \brief Получение счётчиков операций ввода-вывода.
+     *
+     * \return Структура с количеством системных вызовов и переданных байт с момента
+     * создания подключения или последнего вызова reset_statistics().
+     */
+    serial_statistics get_statistics() const override {
+        return statistics;
+    }
+
+    /**
+     * \brief Сброс счётчиков операций ввода-вывода.
+     */
+    void reset_statistics() override {
+        statistics = serial_statistics{};
     }
 };
 
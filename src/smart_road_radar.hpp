@@ -9,124 +9,588 @@
 #ifndef SMART_ROAD_SMART_ROAD_RADAR_HPP
 #define SMART_ROAD_SMART_ROAD_RADAR_HPP
 
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "smart_road_radar_utils.hpp"
+#include "spsc_queue.hpp"
+#include "command_executor.hpp"
+#include "frame_parser.hpp"
+#include "frame_pool.hpp"
+#include "pipeline_stats.hpp"
+#include "target_decoder.hpp"
+#include "frame_recorder.hpp"
+#include "road_transform.hpp"
+
+/// Ёмкость очереди кадров фонового чтения по умолчанию
+#define ACQUISITION_QUEUE_CAPACITY  16
 
 /**
  * \brief Объект для взаимодействия с радаром
  *
  * Объект содержит в себе конструкторы для инициализации подключения к радару, функции чтения и отправки кадров
  * в радар, также, содержит функции для отправки определённых протоколом команд.
+ *
+ * После вызова start_acquisition() кадры непрерывно читает отдельный поток и передаёт их через
+ * ограниченную lock-free очередь. В этом режиме функции чтения (в том числе get_target_data()) получают кадры
+ * из очереди, а медленный потребитель приводит к отбрасыванию кадров с увеличением счётчика переполнений
+ * вместо переполнения буфера порта. Ответы на команды поток передаёт в отдельную ячейку, поэтому команды,
+ * выполняемые во время приёма данных, не отбрасывают кадры с целями.
+ *
+ * Команды, изменяющие настройки радара, имеют асинхронные варианты с суффиксом _async, которые
+ * выполняются в отдельном потоке радара и возвращают std::future<command_result>. Срок выполнения,
+ * количество попыток и паузы между ними задаются политикой command_policy. Обмен данными с радаром
+ * защищён мьютексом, поэтому команды и чтение данных о целях из разных потоков выполняются по очереди.
+ *
+ * После вызова start_recording() каждый принятый кадр с верной контрольной суммой записывается в файл
+ * объектом FrameRecorder, запись в файл выполняет его собственный поток.
  */
 class SmartRoadRadar {
 
 private:
     /// Объект для подключения к радару по последовательному интерфейсу
     Serial data_bus{};
+    /// Канал, через который читаются и отправляются кадры, по умолчанию - data_bus
+    Transport *transport = &data_bus;
+
+    /// Потоковый парсер принимаемых кадров
+    FrameParser parser{};
+
+    /// Пул буферов для отправляемых кадров
+    FramePool frame_pool{};
+
+    /// Пакет, в который декодируются цели для get_target_data(target_data *, int)
+    target_batch decoded_targets{};
+
+    /// Количество принятых кадров
+    std::atomic<unsigned long long> frames_received{0};
+    /// Количество кадров, отброшенных из-за истечения таймаута
+    std::atomic<unsigned long long> frame_timeouts{0};
+    /// Счётчики восстановления синхронизации, которые можно читать из других потоков
+    std::atomic<unsigned long long> bytes_skipped{0};
+    std::atomic<unsigned long long> frames_recovered{0};
+    /// Значения счётчиков парсера, уже учтённые в bytes_skipped и frames_recovered
+    frame_parser_statistics reported_parser_statistics{};
+
+    /// Таймауты чтения кадров
+    read_timeouts timeouts{};
+
+    /// Задержки этапов обработки кадров и счётчики ошибок
+    PipelineStats pipeline_stats;
+
+    /// Очередь кадров, принятых потоком фонового чтения
+    std::unique_ptr<SpscQueue<acquired_frame>> acquisition_queue;
+    /// Поток фонового чтения
+    std::thread acquisition_thread;
+    /// Флаг работы потока фонового чтения
+    std::atomic<bool> acquisition_running{false};
+
+    /// Мьютекс и условная переменная для ожидания кадров потребителем
+    std::mutex acquisition_mutex;
+    std::condition_variable acquisition_signal;
+    /// Количество потребителей, ожидающих нового кадра
+    std::atomic<int> waiting_consumers{0};
+    /// Мьютекс потребителей: очередь допускает одного читателя, а кадры забирают функции чтения объекта
+    /// и внешний код через poll_frame() и wait_frame()
+    std::mutex consumer_mutex;
+    /// Флаг удержания потребителем ячейки очереди
+    bool holding_acquired_frame = false;
+
+    /// Ответ на команду, принятый потоком фонового чтения в обход очереди
+    std::unique_ptr<acquired_frame> pending_reply;
+    /// Ответ, который читает выполняемая команда
+    std::unique_ptr<acquired_frame> taken_reply;
+    /// Флаг наличия непрочитанного ответа
+    bool reply_pending = false;
+    /// Мьютекс и условная переменная для ожидания ответа на команду
+    std::mutex reply_mutex;
+    std::condition_variable reply_signal;
+
+    /// Количество кадров, переданных в очередь
+    std::atomic<unsigned long long> frames_published{0};
+    /// Количество кадров, забранных из очереди или отброшенных при её очистке
+    std::atomic<unsigned long long> frames_consumed{0};
+    /// Количество кадров, отброшенных из-за заполненной очереди
+    std::atomic<unsigned long long> frames_dropped{0};
+
+    /// Количество целей в последнем пакете
+    std::atomic<int> last_target_count{0};
+
+    /// Мьютекс, разделяющий обмен данными с радаром между потоками
+    std::recursive_mutex bus_mutex;
+    /// Политика выполнения команд по умолчанию
+    command_policy default_policy{};
+    /// Политика выполняемой команды
+    command_policy active_policy{};
+    /// Срок выполняемой асинхронной команды
+    std::chrono::steady_clock::time_point command_deadline = std::chrono::steady_clock::time_point::max();
+    /// Количество попыток, выполненных последней командой
+    int command_attempts = 0;
+
+    /// Поток асинхронного выполнения команд
+    CommandExecutor command_executor;
+
+    /// Запись принятых кадров в файл
+    FrameRecorder recorder;
+    /// Флаг записи принятых кадров
+    std::atomic<bool> recording{false};
+    /// Мьютекс, защищающий recorder от остановки записи во время добавления кадра
+    std::mutex recorder_mutex;
+    /// Идентификатор порта, с которым записываются кадры
+    u_short_t recording_port_id = 0;
+
+    /// Перевод целей в координаты дороги или nullptr, если калибровка не задана
+    std::unique_ptr<RoadTransform> road_transform;
+
+    /**
+     * \brief Тело потока фонового чтения.
+     *
+     * Читает кадры и копирует их в свободные ячейки очереди. Если очередь заполнена, то кадр
+     * отбрасывается, а очередь увеличивает счётчик переполнений.
+     */
+    void acquisition_loop() {
+        while (acquisition_running.load()) {
+            frame received_frame{};
+            int status = read_frame(&received_frame);
+
+            if (!acquisition_running.load()) {
+                break;
+            }
+
+            /// Порт недоступен, повторная попытка через интервал ожидания данных
+            if (status == SMART_ROAD_RADAR_ERROR) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(SERIAL_READ_POLL_TIMEOUT));
+                continue;
+            }
+
+            if (status != SMART_ROAD_RADAR_OK) {
+                continue;
+            }
 
+            /// Ответы на команды не занимают очередь и не вытесняют из неё кадры с целями
+            if (is_reply_word(received_frame.word)) {
+                publish_reply(received_frame);
+                continue;
+            }
+
+            acquired_frame *slot = acquisition_queue->acquire_write_slot();
+
+            if (slot == nullptr) {
+                frames_dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            int length = get_frame_data_size(received_frame);
+
+            slot->header = received_frame;
+            slot->header.data = length > 0 ? slot->payload : nullptr;
+            slot->received_at = std::chrono::steady_clock::now();
+
+            if (length > 0) {
+                memcpy(slot->payload, received_frame.data, length);
+            }
+
+            acquisition_queue->commit();
+            ++frames_published;
+
+            if (waiting_consumers.load() > 0) {
+                std::lock_guard<std::mutex> lock(acquisition_mutex);
+                acquisition_signal.notify_one();
+            }
+        }
+    }
 
     /**
-     * \brief Чтение данных с радара.
-     * Читает данные, которые отправляет радар и формирует из них кадр
+     * \brief Проверка, является ли кадр ответом на команду.
      *
-     * \return Возвращает сформированный кадр
+     * \param [in] word Командное слово кадра
      */
-    frame read_frame() {
-        frame received_frame{};
+    static bool is_reply_word(u_byte_t word) {
+        return word == CMD_READ_STATUS || word == CMD_READ_VERSION || word == CMD_READ_PARAMETERS;
+    }
+
+    /**
+     * \brief Передача ответа на команду из потока фонового чтения.
+     *
+     * Непрочитанный ответ заменяется новым.
+     *
+     * \param [in] received_frame Принятый кадр
+     */
+    void publish_reply(const frame &received_frame) {
+        int length = get_frame_data_size(received_frame);
 
-        /// Ожидание начала кадра
-        while (data_bus.read_u_byte() != HEADER_DATA_FRAME_1);
+        std::lock_guard<std::mutex> lock(reply_mutex);
 
-        /// Если следующий байт данных не равен второму байту заголовка, то кадр считается невалидным
-        if (data_bus.read_u_byte() != HEADER_DATA_FRAME_2) {
-            received_frame.is_valid = false;
-            return received_frame;
+        pending_reply->header = received_frame;
+        pending_reply->header.data = length > 0 ? pending_reply->payload : nullptr;
+        pending_reply->received_at = std::chrono::steady_clock::now();
+
+        if (length > 0) {
+            memcpy(pending_reply->payload, received_frame.data, length);
         }
 
-        /// Чтение первого байта длины данных
-        received_frame.data_length.b[0] = data_bus.read_u_byte();
-        /// Чтение второго байта длины данных
-        received_frame.data_length.b[1] = data_bus.read_u_byte();
+        reply_pending = true;
+        reply_signal.notify_one();
+    }
+
+    /**
+     * \brief Чтение следующего ответа на команду.
+     *
+     * Если работает поток фонового чтения, то ответ берётся из отдельной ячейки, в которую поток передаёт
+     * кадры CMD_READ_STATUS, CMD_READ_VERSION и CMD_READ_PARAMETERS, иначе читается из порта.
+     *
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр. Данные кадра
+     * действительны до следующего чтения ответа.
+     * \param [in] deadline Момент времени, после которого ожидание ответа прекращается
+     * \return Если кадр получен, то возвращает SMART_ROAD_RADAR_OK. Если срок истёк - SMART_ROAD_RADAR_TIMEOUT.
+     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     */
+    int next_reply(frame *received_frame, std::chrono::steady_clock::time_point deadline) {
+        if (acquisition_running.load()) {
+            std::unique_lock<std::mutex> lock(reply_mutex);
+
+            while (!reply_pending && acquisition_running.load()) {
+                auto now = std::chrono::steady_clock::now();
 
-        /// Чтение командного слова
-        received_frame.word = data_bus.read_u_byte();
+                if (now >= deadline) {
+                    *received_frame = frame{};
+                    return SMART_ROAD_RADAR_TIMEOUT;
+                }
 
-        if (received_frame.word == CMD_READ_TARGET_DATA) {
-            /// Пропуск пустого байта
-            data_bus.read_u_byte();
+                auto wake = now + std::chrono::milliseconds(SERIAL_READ_POLL_TIMEOUT);
+                reply_signal.wait_until(lock, deadline < wake ? deadline : wake);
+            }
 
-            if (received_frame.data_length.i > 1) {
-                received_frame.data = new u_byte_t[received_frame.data_length.i - 3];
+            if (reply_pending) {
+                /// Ячейки обмениваются, поэтому новый ответ не перезапишет читаемый
+                std::swap(pending_reply, taken_reply);
+                reply_pending = false;
 
-                /// Чтение данных
-                data_bus.read_u_bytes(received_frame.data, received_frame.data_length.i - 3);
+                *received_frame = taken_reply->header;
+                return SMART_ROAD_RADAR_OK;
             }
+        }
 
-            /// Пропуск пустого байта
-            data_bus.read_u_byte();
+        return read_frame(received_frame, deadline);
+    }
 
-            /// Чтение контрольной суммы
-            received_frame.checksum = data_bus.read_u_byte();
-        } else {
-            if (received_frame.data_length.i > 1) {
-                received_frame.data = new u_byte_t[received_frame.data_length.i - 1];
+    /**
+     * \brief Чтение следующего кадра.
+     *
+     * Если работает поток фонового чтения, то кадр берётся из очереди, иначе читается из порта.
+     *
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр. Данные кадра
+     * действительны до следующего чтения.
+     * \param [in] deadline Момент времени, после которого ожидание кадра прекращается
+     * \return Если кадр получен, то возвращает SMART_ROAD_RADAR_OK. Если срок истёк - SMART_ROAD_RADAR_TIMEOUT.
+     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     */
+    int next_frame(frame *received_frame,
+                   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) {
+        while (acquisition_running.load()) {
+            auto now = std::chrono::steady_clock::now();
+
+            if (now >= deadline) {
+                *received_frame = frame{};
+                return SMART_ROAD_RADAR_TIMEOUT;
+            }
+
+            auto timeout = std::chrono::milliseconds(SERIAL_READ_POLL_TIMEOUT);
 
-                /// Чтение данных
-                data_bus.read_u_bytes(received_frame.data, received_frame.data_length.i - 1);
+            if (deadline - now < timeout) {
+                timeout = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) +
+                          std::chrono::milliseconds(1);
             }
 
-            /// Чтение контрольной суммы
-            received_frame.checksum = data_bus.read_u_byte();
+            if (wait_frame(received_frame, timeout) == SMART_ROAD_RADAR_OK) {
+                return SMART_ROAD_RADAR_OK;
+            }
         }
 
-        u_byte_t calc_checksum = calculate_checksum(received_frame);
+        return read_frame(received_frame, deadline);
+    }
 
-        if (calc_checksum == received_frame.checksum) {
-            received_frame.is_valid = true;
-        } else {
-            received_frame.is_valid = false;
+    /**
+     * \brief Срок выполняемой команды.
+     *
+     * \return Срок асинхронной команды или, для синхронного вызова, текущее время плюс срок из политики
+     */
+    std::chrono::steady_clock::time_point get_command_deadline() const {
+        if (command_deadline != std::chrono::steady_clock::time_point::max()) {
+            return command_deadline;
+        }
+
+        return std::chrono::steady_clock::now() + active_policy.deadline;
+    }
+
+protected:
+    /**
+     * \brief Чтение данных с радара.
+     * Передаёт принятые байты в потоковый парсер до тех пор, пока не будет разобран кадр.
+     *
+     * Данные кадра не копируются: указатель data ссылается на приёмный буфер порта или на внутренний
+     * буфер парсера и действителен до следующего чтения.
+     *
+     * Ожидание ограничено сроком deadline и таймаутами, заданными set_read_timeouts(): после приёма первого
+     * байта кадра пауза между порциями не может превышать inter_byte_timeout, а приём всего кадра - frame_timeout.
+     * Незавершённый по таймауту кадр отбрасывается.
+     *
+     * \warning Наследники вызывают только при остановленном фоновом чтении.
+     *
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр
+     * \param [in] deadline Момент времени, после которого ожидание кадра прекращается
+     * \return Если кадр разобран, то возвращает SMART_ROAD_RADAR_OK (контрольная сумма отражена в поле is_valid).
+     * Если истёк срок или таймаут - SMART_ROAD_RADAR_TIMEOUT. Если чтение из порта невозможно - SMART_ROAD_RADAR_ERROR.
+     */
+    int read_frame(frame *received_frame,
+                   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) {
+        frame_view view{};
+
+        int result = FRAME_PARSER_NEED_MORE;
+
+        bool has_timeouts = timeouts.inter_byte_timeout > 0 || timeouts.frame_timeout > 0;
+        auto frame_deadline = std::chrono::steady_clock::time_point::max();
+
+        *received_frame = frame{};
+
+        while (result == FRAME_PARSER_NEED_MORE) {
+            const u_byte_t *chunk;
+            size_t consumed = 0;
+
+            auto wait_deadline = deadline;
+
+            /// Таймауты отсчитываются только после приёма начала кадра, паузы между кадрами не ограничиваются
+            if (!has_timeouts || parser.is_idle()) {
+                frame_deadline = std::chrono::steady_clock::time_point::max();
+            } else {
+                auto now = std::chrono::steady_clock::now();
+
+                if (timeouts.frame_timeout > 0) {
+                    if (frame_deadline == std::chrono::steady_clock::time_point::max()) {
+                        frame_deadline = now + std::chrono::milliseconds(timeouts.frame_timeout);
+                    }
+
+                    if (frame_deadline < wait_deadline) {
+                        wait_deadline = frame_deadline;
+                    }
+                }
+
+                if (timeouts.inter_byte_timeout > 0) {
+                    auto inter_byte_deadline = now + std::chrono::milliseconds(timeouts.inter_byte_timeout);
+
+                    if (inter_byte_deadline < wait_deadline) {
+                        wait_deadline = inter_byte_deadline;
+                    }
+                }
+
+                if (now >= wait_deadline) {
+                    break;
+                }
+            }
+
+            transport->set_read_deadline(wait_deadline);
+
+            auto read_start = std::chrono::steady_clock::now();
+            size_t length = transport->peek_u_bytes(&chunk);
+            auto parse_start = std::chrono::steady_clock::now();
+
+            if (length == 0) {
+                break;
+            }
+
+            /// Вызовы, дождавшиеся только срока без данных, не учитываются, чтобы простой не искажал задержку чтения
+            pipeline_stats.record(PIPELINE_STAGE_SERIAL_READ, parse_start - read_start);
+
+            result = parser.parse(chunk, length, &consumed, &view);
+            transport->skip_u_bytes(consumed);
+
+            pipeline_stats.record(PIPELINE_STAGE_FRAME_PARSE, std::chrono::steady_clock::now() - parse_start);
+        }
+
+        transport->clear_read_deadline();
+
+        if (result == FRAME_PARSER_NEED_MORE) {
+            if (transport->get_read_status() == SERIAL_ERROR) {
+                return SMART_ROAD_RADAR_ERROR;
+            }
+
+            if (!parser.is_idle()) {
+                parser.resync();
+                ++frame_timeouts;
+            }
+
+            return SMART_ROAD_RADAR_TIMEOUT;
         }
 
-        return received_frame;
+        return accept_frame(view, received_frame);
+    }
+
+private:
+    /**
+     * \brief Разбор кадра из байт, уже принятых портом, без ожидания.
+     *
+     * В отличие от read_frame() незавершённый кадр не отбрасывается: его разбор продолжится при следующем
+     * вызове, когда порт примет остальные байты. Таймауты set_read_timeouts() в этом режиме не действуют.
+     *
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр
+     * \return Если кадр разобран, то возвращает SMART_ROAD_RADAR_OK. Если принятые байты закончились раньше -
+     * SMART_ROAD_RADAR_TIMEOUT. Если чтение из порта невозможно - SMART_ROAD_RADAR_ERROR.
+     */
+    int read_available_frame(frame *received_frame) {
+        frame_view view{};
+
+        int result = FRAME_PARSER_NEED_MORE;
+
+        *received_frame = frame{};
+
+        /// Истёкший срок означает, что порт отдаёт только уже принятые байты
+        transport->set_read_deadline(std::chrono::steady_clock::time_point::min());
+
+        while (result == FRAME_PARSER_NEED_MORE) {
+            const u_byte_t *chunk;
+            size_t consumed = 0;
+
+            auto read_start = std::chrono::steady_clock::now();
+            size_t length = transport->peek_u_bytes(&chunk);
+            auto parse_start = std::chrono::steady_clock::now();
+
+            if (length == 0) {
+                break;
+            }
+
+            pipeline_stats.record(PIPELINE_STAGE_SERIAL_READ, parse_start - read_start);
+
+            result = parser.parse(chunk, length, &consumed, &view);
+            transport->skip_u_bytes(consumed);
+
+            pipeline_stats.record(PIPELINE_STAGE_FRAME_PARSE, std::chrono::steady_clock::now() - parse_start);
+        }
+
+        transport->clear_read_deadline();
+
+        if (result == FRAME_PARSER_NEED_MORE) {
+            return transport->get_read_status() == SERIAL_ERROR ? SMART_ROAD_RADAR_ERROR : SMART_ROAD_RADAR_TIMEOUT;
+        }
+
+        return accept_frame(view, received_frame);
+    }
+
+    /**
+     * \brief Учёт разобранного кадра и заполнение структуры frame.
+     *
+     * Кадр с верной контрольной суммой записывается в файл, если запись включена.
+     *
+     * \param [in] view Разобранный кадр
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр
+     * \return SMART_ROAD_RADAR_OK
+     */
+    int accept_frame(const frame_view &view, frame *received_frame) {
+        ++frames_received;
+
+        if (!view.is_valid) {
+            pipeline_stats.increment(PIPELINE_COUNTER_CHECKSUM_FAILURES);
+        }
+
+        if (view.is_valid && recording.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(recorder_mutex);
+
+            recorder.record(recording_port_id, view.word, view.payload, view.data_length, view.checksum,
+                            std::chrono::system_clock::now());
+        }
+
+        frame_parser_statistics parser_statistics = parser.get_statistics();
+
+        if (parser_statistics.bytes_skipped != reported_parser_statistics.bytes_skipped) {
+            bytes_skipped += parser_statistics.bytes_skipped - reported_parser_statistics.bytes_skipped;
+            frames_recovered += parser_statistics.frames_recovered - reported_parser_statistics.frames_recovered;
+
+            reported_parser_statistics = parser_statistics;
+        }
+
+        received_frame->is_valid = view.is_valid;
+        received_frame->data_length.i = view.data_length;
+        received_frame->word = view.word;
+        received_frame->checksum = view.checksum;
+
+        if (view.data_length > 1) {
+            received_frame->data = (u_byte_t *) view.payload;
+
+            /// В кадре с данными о целях полезная нагрузка начинается с пустого байта
+            if (view.word == CMD_READ_TARGET_DATA) {
+                received_frame->data += 1;
+            }
+        }
+
+        return SMART_ROAD_RADAR_OK;
     }
 
     /**
      * \brief Чтение данных с радара с требуемым командным словом.
      *
+     * Кадры с другими командными словами пропускаются, но не более десяти подряд. При работающем потоке
+     * фонового чтения ответы на команды ожидаются в отдельной ячейке, поэтому команда не забирает из очереди
+     * кадры с целями.
+     *
      * \param [in] expected_word Командное слово, ожидаемое в кадре
-     * \return Возвращает кадр с требуемым командным словом
+     * \param [out] received_frame Указатель на структуру, в которую записывается последний принятый кадр
+     * \param [in] deadline Момент времени, после которого ожидание кадра прекращается
+     * \return Если принят кадр с требуемым командным словом и верной контрольной суммой, то возвращает
+     * SMART_ROAD_RADAR_OK. Если срок истёк - SMART_ROAD_RADAR_TIMEOUT. В противном случае - SMART_ROAD_RADAR_ERROR.
      */
-    frame read_expected_frame(u_byte_t expected_word) {
-        frame received_frame;
+    int read_expected_frame(u_byte_t expected_word, frame *received_frame,
+                            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) {
         int attempts = 10;
 
         do {
-            received_frame = read_frame();
+            int status = is_reply_word(expected_word)
+                         ? next_reply(received_frame, deadline)
+                         : next_frame(received_frame, deadline);
+
+            /// Кадр, отброшенный по межбайтовому таймауту или таймауту кадра, не завершает ожидание до срока
+            if (status == SMART_ROAD_RADAR_TIMEOUT && std::chrono::steady_clock::now() < deadline) {
+                continue;
+            }
+
+            if (status != SMART_ROAD_RADAR_OK) {
+                return status;
+            }
+
+            if (received_frame->word != expected_word) {
+                pipeline_stats.increment(PIPELINE_COUNTER_FRAME_DISCARDS);
+            }
+
             --attempts;
-        } while (received_frame.word != expected_word && attempts > 0);
+        } while (received_frame->word != expected_word && attempts > 0);
 
-        if (received_frame.word != expected_word && attempts == 0) {
-            received_frame.is_valid = false;
+        if (received_frame->word != expected_word || !received_frame->is_valid) {
+            received_frame->is_valid = false;
+            return SMART_ROAD_RADAR_ERROR;
         }
 
-        return received_frame;
+        return SMART_ROAD_RADAR_OK;
     }
 
     /**
      * \brief Чтение статуса.
      * Функция, которая ожидает кадр с командным словом чтения статуса от радара
      *
+     * \param [in] deadline Момент времени, после которого ожидание статуса прекращается
      * \return Если от радара пришёл статус SUCCESS, то возвращается код SMART_ROAD_RADAR_OK.
-     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     * Если статус не пришёл до истечения срока - SMART_ROAD_RADAR_TIMEOUT. В противном случае - SMART_ROAD_RADAR_ERROR.
      */
-    int read_status() {
-        frame received_frame = read_expected_frame(CMD_READ_STATUS);
+    int read_status(std::chrono::steady_clock::time_point deadline) {
+        frame received_frame{};
+        int status = read_expected_frame(CMD_READ_STATUS, &received_frame, deadline);
 
-        if (received_frame.is_valid) {
-            if (received_frame.data[0] == SUCCESS) {
-                return SMART_ROAD_RADAR_OK;
-            } else {
-                return SMART_ROAD_RADAR_ERROR;
-            }
+        if (status != SMART_ROAD_RADAR_OK) {
+            return status;
+        }
+
+        if (received_frame.data_length.i > 1 && received_frame.data[0] == SUCCESS) {
+            return SMART_ROAD_RADAR_OK;
         } else {
             return SMART_ROAD_RADAR_ERROR;
         }
@@ -141,6 +605,10 @@ private:
      * \return Возвращает SERIAL_OK, если данные были успешно отправлены. В противном случае - SERIAL_ERROR
      */
     int write_frame(frame target_frame) {
+        if (target_frame.data_length.i < 1) {
+            return SERIAL_ERROR;
+        }
+
         int packet_length =
                 LENGTH_HEADER +
                 LENGTH_DATA_LENGTH +
@@ -156,79 +624,676 @@ private:
         packet[2] = target_frame.data_length.b[0];
         packet[3] = target_frame.data_length.b[1];
 
-        packet[4] = target_frame.word;
+        packet[4] = target_frame.word;
+
+        if (target_frame.data != nullptr) {
+            for (int i = 5; i < packet_length - 1; ++i) {
+                packet[i] = target_frame.data[i - 5];
+            }
+        }
+
+        packet[packet_length - 1] = target_frame.checksum;
+
+        int result = transport->write_u_bytes(packet, packet_length);
+        return result;
+    }
+
+    /**
+     * \brief Отправка команды с ожиданием подтверждения.
+     *
+     * Команда повторяется по политике active_policy, пока радар не ответит статусом SUCCESS,
+     * не закончатся попытки или не истечёт срок. Ожидание ответа на одну попытку ограничено
+     * attempt_timeout, паузы между попытками растут от backoff до max_backoff.
+     *
+     * \param [in] command Отправляемый кадр
+     * \return SMART_ROAD_RADAR_OK, если команда подтверждена. SMART_ROAD_RADAR_TIMEOUT, если последняя
+     * попытка не получила ответа. В противном случае - SMART_ROAD_RADAR_ERROR.
+     */
+    int execute_command(const frame &command) {
+        auto deadline = get_command_deadline();
+        auto backoff = active_policy.backoff;
+
+        int result = SMART_ROAD_RADAR_TIMEOUT;
+        command_attempts = 0;
+
+        while (command_attempts < active_policy.attempts) {
+            auto now = std::chrono::steady_clock::now();
+
+            if (now >= deadline) {
+                return SMART_ROAD_RADAR_TIMEOUT;
+            }
+
+            ++command_attempts;
+
+            if (write_frame(command) != SERIAL_OK) {
+                result = SMART_ROAD_RADAR_ERROR;
+            } else {
+                auto attempt_deadline = now + active_policy.attempt_timeout;
+
+                result = read_status(attempt_deadline < deadline ? attempt_deadline : deadline);
+
+                if (result == SMART_ROAD_RADAR_OK) {
+                    pipeline_stats.record(PIPELINE_STAGE_COMMAND, std::chrono::steady_clock::now() - now);
+                    return result;
+                }
+            }
+
+            if (command_attempts < active_policy.attempts) {
+                if (std::chrono::steady_clock::now() + backoff >= deadline) {
+                    return SMART_ROAD_RADAR_TIMEOUT;
+                }
+
+                std::this_thread::sleep_for(backoff);
+
+                backoff = std::chrono::duration_cast<std::chrono::milliseconds>(backoff * active_policy.backoff_multiplier);
+
+                if (backoff > active_policy.max_backoff) {
+                    backoff = active_policy.max_backoff;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * \brief Постановка команды в очередь потока асинхронного выполнения.
+     *
+     * Срок команды отсчитывается от момента постановки в очередь. Если он истёк до начала
+     * выполнения, то команда не отправляется.
+     *
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды в потоке выполнения. Может быть пустой.
+     * \param [in] command Функция, выполняющая команду
+     * \return Результат выполнения команды, который станет доступен по её завершении
+     */
+    std::future<command_result> submit_command(const command_policy &policy, command_callback callback,
+                                               std::function<int()> command) {
+        auto promise = std::make_shared<std::promise<command_result>>();
+        std::future<command_result> future = promise->get_future();
+
+        auto submitted_at = std::chrono::steady_clock::now();
+
+        command_executor.submit([this, policy, callback, command, promise, submitted_at]() {
+            command_result result{};
+            auto deadline = submitted_at + policy.deadline;
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                result.status = SMART_ROAD_RADAR_TIMEOUT;
+            } else {
+                std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+                active_policy = policy;
+                command_deadline = deadline;
+                command_attempts = 0;
+
+                result.status = command();
+                result.attempts = command_attempts;
+
+                active_policy = default_policy;
+                command_deadline = std::chrono::steady_clock::time_point::max();
+            }
+
+            result.latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - submitted_at);
+
+            if (callback) {
+                callback(result);
+            }
+
+            promise->set_value(result);
+        });
+
+        return future;
+    }
+
+    /**
+     * \brief Декодирование кадра с данными о целях.
+     *
+     * Если задана калибровка, то цели переводятся в координаты дороги.
+     *
+     * \param [in] received_frame Кадр с командным словом CMD_READ_TARGET_DATA
+     * \param [out] batch Указатель на пакет целей
+     * \param [out] cloud Указатель на блок облака точек, может быть равен nullptr
+     */
+    void decode_target_frame(const frame &received_frame, target_batch *batch, point_cloud_block *cloud) {
+        PipelineStats::Timer timer(&pipeline_stats, PIPELINE_STAGE_DECODE);
+
+        if (cloud != nullptr) {
+            if (received_frame.data_length.i - 3 >= TARGET_DATA_BYTE_OFFSET) {
+                cloud->data = received_frame.data;
+                cloud->length = TARGET_DATA_BYTE_OFFSET;
+            } else {
+                *cloud = point_cloud_block{};
+            }
+        }
+
+        decode_targets(
+                received_frame.data + TARGET_DATA_BYTE_OFFSET,
+                get_target_count(received_frame.data_length.i),
+                batch);
+
+        record_target_count(*batch);
+        apply_calibration(batch);
+    }
+
+protected:
+    /**
+     * \brief Перевод пакета в координаты дороги, если задана калибровка.
+     *
+     * Вызывается наследниками, которые формируют пакеты целей сами.
+     *
+     * \param [in,out] batch Пакет целей
+     */
+    void apply_calibration(target_batch *batch) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        if (road_transform) {
+            road_transform->apply(batch);
+        }
+    }
+
+    /**
+     * \brief Учёт количества целей в сформированном пакете для get_health().
+     *
+     * Вызывается наследниками, которые формируют пакеты целей сами.
+     *
+     * \param [in] batch Пакет целей
+     */
+    void record_target_count(const target_batch &batch) {
+        last_target_count.store(batch.count, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Замена канала обмена с радаром.
+     *
+     * Позволяет наследникам подставить вместо последовательного порта другой источник байт, при этом
+     * кадры по-прежнему разбираются read_frame() и декодируются get_target_data().
+     *
+     * \warning Канал должен существовать, пока используется радар. Вызывается до start_acquisition().
+     *
+     * \param [in] new_transport Канал обмена. Если передан nullptr, то используется последовательный порт.
+     */
+    void set_transport(Transport *new_transport) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        transport = new_transport != nullptr ? new_transport : &data_bus;
+    }
+
+public:
+    /**
+     * \brief Стандартный конструктор
+     *
+     * **Пример**
+     * \code
+     * SmartRoadRadar radar;
+     * \endcode
+     */
+    SmartRoadRadar() = default;
+
+    /**
+     * \brief Конструктор, в который передаётся порт радара.
+     *
+     * Создаётся подключение к радару со следующими параметрами:
+     * - baud_rate = 115200
+     * - byte_size = 8
+     * - stop_bits = ONESTOPBIT
+     * - parity = NOPARITY
+     *
+     * \param [in] address Адрес радара
+     *
+     * **Пример**
+     * \code
+     * SmartRoadRadar radar("COM1");
+     * \endcode
+     */
+    explicit SmartRoadRadar(LPTSTR address) {
+        port_config config{};
+
+        config.baud_rate = 115200;
+        config.byte_size = 8;
+        config.stop_bits = ONESTOPBIT;
+        config.parity = NOPARITY;
+
+        data_bus = Serial(address, config);
+    }
+
+    /**
+     * \brief Конструктор, в который передаётся порт радара и настройки подключения.
+     *
+     * Создаёт подключение к радару с параметрами, которые передаются в структуре типа port_config.
+     *
+     * \param [in] address Адрес радара
+     * \param [in] config Структура, содержащая в себе настройки для подключения
+     *
+     * **Пример**
+     * \code
+     * port_config config;
+     * config.baud_rate = BAUD_115200;
+     * config.byte_size = 8;
+     * config.stop_bits = ONESTOPBIT;
+     * config.parity = NOPARITY;
+     *
+     * SmartRoadRadar radar("COM1", config);
+     * \endcode
+     */
+    SmartRoadRadar(LPTSTR address, port_config config) {
+        data_bus = Serial(address, config);
+    }
+
+    virtual ~SmartRoadRadar() {
+        command_executor.stop();
+        stop_acquisition();
+        stop_recording();
+    }
+
+    /**
+     * \brief Установка таймаутов чтения кадров.
+     *
+     * Ограничивает паузу между байтами и время приёма одного кадра, а также время ожидания кадра
+     * с данными о целях. Функции чтения, не дождавшиеся данных, возвращают SMART_ROAD_RADAR_TIMEOUT.
+     *
+     * \param [in] new_timeouts Таймауты чтения
+     *
+     * **Пример**
+     * \code
+     * read_timeouts timeouts;
+     * timeouts.inter_byte_timeout = 5;
+     * timeouts.frame_timeout = 50;
+     * timeouts.data_timeout = 1000;
+     *
+     * radar.set_read_timeouts(timeouts);
+     *
+     * if (radar.get_target_data(&batch) == SMART_ROAD_RADAR_TIMEOUT) {
+     *     printf("Radar is silent\n");
+     * }
+     * \endcode
+     */
+    void set_read_timeouts(const read_timeouts &new_timeouts) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        timeouts = new_timeouts;
+
+        serial_timeouts bus_timeouts{};
+        bus_timeouts.inter_byte_timeout = new_timeouts.inter_byte_timeout;
+        bus_timeouts.total_timeout = new_timeouts.frame_timeout;
+
+        transport->set_timeouts(bus_timeouts);
+    }
+
+    /**
+     * \brief Получение таймаутов чтения кадров.
+     */
+    read_timeouts get_read_timeouts() {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        return timeouts;
+    }
+
+    /**
+     * \brief Установка политики выполнения синхронных команд.
+     *
+     * \param [in] policy Количество попыток, сроки и паузы между попытками
+     */
+    void set_command_policy(const command_policy &policy) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        default_policy = policy;
+        active_policy = policy;
+    }
+
+    /**
+     * \brief Получение политики выполнения синхронных команд.
+     */
+    command_policy get_command_policy() {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        return default_policy;
+    }
+
+    /**
+     * \brief Запуск потока фонового чтения.
+     *
+     * Поток непрерывно разбирает кадры и публикует их в очередь заданной ёмкости, откуда их забирают
+     * poll_frame(), wait_frame() и все функции чтения объекта.
+     *
+     * \param [in] queue_capacity Ёмкость очереди, округляется вверх до степени двойки
+     * \return Если поток запущен или уже работает, то возвращает SMART_ROAD_RADAR_OK.
+     * Если порт не открыт - SMART_ROAD_RADAR_ERROR.
+     *
+     * **Пример**
+     * \code
+     * if (radar.start_acquisition() == SMART_ROAD_RADAR_OK) {
+     *     target_batch batch;
+     *     radar.get_target_data(&batch);
+     *     radar.stop_acquisition();
+     * }
+     * \endcode
+     */
+    int start_acquisition(size_t queue_capacity = ACQUISITION_QUEUE_CAPACITY) {
+        if (acquisition_running.load()) {
+            return SMART_ROAD_RADAR_OK;
+        }
+
+        if (!transport->is_open()) {
+            return SMART_ROAD_RADAR_ERROR;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(consumer_mutex);
+
+            if (!acquisition_queue || acquisition_queue->capacity() < queue_capacity) {
+                acquisition_queue = std::make_unique<SpscQueue<acquired_frame>>(queue_capacity);
+            }
+
+            acquisition_queue->clear();
+            holding_acquired_frame = false;
+            frames_consumed.store(frames_published.load());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(reply_mutex);
+
+            if (!pending_reply) {
+                pending_reply.reset(new acquired_frame());
+                taken_reply.reset(new acquired_frame());
+            }
+
+            reply_pending = false;
+        }
+
+        transport->resume_reads();
+        acquisition_running.store(true);
+        acquisition_thread = std::thread(&SmartRoadRadar::acquisition_loop, this);
+
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    /**
+     * \brief Остановка потока фонового чтения.
+     *
+     * Ожидание данных в порту прерывается, поток завершается не позднее чем через SERIAL_READ_POLL_TIMEOUT.
+     * Непрочитанные кадры очереди отбрасываются.
+     */
+    void stop_acquisition() {
+        if (!acquisition_running.exchange(false)) {
+            return;
+        }
+
+        transport->cancel_reads();
+
+        {
+            std::lock_guard<std::mutex> lock(acquisition_mutex);
+            acquisition_signal.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(reply_mutex);
+            reply_signal.notify_all();
+        }
+
+        if (acquisition_thread.joinable()) {
+            acquisition_thread.join();
+        }
+
+        transport->resume_reads();
+
+        std::lock_guard<std::mutex> lock(consumer_mutex);
+
+        acquisition_queue->clear();
+        holding_acquired_frame = false;
+        frames_consumed.store(frames_published.load());
+    }
+
+    /**
+     * \brief Проверка, работает ли поток фонового чтения.
+     */
+    bool is_acquiring() const {
+        return acquisition_running.load();
+    }
+
+    /**
+     * \brief Получение кадра из очереди фонового чтения без ожидания.
+     *
+     * Ячейка очереди с предыдущим полученным кадром освобождается, поэтому данные кадра
+     * действительны до следующего вызова poll_frame() или wait_frame(). Потребители из разных потоков
+     * забирают кадры по очереди под общим мьютексом, но данные кадра действительны только до получения
+     * следующего кадра любым из них, поэтому кадры из очереди должен забирать один поток.
+     *
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр
+     * \return Если кадр получен, то возвращает SMART_ROAD_RADAR_OK.
+     * Если очередь пуста или поток фонового чтения не запущен - SMART_ROAD_RADAR_ERROR.
+     */
+    int poll_frame(frame *received_frame) {
+        std::lock_guard<std::mutex> lock(consumer_mutex);
+
+        if (!acquisition_queue) {
+            return SMART_ROAD_RADAR_ERROR;
+        }
+
+        if (holding_acquired_frame) {
+            acquisition_queue->release();
+            holding_acquired_frame = false;
+        }
+
+        acquired_frame *slot = acquisition_queue->acquire_read_slot();
+
+        if (slot == nullptr) {
+            return SMART_ROAD_RADAR_ERROR;
+        }
+
+        holding_acquired_frame = true;
+        *received_frame = slot->header;
+        frames_consumed.fetch_add(1, std::memory_order_relaxed);
+
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    /**
+     * \brief Ожидание кадра из очереди фонового чтения.
+     *
+     * \param [out] received_frame Указатель на структуру, в которую записывается кадр
+     * \param [in] timeout Максимальное время ожидания
+     * \return Если кадр получен, то возвращает SMART_ROAD_RADAR_OK.
+     * Если за время ожидания кадр не пришёл или поток фонового чтения остановлен - SMART_ROAD_RADAR_ERROR.
+     */
+    int wait_frame(frame *received_frame, std::chrono::milliseconds timeout) {
+        if (poll_frame(received_frame) == SMART_ROAD_RADAR_OK) {
+            return SMART_ROAD_RADAR_OK;
+        }
+
+        if (!acquisition_running.load()) {
+            return SMART_ROAD_RADAR_ERROR;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(acquisition_mutex);
+
+            ++waiting_consumers;
+            acquisition_signal.wait_for(lock, timeout, [this]() {
+                return !acquisition_queue->is_empty() || !acquisition_running.load();
+            });
+            --waiting_consumers;
+        }
+
+        return poll_frame(received_frame);
+    }
+
+    /**
+     * \brief Получение статистики фонового чтения.
+     *
+     * \return Структура с количеством опубликованных и отброшенных кадров и заполненностью очереди
+     */
+    acquisition_statistics get_acquisition_statistics() const {
+        acquisition_statistics statistics{};
+
+        statistics.frames_published = frames_published.load();
+
+        if (acquisition_queue) {
+            statistics.overruns = acquisition_queue->get_overruns();
+            statistics.queue_depth = acquisition_queue->size();
+            statistics.queue_capacity = acquisition_queue->capacity();
+            statistics.queue_high_water = acquisition_queue->get_high_water();
+        }
+
+        return statistics;
+    }
+
+    /**
+     * \brief Запуск записи принятых кадров в файл.
+     *
+     * Записываются кадры с верной контрольной суммой вместе с временем приёма и идентификатором порта.
+     * Файл читается объектом FrameRecording. Если запись уже идёт, то она завершается и начинается новая.
+     *
+     * \param [in] path Путь к файлу записи
+     * \param [in] port_id Идентификатор порта, который сохраняется с каждым кадром
+     * \return Если файл создан, то возвращает SMART_ROAD_RADAR_OK. В противном случае - SMART_ROAD_RADAR_ERROR.
+     *
+     * **Пример**
+     * \code
+     * radar.start_recording("radar.rec", 1);
+     * radar.get_target_data(&batch);
+     * radar.stop_recording();
+     * \endcode
+     */
+    int start_recording(const char *path, u_short_t port_id = 0) {
+        std::lock_guard<std::mutex> lock(recorder_mutex);
+
+        recording.store(false);
 
-        if (target_frame.data != nullptr) {
-            for (int i = 5; i < packet_length - 1; ++i) {
-                packet[i] = target_frame.data[i - 5];
-            }
+        if (recorder.open(path) != RECORDER_OK) {
+            return SMART_ROAD_RADAR_ERROR;
         }
 
-        packet[packet_length - 1] = target_frame.checksum;
+        recording_port_id = port_id;
+        recording.store(true);
 
-        int result = data_bus.write_u_bytes(packet, packet_length);
-        return result;
+        return SMART_ROAD_RADAR_OK;
     }
 
-public:
     /**
-     * \brief Стандартный конструктор
+     * \brief Завершение записи принятых кадров.
      *
-     * **Пример**
-     * \code
-     * SmartRoadRadar radar;
-     * \endcode
+     * Дожидается записи в файл всех принятых кадров и дописывает индекс.
      */
-    SmartRoadRadar() = default;
+    void stop_recording() {
+        std::lock_guard<std::mutex> lock(recorder_mutex);
+
+        recording.store(false);
+        recorder.close();
+    }
 
     /**
-     * \brief Конструктор, в который передаётся порт радара.
+     * \brief Проверка, идёт ли запись принятых кадров.
+     */
+    bool is_recording() const {
+        return recording.load();
+    }
+
+    /**
+     * \brief Получение статистики записи принятых кадров.
      *
-     * Создаётся подключение к радару со следующими параметрами:
-     * - baud_rate = 115200
-     * - byte_size = 8
-     * - stop_bits = ONESTOPBIT
-     * - parity = NOPARITY
+     * \return Структура с количеством записанных и отброшенных кадров и объёмом записанных данных
+     */
+    recorder_statistics get_recording_statistics() const {
+        return recorder.get_statistics();
+    }
+
+    /**
+     * \brief Получение статистики ввода-вывода.
      *
-     * \param [in] address Адрес радара
+     * Позволяет оценить количество системных вызовов чтения, приходящихся на один принятый кадр.
+     *
+     * \return Структура со статистикой с момента подключения или последнего вызова reset_io_statistics()
      *
      * **Пример**
      * \code
-     * SmartRoadRadar radar("COM1");
+     * io_statistics statistics = radar.get_io_statistics();
+     * printf("Read calls per frame: %f\n", statistics.read_calls_per_frame);
      * \endcode
      */
-    explicit SmartRoadRadar(LPTSTR address) {
-        port_config config{};
+    io_statistics get_io_statistics() const {
+        io_statistics statistics{};
+        serial_statistics bus_statistics = transport->get_statistics();
+
+        statistics.frames_received = frames_received.load();
+        statistics.read_calls = bus_statistics.read_calls;
+        statistics.bytes_received = bus_statistics.bytes_received;
+        statistics.frame_timeouts = frame_timeouts.load();
+        statistics.bytes_skipped = bytes_skipped.load();
+        statistics.frames_recovered = frames_recovered.load();
+
+        if (statistics.frames_received > 0) {
+            statistics.read_calls_per_frame = (float) bus_statistics.read_calls / (float) statistics.frames_received;
+        }
 
-        config.baud_rate = 115200;
-        config.byte_size = 8;
-        config.stop_bits = ONESTOPBIT;
-        config.parity = NOPARITY;
+        return statistics;
+    }
 
-        data_bus = Serial(address, config);
+    /**
+     * \brief Сброс статистики ввода-вывода.
+     */
+    void reset_io_statistics() {
+        frames_received.store(0);
+        frame_timeouts.store(0);
+        bytes_skipped.store(0);
+        frames_recovered.store(0);
+        transport->reset_statistics();
     }
 
     /**
-     * \brief Конструктор, в который передаётся порт радара и настройки подключения.
+     * \brief Получение показателей состояния радара.
      *
-     * Создаёт подключение к радару с параметрами, которые передаются в структуре типа port_config.
+     * Функция не захватывает мьютексы и не обращается к порту, поэтому её можно вызывать из другого потока
+     * во время приёма кадров, например, при экспорте метрик.
      *
-     * \param [in] address Адрес радара
-     * \param [in] config Структура, содержащая в себе настройки для подключения
+     * \return Структура со счётчиками кадров и ошибок, заполненностью очереди и количеством целей
+     */
+    radar_health get_health() const {
+        radar_health health{};
+
+        health.frames_received = frames_received.load(std::memory_order_relaxed);
+        health.checksum_failures = pipeline_stats.get_counter(PIPELINE_COUNTER_CHECKSUM_FAILURES);
+        health.frame_timeouts = frame_timeouts.load(std::memory_order_relaxed);
+        health.bytes_skipped = bytes_skipped.load(std::memory_order_relaxed);
+        health.frames_recovered = frames_recovered.load(std::memory_order_relaxed);
+        health.frames_dropped = frames_dropped.load(std::memory_order_relaxed);
+        health.target_count = last_target_count.load(std::memory_order_relaxed);
+
+        unsigned long long consumed = frames_consumed.load(std::memory_order_relaxed);
+        unsigned long long published = frames_published.load(std::memory_order_relaxed);
+
+        health.queue_depth = published > consumed ? (size_t) (published - consumed) : 0;
+
+        return health;
+    }
+
+    /**
+     * \brief Получение задержек этапов обработки кадров и счётчиков ошибок.
+     *
+     * Этапы чтения, разбора и декодирования измеряет радар, этап вывода на экран - вызывающий код.
      *
      * **Пример**
      * \code
-     * port_config config;
-     * config.baud_rate = BAUD_115200;
-     * config.byte_size = 8;
-     * config.stop_bits = ONESTOPBIT;
-     * config.parity = NOPARITY;
-     *
-     * SmartRoadRadar radar("COM1", config);
+     * pipeline_stage_summary decode = radar.get_pipeline_stats().get_summary(PIPELINE_STAGE_DECODE);
+     * printf("Decode p99: %.0f ns\n", decode.p99);
      * \endcode
      */
-    SmartRoadRadar(LPTSTR address, port_config config) {
-        data_bus = Serial(address, config);
+    PipelineStats &get_pipeline_stats() {
+        return pipeline_stats;
+    }
+
+    const PipelineStats &get_pipeline_stats() const {
+        return pipeline_stats;
+    }
+
+    /**
+     * \brief Получение статистики заполненности пула буферов отправляемых кадров.
+     *
+     * \return Структура с количеством занятых и свободных буферов
+     */
+    frame_pool_statistics get_frame_pool_statistics() const {
+        return frame_pool.get_statistics();
     }
 
     /**
@@ -253,19 +1318,22 @@ public:
      * \endcode
      */
     virtual int get_firmware_version(u_byte_t *version_buffer) {
-        frame target_frame = configure_frame(CMD_REQUEST_VERSION);
-        write_frame(target_frame);
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_REQUEST_VERSION);
+        write_frame(*target_frame);
 
-        frame received_frame = read_expected_frame(CMD_READ_VERSION);
+        frame received_frame{};
+        int status = read_expected_frame(CMD_READ_VERSION, &received_frame, get_command_deadline());
 
-        if (received_frame.is_valid) {
+        if (status == SMART_ROAD_RADAR_OK && received_frame.data_length.i > 3) {
             version_buffer[0] = received_frame.data[0];
             version_buffer[1] = received_frame.data[1];
             version_buffer[2] = received_frame.data[2];
 
             return SMART_ROAD_RADAR_OK;
         } else {
-            return SMART_ROAD_RADAR_ERROR;
+            return status == SMART_ROAD_RADAR_TIMEOUT ? SMART_ROAD_RADAR_TIMEOUT : SMART_ROAD_RADAR_ERROR;
         }
     }
 
@@ -299,6 +1367,8 @@ public:
      * \endcode
      */
     virtual int set_parameters(parameters target_parameters) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
         u_short_t length = sizeof target_parameters;
         u_byte_t data[length];
 
@@ -342,19 +1412,9 @@ public:
         data[30] = target_parameters.right_border.b[2];
         data[31] = target_parameters.right_border.b[3];
 
-        frame target_frame = configure_frame(CMD_SET_PARAMETERS, data, length);
-
-        int attempts = 10;
-        int result{};
-
-        do {
-            write_frame(target_frame);
-            result = read_status();
-
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_SET_PARAMETERS, data, length);
 
-        return result;
+        return execute_command(*target_frame);
     }
 
     /**
@@ -388,12 +1448,15 @@ public:
      * \endcode
      */
     virtual int get_parameters(parameters *received_parameters) {
-        frame target_frame = configure_frame(CMD_GET_PARAMETERS);
-        write_frame(target_frame);
-        
-        frame received_frame = read_expected_frame(CMD_READ_PARAMETERS);
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_GET_PARAMETERS);
+        write_frame(*target_frame);
         
-        if (received_frame.is_valid) {
+        frame received_frame{};
+        int status = read_expected_frame(CMD_READ_PARAMETERS, &received_frame, get_command_deadline());
+
+        if (status == SMART_ROAD_RADAR_OK && received_frame.data_length.i > 32) {
             received_parameters->min_dist.b[0] = received_frame.data[4];
             received_parameters->min_dist.b[1] = received_frame.data[5];
             received_parameters->min_dist.b[2] = received_frame.data[6];
@@ -436,7 +1499,7 @@ public:
 
             return SMART_ROAD_RADAR_OK;
         } else {
-            return SMART_ROAD_RADAR_ERROR;
+            return status == SMART_ROAD_RADAR_TIMEOUT ? SMART_ROAD_RADAR_TIMEOUT : SMART_ROAD_RADAR_ERROR;
         }
     }
 
@@ -462,28 +1525,22 @@ public:
      * \endcode
      */
     virtual int set_target_number(u_byte_t number) {
-        frame target_frame = configure_frame(CMD_SET_TARGET_NUM, number);
-
-        int attempts = 10;
-        int result{};
-
-        do {
-            write_frame(target_frame);
-            result = read_status();
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
 
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_SET_TARGET_NUM, number);
 
-        return result;
+        return execute_command(*target_frame);
     }
 
     /**
      * \brief Чтение данных о целях.
      *
      * Функция преобразует полученные кадры в структуры target_data, которые записываются
-     * в массив по переданному указателю
+     * в массив по переданному указателю. Является обёрткой над get_target_data(target_batch *),
+     * элементы массива сверх количества принятых целей обнуляются.
      *
      * \param [out] data Указатель на массив структур target_data
+     * \param [in] target_data_capacity Размер массива
      *
      * \return Если чтение кадра выполнено успешно, то возвращает SMART_ROAD_RADAR_OK.
      * В противном случае - SMART_ROAD_RADAR_ERROR.
@@ -508,43 +1565,191 @@ public:
      * \endcode
      */
     virtual int get_target_data(target_data *data, int target_data_capacity) {
-        frame received_frame;
-        
+        int result = get_target_data(&decoded_targets);
+
+        if (result != SMART_ROAD_RADAR_OK) {
+            return result;
+        }
+
+        for (int pos = 0; pos < target_data_capacity; ++pos) {
+            if (pos < decoded_targets.count) {
+                data[pos].num = decoded_targets.num[pos];
+
+                data[pos].distance = decoded_targets.distance[pos];
+                data[pos].speed = decoded_targets.speed[pos];
+                data[pos].angle = decoded_targets.angle[pos];
+                data[pos].snr = decoded_targets.snr[pos];
+            } else {
+                data[pos] = target_data{};
+            }
+        }
+
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    /**
+     * \brief Чтение данных о целях в пакет.
+     *
+     * Функция декодирует записи о целях из очередного кадра в структуру массивов target_batch,
+     * принадлежащую вызывающему коду. Декодирование выполняется векторными инструкциями
+     * без выделения памяти.
+     *
+     * \param [out] batch Указатель на пакет, в который записываются данные о целях
+     *
+     * \return Если чтение кадра выполнено успешно, то возвращает SMART_ROAD_RADAR_OK.
+     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     *
+     * **Пример**
+     * \code
+     * target_batch batch;
+     *
+     * if (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+     *     for (int i = 0; i < batch.count; ++i) {
+     *         printf("%2d | %2.2f m | %2.2f m/s\n", batch.num[i], batch.distance[i], batch.speed[i]);
+     *     }
+     * }
+     * \endcode
+     */
+    virtual int get_target_data(target_batch *batch) {
+        return get_target_data(batch, nullptr);
+    }
+
+    /**
+     * \brief Чтение данных о целях и блока облака точек.
+     *
+     * Функция декодирует записи о целях и возвращает без копирования блок облака точек размером
+     * TARGET_DATA_BYTE_OFFSET, который предшествует им в том же кадре. Данные блока действительны
+     * до следующего чтения кадра.
+     *
+     * \param [out] batch Указатель на пакет, в который записываются данные о целях
+     * \param [out] cloud Указатель на блок облака точек, может быть равен nullptr
+     *
+     * \return Если чтение кадра выполнено успешно, то возвращает SMART_ROAD_RADAR_OK.
+     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     *
+     * **Пример**
+     * \code
+     * target_batch batch;
+     * point_cloud_block cloud;
+     *
+     * if (radar.get_target_data(&batch, &cloud) == SMART_ROAD_RADAR_OK) {
+     *     printf("%d targets, %zu cloud bytes\n", batch.count, cloud.length);
+     * }
+     * \endcode
+     */
+    virtual int get_target_data(target_batch *batch, point_cloud_block *cloud) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        frame received_frame{};
+        int status;
+
+        auto deadline = timeouts.data_timeout > 0
+                        ? std::chrono::steady_clock::now() + std::chrono::milliseconds(timeouts.data_timeout)
+                        : std::chrono::steady_clock::time_point::max();
+
         do {
-            received_frame = read_expected_frame(CMD_READ_TARGET_DATA);
-        } while (received_frame.data_length.i <= 1);
-        
-        if (received_frame.is_valid) {
-            for (int pos = 0; pos < target_data_capacity; ++pos) {
-                data[pos].num = received_frame.data[0 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET];
+            status = read_expected_frame(CMD_READ_TARGET_DATA, &received_frame, deadline);
+        } while (status == SMART_ROAD_RADAR_OK && received_frame.data_length.i <= 1);
+
+        if (status == SMART_ROAD_RADAR_OK) {
+            decode_target_frame(received_frame, batch, cloud);
+            return SMART_ROAD_RADAR_OK;
+        } else {
+            batch->count = 0;
+
+            if (cloud != nullptr) {
+                *cloud = point_cloud_block{};
+            }
+
+            return status;
+        }
+    }
+
+    /**
+     * \brief Чтение данных о целях без ожидания.
+     *
+     * Разбирает только байты, уже принятые портом, и возвращает первый найденный кадр с целями. Кадры с другими
+     * командными словами пропускаются. Незавершённый кадр сохраняется до следующего вызова. Если обмен с радаром
+     * занят другим потоком или включено фоновое чтение, то функция сразу возвращает SMART_ROAD_RADAR_TIMEOUT.
+     *
+     * Используется внешним циклом событий (RadarManager), который вызывает функцию, пока она не вернёт
+     * SMART_ROAD_RADAR_TIMEOUT, после сигнала о готовности дескриптора get_poll_descriptor().
+     *
+     * \param [out] batch Указатель на пакет целей
+     * \param [out] cloud Указатель на блок облака точек, может быть равен nullptr. Данные блока действительны
+     * до следующего вызова.
+     *
+     * \return SMART_ROAD_RADAR_OK, если декодирован кадр с целями. SMART_ROAD_RADAR_TIMEOUT, если полных кадров
+     * с целями больше нет. SMART_ROAD_RADAR_ERROR, если чтение из порта невозможно.
+     */
+    int poll_target_data(target_batch *batch, point_cloud_block *cloud = nullptr) {
+        std::unique_lock<std::recursive_mutex> lock(bus_mutex, std::try_to_lock);
 
-                data[pos].distance = u_byte_to_float(new u_byte_t[2] {
-                        received_frame.data[2 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET],
-                        received_frame.data[3 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET]
-                });
+        if (!lock.owns_lock() || acquisition_running.load()) {
+            return SMART_ROAD_RADAR_TIMEOUT;
+        }
 
-                data[pos].speed = u_byte_to_float(new u_byte_t[2] {
-                        received_frame.data[4 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET],
-                        received_frame.data[5 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET]
-                });
+        frame received_frame{};
 
-                data[pos].angle = u_byte_to_float(new u_byte_t[2] {
-                        received_frame.data[6 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET],
-                        received_frame.data[7 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET]
-                });
+        while (true) {
+            int status = read_available_frame(&received_frame);
 
-                data[pos].snr =u_byte_to_float(new u_byte_t[2] {
-                        received_frame.data[8 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET],
-                        received_frame.data[9 + TARGET_DATA_BYTE_LENGTH * pos + TARGET_DATA_BYTE_OFFSET]
-                });
+            if (status != SMART_ROAD_RADAR_OK) {
+                return status;
             }
 
-            return SMART_ROAD_RADAR_OK;
+            if (received_frame.is_valid && received_frame.word == CMD_READ_TARGET_DATA &&
+                received_frame.data_length.i > 1) {
+                decode_target_frame(received_frame, batch, cloud);
+                return SMART_ROAD_RADAR_OK;
+            }
+        }
+    }
+
+    /**
+     * \brief Установка калибровки установки радара.
+     *
+     * После установки все функции чтения данных о целях заполняют road_x и road_y пакета.
+     *
+     * \param [in] calibration Положение, поворот и высота радара
+     *
+     * **Пример**
+     * \code
+     * radar_calibration calibration;
+     * calibration.x = -7.0f;
+     * calibration.height = 6.0f;
+     *
+     * radar.set_calibration(calibration);
+     * \endcode
+     */
+    void set_calibration(const radar_calibration &calibration) {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+
+        if (road_transform) {
+            road_transform->set_calibration(calibration);
         } else {
-            return SMART_ROAD_RADAR_ERROR;
+            road_transform.reset(new RoadTransform(calibration));
         }
     }
 
+    /**
+     * \brief Отмена перевода целей в координаты дороги.
+     */
+    void clear_calibration() {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+        road_transform.reset();
+    }
+
+    /**
+     * \brief Дескриптор порта для ожидания данных во внешнем цикле epoll.
+     *
+     * \return Дескриптор или -1, если канал нужно опрашивать через poll_target_data()
+     */
+    int get_poll_descriptor() {
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
+        return transport->get_poll_descriptor();
+    }
+
     /**
      * \brief Запуск передачи данных.
      *
@@ -563,19 +1768,11 @@ public:
      * \endcode
      */
     virtual int enable_data_transmit() {
-        frame target_frame = configure_frame(CMD_ENABLE_TRANSMIT);
-
-        int attempts = 10;
-        int result{};
-
-        do {
-            write_frame(target_frame);
-            result = read_status();
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
 
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_ENABLE_TRANSMIT);
 
-        return result;
+        return execute_command(*target_frame);
     }
 
     /**
@@ -596,19 +1793,11 @@ public:
      * \endcode
      */
     virtual int disable_data_transmit() {
-        frame target_frame = configure_frame(CMD_DISABLE_TRANSMIT);
-
-        int attempts = 10;
-        int result{};
-
-        do {
-            write_frame(target_frame);
-            result = read_status();
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
 
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_DISABLE_TRANSMIT);
 
-        return result;
+        return execute_command(*target_frame);
     }
 
     /**
@@ -642,19 +1831,11 @@ public:
      * \endcode
      */
     virtual int set_data_transmit_freq(u_byte_t freq) {
-        frame target_frame = configure_frame(CMD_SET_DATA_FREQ, freq);
-
-        int attempts = 10;
-        int result{};
-
-        do {
-            write_frame(target_frame);
-            result = read_status();
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
 
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_SET_DATA_FREQ, freq);
 
-        return result;
+        return execute_command(*target_frame);
     }
 
     /**
@@ -675,19 +1856,11 @@ public:
      * \endcode
      */
     virtual int enable_zero_data_reporting() {
-        frame target_frame = configure_frame(CMD_SET_ZERO_REPORT, ZERO_DATA_REPORT);
-
-        int attempts = 10;
-        int result{};
-
-        do {
-            write_frame(target_frame);
-            result = read_status();
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
 
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_SET_ZERO_REPORT, ZERO_DATA_REPORT);
 
-        return result;
+        return execute_command(*target_frame);
     }
 
     /**
@@ -708,19 +1881,129 @@ public:
      * \endcode
      */
     virtual int disable_zero_data_reporting() {
-        frame target_frame = configure_frame(CMD_SET_ZERO_REPORT, ZERO_DATA_NOT_REPORT);
+        std::lock_guard<std::recursive_mutex> lock(bus_mutex);
 
-        int attempts = 10;
-        int result{};
+        FrameHandle target_frame = configure_frame(&frame_pool, CMD_SET_ZERO_REPORT, ZERO_DATA_NOT_REPORT);
 
-        do {
-            write_frame(target_frame);
-            result = read_status();
+        return execute_command(*target_frame);
+    }
 
-            --attempts;
-        } while (result != SMART_ROAD_RADAR_OK && attempts > 0);
+    /**
+     * \brief Асинхронный вариант set_parameters().
+     *
+     * Команда выполняется в потоке радара, вызывающий поток не блокируется.
+     *
+     * \param [in] target_parameters Требуемые настройки радара
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     *
+     * **Пример**
+     * \code
+     * command_policy policy;
+     * policy.deadline = std::chrono::milliseconds(500);
+     *
+     * std::future<command_result> first = radar_1.set_parameters_async(target_parameters, policy);
+     * std::future<command_result> second = radar_2.set_parameters_async(target_parameters, policy);
+     *
+     * command_result result = first.get();
+     * printf("status %d, %d attempts, %lld us\n", result.status, result.attempts, (long long) result.latency.count());
+     * \endcode
+     */
+    std::future<command_result> set_parameters_async(parameters target_parameters,
+                                                     const command_policy &policy = command_policy{},
+                                                     command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this, target_parameters]() {
+            return set_parameters(target_parameters);
+        });
+    }
 
-        return result;
+    /**
+     * \brief Асинхронный вариант set_target_number().
+     *
+     * \param [in] number Количество целей
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     */
+    std::future<command_result> set_target_number_async(u_byte_t number,
+                                                        const command_policy &policy = command_policy{},
+                                                        command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this, number]() {
+            return set_target_number(number);
+        });
+    }
+
+    /**
+     * \brief Асинхронный вариант enable_data_transmit().
+     *
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     */
+    std::future<command_result> enable_data_transmit_async(const command_policy &policy = command_policy{},
+                                                           command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this]() {
+            return enable_data_transmit();
+        });
+    }
+
+    /**
+     * \brief Асинхронный вариант disable_data_transmit().
+     *
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     */
+    std::future<command_result> disable_data_transmit_async(const command_policy &policy = command_policy{},
+                                                            command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this]() {
+            return disable_data_transmit();
+        });
+    }
+
+    /**
+     * \brief Асинхронный вариант set_data_transmit_freq().
+     *
+     * \param [in] freq Частота передаваемых данных
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     */
+    std::future<command_result> set_data_transmit_freq_async(u_byte_t freq,
+                                                             const command_policy &policy = command_policy{},
+                                                             command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this, freq]() {
+            return set_data_transmit_freq(freq);
+        });
+    }
+
+    /**
+     * \brief Асинхронный вариант enable_zero_data_reporting().
+     *
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     */
+    std::future<command_result> enable_zero_data_reporting_async(const command_policy &policy = command_policy{},
+                                                                 command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this]() {
+            return enable_zero_data_reporting();
+        });
+    }
+
+    /**
+     * \brief Асинхронный вариант disable_zero_data_reporting().
+     *
+     * \param [in] policy Политика выполнения команды
+     * \param [in] callback Функция, вызываемая по завершении команды. Может быть пустой.
+     * \return Результат выполнения команды со статусом, количеством попыток и задержкой
+     */
+    std::future<command_result> disable_zero_data_reporting_async(const command_policy &policy = command_policy{},
+                                                                  command_callback callback = nullptr) {
+        return submit_command(policy, callback, [this]() {
+            return disable_zero_data_reporting();
+        });
     }
 };
 
@@ -1,11 +1,31 @@
 #ifndef SMART_ROAD_SMART_ROAD_RADAR_CLI_HPP
 #define SMART_ROAD_SMART_ROAD_RADAR_CLI_HPP
 
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
 #include <thread>
+#include <vector>
+
+#ifdef _WIN32
 #include <conio.h>
 
+/// Команда очистки экрана консоли
+#define CLEAR_SCREEN_COMMAND "cls"
+#else
+#include <termios.h>
+#include <unistd.h>
+
+/// Команда очистки экрана консоли
+#define CLEAR_SCREEN_COMMAND "clear"
+#endif
+
+#include "metrics_exporter.hpp"
 #include "smart_road_radar.hpp"
 #include "smart_road_radar_demo.hpp"
+#include "smart_road_radar_loopback.hpp"
+#include "smart_road_radar_replay.hpp"
+#include "terminal_renderer.hpp"
 
 #define CLI_VERSION                 "version"
 #define CLI_VERSION_SHORT           "-v"
@@ -37,6 +57,10 @@
 #define CLI_DISABLE_ZERO_DATA       "disable-zero"
 #define CLI_DISABLE_ZERO_DATA_SHORT "-dz"
 
+#define CLI_STATS                   "stats"
+
+#define CLI_METRICS                 "metrics"
+
 #define CLI_HELP                    "help"
 #define CLI_HELP_SHORT              "?"
 
@@ -44,13 +68,48 @@
 
 #define ESCAPE_CHAR 27
 
+/// Интервал обновления таблицы целей, мс
+#define CLI_RENDER_INTERVAL     50
+/// Ширина таблицы целей
+#define CLI_TABLE_WIDTH         48
+
 class SmartRoadRadarCLI {
 
 protected:
-    inline static bool exit_from_target_data;
+    inline static std::atomic<bool> exit_from_target_data{false};
+
+    /**
+     * \brief Чтение одного нажатия клавиши без ожидания ввода строки и без эха.
+     *
+     * \return Код нажатой клавиши
+     */
+    static int read_key() {
+#ifdef _WIN32
+        return getch();
+#else
+        termios saved_tty{};
+        termios raw_tty{};
+
+        tcgetattr(STDIN_FILENO, &saved_tty);
+
+        raw_tty = saved_tty;
+        raw_tty.c_lflag &= ~(ICANON | ECHO);
+        raw_tty.c_cc[VMIN] = 1;
+        raw_tty.c_cc[VTIME] = 0;
+
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw_tty);
+
+        unsigned char key = 0;
+        ssize_t size = ::read(STDIN_FILENO, &key, 1);
+
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_tty);
+
+        return size == 1 ? key : ESCAPE_CHAR;
+#endif
+    }
 
     static void wait_exc_char() {
-        while ((int) getch() != ESCAPE_CHAR);
+        while (read_key() != ESCAPE_CHAR);
 
         SmartRoadRadarCLI::exit_from_target_data = true;
     }
@@ -58,6 +117,11 @@ protected:
 private:
     SmartRoadRadar *radar;
 
+    MetricsExporter exporter;
+
+    /// Накопленные значения на момент предыдущей команды stats
+    pipeline_stats_snapshot stats_baseline;
+
     bool exit_from_main_loop = false;
 
     void parse_line(std::string *line) {
@@ -118,6 +182,16 @@ private:
                 disable_zero_data_transmit();
             else
                 usage();
+        } else if (cmd == CLI_STATS) {
+            if (line->length() == 0)
+                print_stats();
+            else
+                usage();
+        } else if (cmd == CLI_METRICS) {
+            if (line->length() > 0)
+                set_metrics_exporter(*line);
+            else
+                usage();
         } else if (cmd == CLI_HELP || cmd == CLI_HELP_SHORT) {
             usage();
         } else if (cmd == CLI_EXIT) {
@@ -149,6 +223,9 @@ private:
         printf("\tfreq         ( -f) [data_freq]\n\n");
         printf("\tenable-zero  (-ez) -- enable zero data reporting.\n");
         printf("\tdisable-zero (-dz) -- disable zero data reporting.\n\n");
+        printf("\tstats              -- shows p50/p99/max latency of each processing stage since the last call.\n\n");
+        printf("\tmetrics            -- serves Prometheus metrics on a local TCP port or Unix socket.\n");
+        printf("\tmetrics            [port|socket_path|off]\n\n");
         printf("\thelp         ( ? ) -- shows this usage.\n");
         printf("\texit               -- program closure.\n\n");
     }
@@ -214,39 +291,151 @@ private:
         }
     }
 
+    /**
+     * \brief Вывод таблицы целей до нажатия esc.
+     *
+     * Кадры читаются потоком фонового чтения, текущий поток только забирает пакеты из очереди и меняет местами
+     * буферы принятых и выводимых целей. Таблица выводится отдельным потоком каждые CLI_RENDER_INTERVAL мс
+     * независимо от частоты кадров, поэтому медленный терминал не задерживает приём.
+     */
     void get_target_data(std::string count) {
         int target_count = count.length() == 0 ? 35 : std::stoi(count);
-        target_data data[target_count];
 
-        SmartRoadRadarCLI::exit_from_target_data = false;
+        std::vector<target_data> received(target_count);
+        std::vector<target_data> shown(target_count);
+        unsigned long long frames = 0;
+        std::mutex shown_mutex;
 
-        system("cls");
+        SmartRoadRadarCLI::exit_from_target_data = false;
 
-        printf(" # |  dist  |   speed  |  angle  \n");
-        printf("---------------------------------\n");
+        /// Заголовок, строки целей, пустая строка и строка состояния
+        TerminalRenderer renderer(target_count + 4, CLI_TABLE_WIDTH);
+        TerminalRenderer::hide_cursor();
 
         std::thread esc_handler_thread(SmartRoadRadarCLI::wait_exc_char);
 
-        while (!SmartRoadRadarCLI::exit_from_target_data) {
-            if (radar->get_target_data(data, target_count) == SMART_ROAD_RADAR_OK) {
+        std::thread render_thread([&]() {
+            std::vector<target_data> rendered(target_count);
+            unsigned long long rendered_frames = 0;
 
-                for (int i = 0; i < target_count; ++i) {
-                    printf("\r%2d | %2.2f m | %2.2f m/s | %2.2f deg\t\n",
-                           data[i].num,
-                           data[i].distance,
-                           data[i].speed,
-                           data[i].angle);
+            auto next_render = std::chrono::steady_clock::now();
 
-                    data[i] = target_data{};
+            while (!SmartRoadRadarCLI::exit_from_target_data) {
+                {
+                    std::lock_guard<std::mutex> lock(shown_mutex);
+
+                    rendered.assign(shown.begin(), shown.end());
+                    rendered_frames = frames;
                 }
 
-                printf("\x1b[%dA", target_count);
+                {
+                    PipelineStats::Timer timer(&radar->get_pipeline_stats(), PIPELINE_STAGE_RENDER);
+
+                    renderer.begin_frame();
+                    renderer.print(0, " # |   dist   |    speed    |    angle");
+                    renderer.print(1, "-----------------------------------------");
+
+                    for (int i = 0; i < target_count; ++i) {
+                        renderer.print(i + 2, "%2d | %6.2f m | %7.2f m/s | %7.2f deg",
+                                       rendered[i].num,
+                                       rendered[i].distance,
+                                       rendered[i].speed,
+                                       rendered[i].angle);
+                    }
+
+                    renderer.print(target_count + 3, "Frames: %llu. Press esc to exit.", rendered_frames);
+                    renderer.present();
+                }
+
+                next_render += std::chrono::milliseconds(CLI_RENDER_INTERVAL);
+                std::this_thread::sleep_until(next_render);
+            }
+        });
+
+        /// Кадры читаются в фоновом потоке, чтобы вывод на экран не задерживал приём
+        radar->start_acquisition();
+
+        while (!SmartRoadRadarCLI::exit_from_target_data) {
+            if (radar->get_target_data(received.data(), target_count) == SMART_ROAD_RADAR_OK) {
+                std::lock_guard<std::mutex> lock(shown_mutex);
+
+                shown.swap(received);
+                ++frames;
             }
         }
 
         esc_handler_thread.join();
+        render_thread.join();
+
+        radar->stop_acquisition();
+
+        TerminalRenderer::restore_screen();
+    }
+
+    void print_stats() {
+        static const char *stage_names[PIPELINE_STAGE_COUNT] = {
+                "serial read", "frame parse", "decode", "render", "command"
+        };
+
+        const PipelineStats &stats = radar->get_pipeline_stats();
+
+        printf("    stage    |   count   |  p50, us  |  p99, us  |  max, us  \n");
+        printf("-------------------------------------------------------------\n");
+
+        for (int stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+            pipeline_stage_summary summary = stats.get_summary(stage, stats_baseline);
+
+            printf("%-12s | %9llu | %9.1f | %9.1f | %9.1f\n",
+                   stage_names[stage],
+                   summary.count,
+                   summary.p50 / 1000.0,
+                   summary.p99 / 1000.0,
+                   summary.max / 1000.0);
+        }
+
+        printf("\nChecksum failures: %llu\n", stats.get_counter(PIPELINE_COUNTER_CHECKSUM_FAILURES, stats_baseline));
+        printf("Discarded frames:  %llu\n\n", stats.get_counter(PIPELINE_COUNTER_FRAME_DISCARDS, stats_baseline));
+
+        /// Счётчики радара не сбрасываются, чтобы не обнулять показатели MetricsExporter
+        stats.get_snapshot(&stats_baseline);
+    }
+
+    void set_metrics_exporter(std::string target) {
+        if (target == "off") {
+            exporter.stop();
+
+            printf("Metrics exporter stopped\n");
+            return;
+        }
 
-        system("cls");
+        bool is_port = target.find_first_not_of("0123456789") == std::string::npos;
+        unsigned long port = 0;
+
+        if (is_port) {
+            /// При переполнении strtoul возвращает ULONG_MAX, который отсекается проверкой диапазона
+            port = strtoul(target.c_str(), nullptr, 10);
+
+            if (port == 0 || port > 65535) {
+                usage();
+                return;
+            }
+        }
+
+        exporter.stop();
+
+        int status;
+
+        if (is_port) {
+            status = exporter.start_tcp((u_short_t) port);
+        } else {
+            status = exporter.start_unix(target);
+        }
+
+        if (status == METRICS_EXPORTER_OK) {
+            printf("Metrics exporter started on %s\n", target.c_str());
+        } else {
+            printf("Can't start metrics exporter on %s\n", target.c_str());
+        }
     }
 
     void enable_data_transmit() {
@@ -305,11 +494,22 @@ public:
         radar = new SmartRoadRadar(address, config);
     }
 
+    /**
+     * \brief Конструктор, принимающий уже созданный радар (например, воспроизведение записи).
+     *
+     * \param [in] target_radar Радар, которым CLI владеет и который удаляет при выходе
+     */
+    explicit SmartRoadRadarCLI(SmartRoadRadar *target_radar) {
+        radar = target_radar;
+    }
+
     void main_loop() {
         std::string line;
         exit_from_main_loop = false;
 
-        system("cls");
+        exporter.add_radar(radar, "radar");
+
+        system(CLEAR_SCREEN_COMMAND);
 
         while (!exit_from_main_loop) {
             printf("smart_road_radar:\\> ");
@@ -320,6 +520,8 @@ public:
             parse_line(&line);
         }
 
+        exporter.stop();
+
         delete radar;
     }
 };
@@ -9,35 +9,36 @@
 #ifndef SMART_ROAD_SMART_ROAD_RADAR_DEMO_HPP
 #define SMART_ROAD_SMART_ROAD_RADAR_DEMO_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <random>
 #include <thread>
 #include <chrono>
 #include "smart_road_radar.hpp"
 #include "smart_road_radar_utils.hpp"
+#include "target_generator.hpp"
 
 using namespace std::chrono_literals;
 
-typedef std::uniform_int_distribution<std::mt19937::result_type> rnd_int;
-typedef std::uniform_real_distribution<float> rnd_float;
+/// Количество целей, которые генерирует демонстрационный радар, пока оно не задано set_target_number()
+#define DEMO_TARGET_COUNT   35
 
 /**
  * \brief Объект для эмуляции взаимодействия с радаром
  *
  * Объект содержит в себе конструкторы для эмуляции инициализации подключения к радару, функции чтения и отправки кадров
  * в радар, также, содержит функции для отправки определённых протоколом команд.
+ *
+ * Цели формируются TargetGenerator, количество целей в кадре задаётся set_target_number() или размером массива,
+ * переданного в get_target_data(target_data *, int), и не превышает TARGET_BATCH_CAPACITY. По умолчанию кадры выдаются с частотой, заданной set_data_transmit_freq(),
+ * а начальное значение генератора случайно. Для нагрузочных проверок set_frame_rate() задаёт произвольную частоту
+ * кадров или GENERATOR_RATE_UNLIMITED, а set_seed() делает последовательность целей воспроизводимой.
  */
 class SmartRoadRadarDemo : public SmartRoadRadar {
 
 private:
     struct DemoParameters {
-        float min_distance  = MIN_DISTANCE;
-        float max_distance  = MAX_DISTANCE;
-
-        float min_speed     = MIN_SPEED;
-        float max_speed     = MAX_SPEED;
-
-        float min_angle     = MIN_ANGLE;
-        float max_angle     = MAX_ANGLE;
+        generator_ranges ranges;
 
         float left_border   = LEFT_BORDER;
         float right_border  = RIGHT_BORDER;
@@ -45,19 +46,34 @@ private:
         u_byte_t sleep_time = DATA_FREQ_1;
     } demo_parameters;
 
-    std::random_device dev;
-    std::mt19937 gen;
+    TargetGenerator generator;
+
+    /// Количество целей в кадре
+    std::atomic<int> target_count{DEMO_TARGET_COUNT};
 
-    rnd_int rnd_num;
+    double frame_rate = GENERATOR_RATE_DATA_FREQ;
+    std::chrono::steady_clock::time_point next_frame_due{};
 
-    rnd_float rnd_dist;
-    rnd_float rnd_speed;
-    rnd_float rnd_angle;
+    /**
+     * \brief Ожидание момента выдачи следующего кадра.
+     *
+     * Моменты отсчитываются от предыдущего кадра, а не от конца ожидания, поэтому время формирования кадра
+     * не снижает частоту. После долгого перерыва между вызовами пропущенные кадры не выдаются подряд.
+     */
+    void wait_next_frame() {
+        double rate = frame_rate > 0 ? frame_rate : (double) demo_parameters.sleep_time;
 
-    void init_rnd_float() {
-        rnd_dist = rnd_float(demo_parameters.min_distance, demo_parameters.max_distance);
-        rnd_speed = rnd_float(demo_parameters.min_speed, demo_parameters.max_speed);
-        rnd_angle = rnd_float(demo_parameters.min_angle, demo_parameters.max_angle);
+        if (frame_rate == GENERATOR_RATE_UNLIMITED || rate <= 0) {
+            return;
+        }
+
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / rate));
+        auto now = std::chrono::steady_clock::now();
+
+        next_frame_due = next_frame_due + period < now ? now + period : next_frame_due + period;
+
+        std::this_thread::sleep_until(next_frame_due);
     }
 
 public:
@@ -70,12 +86,48 @@ public:
      * \endcode
      */
     SmartRoadRadarDemo() {
-        gen = std::mt19937(dev());
+        std::random_device device;
 
-        rnd_num = rnd_int(1, 35);
-        init_rnd_float();
+        generator.set_seed(((uint64_t) device() << 32) | device());
     };
 
+    /**
+     * \brief Конструктор для нагрузочных проверок.
+     *
+     * \param [in] seed Начальное значение генератора целей
+     * \param [in] rate Частота кадров в секунду, GENERATOR_RATE_DATA_FREQ или GENERATOR_RATE_UNLIMITED
+     *
+     * **Пример**
+     * \code
+     * SmartRoadRadarDemo radar(42, 5000);
+     * \endcode
+     */
+    SmartRoadRadarDemo(uint64_t seed, double rate) : generator(seed), frame_rate(rate) {}
+
+    /**
+     * \brief Перезапуск последовательности целей с заданным начальным значением.
+     *
+     * \param [in] seed Начальное значение генератора целей
+     */
+    void set_seed(uint64_t seed) {
+        generator.set_seed(seed);
+    }
+
+    /**
+     * \brief Установка частоты кадров.
+     *
+     * \param [in] rate Частота кадров в секунду. GENERATOR_RATE_DATA_FREQ - частота из set_data_transmit_freq(),
+     * GENERATOR_RATE_UNLIMITED - без пауз.
+     */
+    void set_frame_rate(double rate) {
+        frame_rate = rate;
+        next_frame_due = std::chrono::steady_clock::time_point{};
+    }
+
+    double get_frame_rate() const {
+        return frame_rate;
+    }
+
     /**
      * \brief Запрос версии ПО у радара.
      *
@@ -135,20 +187,18 @@ public:
      * \endcode
      */
     int set_parameters(parameters target_parameters) override {
-        demo_parameters.min_distance = target_parameters.min_dist.f;
-        demo_parameters.max_distance = target_parameters.max_dist.f;
+        demo_parameters.ranges.min_distance = target_parameters.min_dist.f;
+        demo_parameters.ranges.max_distance = target_parameters.max_dist.f;
 
-        demo_parameters.min_speed = target_parameters.min_speed.f;
-        demo_parameters.max_speed = target_parameters.max_speed.f;
+        demo_parameters.ranges.min_speed = target_parameters.min_speed.f;
+        demo_parameters.ranges.max_speed = target_parameters.max_speed.f;
 
-        demo_parameters.min_angle = target_parameters.min_angle.f;
-        demo_parameters.max_angle = target_parameters.max_angle.f;
+        demo_parameters.ranges.min_angle = target_parameters.min_angle.f;
+        demo_parameters.ranges.max_angle = target_parameters.max_angle.f;
 
         demo_parameters.left_border = target_parameters.left_border.f;
         demo_parameters.right_border = target_parameters.right_border.f;
 
-        init_rnd_float();
-
         return SMART_ROAD_RADAR_OK;
     }
 
@@ -183,14 +233,14 @@ public:
      * \endcode
      */
     int get_parameters(parameters *received_parameters) override {
-        received_parameters->min_dist.f = demo_parameters.min_distance;
-        received_parameters->max_dist.f = demo_parameters.max_distance;
+        received_parameters->min_dist.f = demo_parameters.ranges.min_distance;
+        received_parameters->max_dist.f = demo_parameters.ranges.max_distance;
 
-        received_parameters->min_speed.f = demo_parameters.min_speed;
-        received_parameters->max_speed.f = demo_parameters.max_speed;
+        received_parameters->min_speed.f = demo_parameters.ranges.min_speed;
+        received_parameters->max_speed.f = demo_parameters.ranges.max_speed;
 
-        received_parameters->min_angle.f = demo_parameters.min_angle;
-        received_parameters->max_angle.f = demo_parameters.max_angle;
+        received_parameters->min_angle.f = demo_parameters.ranges.min_angle;
+        received_parameters->max_angle.f = demo_parameters.ranges.max_angle;
 
         received_parameters->left_border.f = demo_parameters.left_border;
         received_parameters->right_border.f = demo_parameters.right_border;
@@ -201,13 +251,12 @@ public:
     /**
      * \brief Установка числа целей.
      *
-     * Функция, позволяющая задать количество целей, которые будут распознаваться радаром.
+     * Функция запоминает количество целей, которые демонстрационный радар формирует в каждом кадре.
+     * Значение ограничивается TARGET_BATCH_CAPACITY.
      *
-     * \warning Возможно, не количество целей, а максимальный номер цели
      * \param [in] number Количество целей
      *
-     * \return Если команда выполнена успешно, то возвращает SMART_ROAD_RADAR_OK.
-     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     * \return Всегда возвращает SMART_ROAD_RADAR_OK.
      *
      * **Пример**
      * \code
@@ -220,53 +269,67 @@ public:
      * \endcode
      */
     int set_target_number(u_byte_t number) override {
+        target_count.store(std::min((int) number, TARGET_BATCH_CAPACITY));
+
         return SMART_ROAD_RADAR_OK;
     }
 
     /**
      * \brief Чтение данных о целях.
      *
-     * Функция преобразует полученные кадры в структуры target_data, которые записываются
-     * в массив по переданному указателю
+     * Функция запоминает размер массива как количество целей в кадре, ограниченное TARGET_BATCH_CAPACITY,
+     * поэтому все элементы массива заполняются сгенерированными целями. Дальше работает так же,
+     * как SmartRoadRadar::get_target_data(target_data *, int).
      *
      * \param [out] data Указатель на массив структур target_data
+     * \param [in] target_data_capacity Размер массива
      *
-     * \return Если чтение кадра выполнено успешно, то возвращает SMART_ROAD_RADAR_OK.
-     * В противном случае - SMART_ROAD_RADAR_ERROR.
+     * \return Всегда возвращает SMART_ROAD_RADAR_OK.
+     */
+    int get_target_data(target_data *data, int target_data_capacity) override {
+        target_count.store(std::max(0, std::min(target_data_capacity, TARGET_BATCH_CAPACITY)));
+
+        return SmartRoadRadar::get_target_data(data, target_data_capacity);
+    }
+
+    using SmartRoadRadar::get_target_data;
+
+    /**
+     * \brief Чтение данных о целях и блока облака точек.
+     *
+     * Функция заполняет пакет случайными целями в количестве, заданном set_target_number()
+     * или размером массива последнего вызова get_target_data(target_data *, int), по умолчанию DEMO_TARGET_COUNT,
+     * с частотой set_frame_rate() или set_data_transmit_freq().
+     * Блок облака точек демонстрационный радар не формирует.
+     *
+     * \param [out] batch Указатель на пакет, в который записываются данные о целях
+     * \param [out] cloud Указатель на блок облака точек, может быть равен nullptr
+     *
+     * \return Всегда возвращает SMART_ROAD_RADAR_OK.
      *
      * **Пример**
      * \code
-     * target_data data[35];
-     *
-     * printf(" # |  dist  |   speed  |  angle  \n");
-     * printf("---------------------------------\n");
-     *
-     * if (radar.get_target_data(data) == SMART_ROAD_RADAR_OK) {
-     *     for (int i = 0; i < target_count; ++i) {
-     *         printf("\r%2d | %2.2f m | %2.2f m/i | %2.2f deg\n",
-     *                data[i].num,
-     *                data[i].distance,
-     *                data[i].speed,
-     *                data[i].angle);
-     *         data[i] = target_data{};
+     * target_batch batch;
+     *
+     * if (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+     *     for (int i = 0; i < batch.count; ++i) {
+     *         printf("%2d | %2.2f m | %2.2f m/s\n", batch.num[i], batch.distance[i], batch.speed[i]);
      *     }
      * }
      * \endcode
      */
-    int get_target_data(target_data *data, int target_data_capacity) override {
-        /// Задержка для эмуляции заданной скорости передачи данных
-        std::this_thread::sleep_for((1000ms / (int) demo_parameters.sleep_time));
-
-        for (int pos = 0; pos < target_data_capacity; ++pos) {
+    int get_target_data(target_batch *batch, point_cloud_block *cloud) override {
+        if (cloud != nullptr) {
+            *cloud = point_cloud_block{};
+        }
 
-            data[pos].num = rnd_num(gen);
+        /// Задержка для эмуляции заданной скорости передачи данных
+        wait_next_frame();
 
-            data[pos].distance = rnd_dist(gen);
-            data[pos].speed = rnd_speed(gen);
-            data[pos].angle = rnd_angle(gen);
+        generator.generate(batch, target_count.load(), demo_parameters.ranges);
 
-            data[pos].snr = 0;
-        }
+        record_target_count(*batch);
+        apply_calibration(batch);
 
         return SMART_ROAD_RADAR_OK;
     }
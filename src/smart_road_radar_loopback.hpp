@@ -0,0 +1,529 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий класс SmartRoadRadarLoopback для эмуляции радара на уровне байт протокола
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_SMART_ROAD_RADAR_LOOPBACK_HPP
+#define SMART_ROAD_SMART_ROAD_RADAR_LOOPBACK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "frame_parser.hpp"
+#include "smart_road_radar.hpp"
+#include "target_generator.hpp"
+
+/// Количество целей в кадре эмулируемого радара до команды CMD_SET_TARGET_NUM
+#define LOOPBACK_TARGET_COUNT   35
+
+/// Версия ПО, которую сообщает эмулируемый радар
+#define LOOPBACK_VERSION_MAJOR  0
+#define LOOPBACK_VERSION_MINOR  0
+#define LOOPBACK_VERSION_PATCH  1
+
+/// Начальный размер буфера байт, в который кодируются кадры эмулируемого радара
+#define LOOPBACK_BUFFER_SIZE    8192
+
+/**
+ * \brief Канал, эмулирующий радар на уровне байт протокола
+ *
+ * Отправленные в канал байты разбираются FrameParser как команды радара. На каждую команду формируется
+ * ответ: CMD_READ_VERSION на CMD_REQUEST_VERSION, CMD_READ_PARAMETERS на CMD_GET_PARAMETERS и CMD_READ_STATUS
+ * со статусом SUCCESS или FAILURE на остальные команды. Команды изменяют состояние эмулируемого радара:
+ * настройки, количество целей, частоту передачи и включение передачи.
+ *
+ * Пока передача включена, канал с заданной частотой кодирует кадры CMD_READ_TARGET_DATA с целями
+ * TargetGenerator в пределах настроек. Частоту можно задать и в обход команды через set_frame_rate(), в том числе
+ * GENERATOR_RATE_UNLIMITED для измерения пропускной способности. Ответы на команды выдаются раньше следующего кадра с целями.
+ *
+ * Как и последовательный порт, канал допускает одного читателя и одного писателя в разных потоках: после
+ * start_acquisition() поток фонового чтения читает кадры, а команды отправляются из потока, выполняющего
+ * execute_command(). Писатель не изменяет буфер читателя: ответы на команды собираются в отдельный буфер под
+ * мьютексом, и читатель забирает их при следующем заполнении своего буфера. Под тем же мьютексом хранится
+ * состояние эмулируемого радара и статистика.
+ */
+class LoopbackTransport : public Transport {
+
+private:
+    /// Разбор отправленных команд
+    FrameParser command_parser;
+
+    /// Закодированные кадры, которые ещё не прочитаны. Изменяется только читателем.
+    std::vector<u_byte_t> buffer;
+    size_t buffer_pos = 0;
+
+    /// Мьютекс, защищающий ответы, состояние эмулируемого радара и статистику
+    mutable std::mutex state_mutex;
+    /// Сигнал о новых ответах или изменении передачи
+    std::condition_variable state_signal;
+    /// Ответы на команды, которые читатель ещё не забрал
+    std::vector<u_byte_t> replies;
+
+    /// Состояние эмулируемого радара
+    parameters radar_parameters{};
+    bool transmit_enabled = true;
+    u_byte_t data_freq = DATA_FREQ_1;
+    int target_number = LOOPBACK_TARGET_COUNT;
+
+    TargetGenerator generator;
+    std::unique_ptr<target_batch> targets;
+
+    double frame_rate = GENERATOR_RATE_DATA_FREQ;
+    std::chrono::steady_clock::time_point next_frame_due{};
+    std::atomic<unsigned long long> frames_generated{0};
+
+    std::atomic<bool> reads_cancelled{false};
+    std::chrono::steady_clock::time_point read_deadline = std::chrono::steady_clock::time_point::max();
+    int last_read_status = SERIAL_OK;
+
+    serial_statistics statistics{};
+
+    /**
+     * \brief Добавление в буфер кадра с нулевой полезной нагрузкой.
+     *
+     * Полезная нагрузка заполняется по возвращённому смещению, после чего вызывается end_frame().
+     *
+     * \param [in,out] target Буфер, в который добавляется кадр
+     * \param [in] word Командное слово
+     * \param [in] length Размер полезной нагрузки
+     * \return Смещение кадра в буфере
+     */
+    static size_t begin_frame(std::vector<u_byte_t> &target, u_byte_t word, size_t length) {
+        u_short_t data_length = (u_short_t) (length + 1);
+        size_t start = target.size();
+
+        target.resize(start + LENGTH_HEADER + LENGTH_DATA_LENGTH + data_length + LENGTH_CHECKSUM, 0x00);
+
+        u_byte_t *packet = target.data() + start;
+
+        packet[0] = HEADER_DATA_FRAME_1;
+        packet[1] = HEADER_DATA_FRAME_2;
+        packet[2] = (u_byte_t) (data_length & 0xFF);
+        packet[3] = (u_byte_t) (data_length >> 8);
+        packet[4] = word;
+
+        return start;
+    }
+
+    /**
+     * \brief Расчёт контрольной суммы кадра, начатого begin_frame().
+     *
+     * \param [in,out] target Буфер с кадром
+     * \param [in] start Смещение кадра в буфере
+     */
+    static void end_frame(std::vector<u_byte_t> &target, size_t start) {
+        u_byte_t *packet = target.data() + start;
+        u_short_t data_length = (u_short_t) (packet[2] | (packet[3] << 8));
+
+        packet[LENGTH_HEADER + LENGTH_DATA_LENGTH + data_length] =
+                update_checksum(0x00, packet + LENGTH_HEADER, LENGTH_DATA_LENGTH + data_length);
+    }
+
+    void append_reply(u_byte_t word, const u_byte_t *payload, size_t length) {
+        size_t start = begin_frame(replies, word, length);
+
+        memcpy(replies.data() + start + LENGTH_HEADER + LENGTH_DATA_LENGTH + LENGTH_COMMAND_WORD, payload, length);
+        end_frame(replies, start);
+    }
+
+    void append_status(u_byte_t status) {
+        append_reply(CMD_READ_STATUS, &status, 1);
+    }
+
+    /**
+     * \brief Запись значения в поле записи о цели с учётом SCALE.
+     */
+    static void encode_field(u_byte_t *field, float value) {
+        long scaled = std::lround(value / SCALE);
+
+        if (scaled > 32767) {
+            scaled = 32767;
+        } else if (scaled < -32768) {
+            scaled = -32768;
+        }
+
+        field[0] = (u_byte_t) (scaled & 0xFF);
+        field[1] = (u_byte_t) ((scaled >> 8) & 0xFF);
+    }
+
+    /**
+     * \brief Добавление в буфер кадра CMD_READ_TARGET_DATA со случайными целями.
+     *
+     * Вызывается читателем под state_mutex.
+     *
+     * Раскладка полезной нагрузки совпадает с той, которую ожидает get_target_data(): пустой байт, пустое облако
+     * точек размером TARGET_DATA_BYTE_OFFSET, записи о целях и завершающий пустой байт.
+     */
+    void append_target_frame() {
+        generator_ranges ranges;
+
+        ranges.min_distance = radar_parameters.min_dist.f;
+        ranges.max_distance = radar_parameters.max_dist.f;
+        ranges.min_speed = radar_parameters.min_speed.f;
+        ranges.max_speed = radar_parameters.max_speed.f;
+        ranges.min_angle = radar_parameters.min_angle.f;
+        ranges.max_angle = radar_parameters.max_angle.f;
+
+        generator.generate(targets.get(), target_number, ranges);
+
+        size_t start = begin_frame(buffer, CMD_READ_TARGET_DATA,
+                                   TARGET_DATA_BYTE_OFFSET + TARGET_DATA_BYTE_LENGTH * target_number + 2);
+        u_byte_t *records = buffer.data() + start + LENGTH_HEADER + LENGTH_DATA_LENGTH + LENGTH_COMMAND_WORD + 1 +
+                            TARGET_DATA_BYTE_OFFSET;
+
+        for (int target = 0; target < target_number; ++target) {
+            u_byte_t *record = records + TARGET_DATA_BYTE_LENGTH * target;
+
+            record[0] = targets->num[target];
+
+            encode_field(record + 2, targets->distance[target]);
+            encode_field(record + 4, targets->speed[target]);
+            encode_field(record + 6, targets->angle[target]);
+            encode_field(record + 8, targets->snr[target]);
+        }
+
+        end_frame(buffer, start);
+
+        ++frames_generated;
+    }
+
+    /**
+     * \brief Выполнение принятой команды и формирование ответа.
+     *
+     * Вызывается писателем под state_mutex.
+     */
+    void execute(const frame_view &command) {
+        size_t length = command.data_length - 1;
+
+        if (!command.is_valid) {
+            append_status(FAILURE);
+            return;
+        }
+
+        switch (command.word) {
+            case CMD_REQUEST_VERSION: {
+                u_byte_t version[] = {LOOPBACK_VERSION_MAJOR, LOOPBACK_VERSION_MINOR, LOOPBACK_VERSION_PATCH};
+                append_reply(CMD_READ_VERSION, version, sizeof version);
+                return;
+            }
+
+            case CMD_GET_PARAMETERS: {
+                /// Как и настоящий радар, минимальное и максимальное расстояния и скорости передаются переставленными
+                parameters reported = radar_parameters;
+
+                std::swap(reported.min_dist.f, reported.max_dist.f);
+                std::swap(reported.min_speed.f, reported.max_speed.f);
+
+                append_reply(CMD_READ_PARAMETERS, (const u_byte_t *) &reported, sizeof reported);
+                return;
+            }
+
+            case CMD_SET_PARAMETERS:
+                if (length != sizeof radar_parameters) {
+                    break;
+                }
+
+                memcpy(&radar_parameters, command.payload, sizeof radar_parameters);
+                append_status(SUCCESS);
+                return;
+
+            case CMD_SET_TARGET_NUM:
+                if (length != 1) {
+                    break;
+                }
+
+                target_number = command.payload[0];
+                append_status(SUCCESS);
+                return;
+
+            case CMD_ENABLE_TRANSMIT:
+            case CMD_DISABLE_TRANSMIT:
+                transmit_enabled = command.word == CMD_ENABLE_TRANSMIT;
+                next_frame_due = std::chrono::steady_clock::now();
+                append_status(SUCCESS);
+                return;
+
+            case CMD_SET_DATA_FREQ:
+                if (length != 1 || command.payload[0] == 0) {
+                    break;
+                }
+
+                data_freq = command.payload[0];
+                append_status(SUCCESS);
+                return;
+
+            case CMD_SET_ZERO_REPORT:
+                if (length != 1) {
+                    break;
+                }
+
+                append_status(SUCCESS);
+                return;
+
+            default:
+                break;
+        }
+
+        append_status(FAILURE);
+    }
+
+    /**
+     * \brief Заполнение буфера ответами на команды или следующим кадром с целями, когда наступит его время.
+     *
+     * Ответы выдаются раньше кадра с целями. Ожидание прерывается новым ответом, включением передачи,
+     * истечением срока чтения или cancel_reads().
+     *
+     * \return SERIAL_OK, если буфер заполнен. В противном случае - SERIAL_TIMEOUT или SERIAL_ERROR.
+     */
+    int fill_buffer() {
+        buffer.clear();
+        buffer_pos = 0;
+
+        std::unique_lock<std::mutex> lock(state_mutex);
+
+        while (true) {
+            if (reads_cancelled.load()) {
+                return SERIAL_ERROR;
+            }
+
+            if (!replies.empty()) {
+                /// Буферы обмениваются, поэтому ни один из них не выделяет память заново
+                buffer.swap(replies);
+
+                ++statistics.read_calls;
+                statistics.bytes_received += buffer.size();
+
+                return SERIAL_OK;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+
+            if (transmit_enabled && (frame_rate == GENERATOR_RATE_UNLIMITED || now >= next_frame_due)) {
+                break;
+            }
+
+            if (now >= read_deadline) {
+                return SERIAL_TIMEOUT;
+            }
+
+            auto wake = now + std::chrono::milliseconds(SERIAL_READ_POLL_TIMEOUT);
+
+            if (transmit_enabled && next_frame_due < wake) {
+                wake = next_frame_due;
+            }
+
+            if (read_deadline < wake) {
+                wake = read_deadline;
+            }
+
+            state_signal.wait_until(lock, wake);
+        }
+
+        if (frame_rate != GENERATOR_RATE_UNLIMITED) {
+            double rate = frame_rate > 0 ? frame_rate : (double) data_freq;
+            auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(1.0 / rate));
+            auto now = std::chrono::steady_clock::now();
+
+            /// После долгого перерыва в чтении пропущенные кадры не выдаются пачкой
+            next_frame_due = next_frame_due + period < now ? now : next_frame_due + period;
+        }
+
+        append_target_frame();
+
+        ++statistics.read_calls;
+        statistics.bytes_received += buffer.size();
+
+        return SERIAL_OK;
+    }
+
+public:
+    /**
+     * \brief Конструктор с начальным значением генератора целей.
+     *
+     * \param [in] seed Начальное значение генератора: одинаковые значения дают одинаковые последовательности кадров
+     */
+    explicit LoopbackTransport(uint64_t seed = 1) : generator(seed), targets(new target_batch()) {
+        buffer.reserve(LOOPBACK_BUFFER_SIZE);
+        replies.reserve(LOOPBACK_BUFFER_SIZE);
+    }
+
+    /**
+     * \brief Установка частоты кадров с целями.
+     *
+     * \param [in] rate Частота кадров в секунду. GENERATOR_RATE_DATA_FREQ - частота из команды CMD_SET_DATA_FREQ,
+     * GENERATOR_RATE_UNLIMITED - без пауз.
+     *
+     * \warning Вызывается, только когда из канала никто не читает.
+     */
+    void set_frame_rate(double rate) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+
+        frame_rate = rate;
+        next_frame_due = std::chrono::steady_clock::time_point{};
+    }
+
+    /**
+     * \brief Количество кадров с целями, сформированных с момента создания.
+     */
+    unsigned long long get_frames_generated() const {
+        return frames_generated.load();
+    }
+
+    size_t peek_u_bytes(const u_byte_t **chunk) override {
+        if (buffer_pos == buffer.size()) {
+            last_read_status = fill_buffer();
+
+            if (last_read_status != SERIAL_OK) {
+                *chunk = nullptr;
+                return 0;
+            }
+        }
+
+        last_read_status = SERIAL_OK;
+        *chunk = buffer.data() + buffer_pos;
+
+        return buffer.size() - buffer_pos;
+    }
+
+    void skip_u_bytes(size_t count) override {
+        if (count > buffer.size() - buffer_pos) {
+            count = buffer.size() - buffer_pos;
+        }
+
+        buffer_pos += count;
+    }
+
+    int write_u_bytes(u_byte_t *data, size_t length) override {
+        std::lock_guard<std::mutex> lock(state_mutex);
+
+        ++statistics.write_calls;
+        statistics.bytes_sent += length;
+
+        while (length > 0) {
+            frame_view command;
+            size_t consumed;
+
+            if (command_parser.parse(data, length, &consumed, &command) == FRAME_PARSER_FRAME_READY) {
+                execute(command);
+            }
+
+            data += consumed;
+            length -= consumed;
+        }
+
+        state_signal.notify_one();
+
+        return SERIAL_OK;
+    }
+
+    bool is_open() const override {
+        return true;
+    }
+
+    void cancel_reads() override {
+        reads_cancelled.store(true);
+    }
+
+    void resume_reads() override {
+        reads_cancelled.store(false);
+    }
+
+    void set_read_deadline(std::chrono::steady_clock::time_point deadline) override {
+        read_deadline = deadline;
+    }
+
+    void clear_read_deadline() override {
+        read_deadline = std::chrono::steady_clock::time_point::max();
+    }
+
+    void set_timeouts(const serial_timeouts & /*new_timeouts*/) override {}
+
+    int get_read_status() const override {
+        return last_read_status;
+    }
+
+    serial_statistics get_statistics() const override {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return statistics;
+    }
+
+    void reset_statistics() override {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        statistics = serial_statistics{};
+    }
+};
+
+/**
+ * \brief Объект для эмуляции радара через настоящий путь обработки протокола
+ *
+ * В отличие от SmartRoadRadarDemo, методы SmartRoadRadar не переопределяются: команды кодируются в кадры
+ * и отправляются, ответы и кадры с целями разбираются read_frame(), проверяются по контрольной сумме
+ * и декодируются get_target_data(). Байты передаются через LoopbackTransport, поэтому нагрузочные проверки
+ * в этом режиме измеряют тот же код, что работает с реальным радаром.
+ *
+ * **Пример**
+ * \code
+ * SmartRoadRadarLoopback radar(42);
+ * target_batch batch;
+ *
+ * radar.set_data_transmit_freq(DATA_FREQ_20);
+ *
+ * if (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+ *     printf("%d targets\n", batch.count);
+ * }
+ * \endcode
+ */
+class SmartRoadRadarLoopback : public SmartRoadRadar {
+
+private:
+    LoopbackTransport loopback;
+
+public:
+    /**
+     * \brief Конструктор с начальным значением генератора целей.
+     *
+     * \param [in] seed Начальное значение генератора
+     */
+    explicit SmartRoadRadarLoopback(uint64_t seed = 1) : loopback(seed) {
+        set_transport(&loopback);
+    }
+
+    /**
+     * \brief Конструктор для нагрузочных проверок.
+     *
+     * \param [in] seed Начальное значение генератора целей
+     * \param [in] rate Частота кадров в секунду, GENERATOR_RATE_DATA_FREQ или GENERATOR_RATE_UNLIMITED
+     */
+    SmartRoadRadarLoopback(uint64_t seed, double rate) : loopback(seed) {
+        loopback.set_frame_rate(rate);
+        set_transport(&loopback);
+    }
+
+    /**
+     * \brief Деструктор, останавливающий чтение до уничтожения канала.
+     */
+    ~SmartRoadRadarLoopback() override {
+        stop_acquisition();
+        set_transport(nullptr);
+    }
+
+    /**
+     * \brief Количество кадров с целями, сформированных эмулируемым радаром.
+     */
+    unsigned long long get_frames_generated() const {
+        return loopback.get_frames_generated();
+    }
+};
+
+#endif //SMART_ROAD_SMART_ROAD_RADAR_LOOPBACK_HPP
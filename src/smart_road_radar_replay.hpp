@@ -0,0 +1,484 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий класс SmartRoadRadarReplay для воспроизведения записанных кадров радара
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_SMART_ROAD_RADAR_REPLAY_HPP
+#define SMART_ROAD_SMART_ROAD_RADAR_REPLAY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "smart_road_radar.hpp"
+#include "frame_recorder.hpp"
+
+/// Воспроизведение с исходными интервалами между кадрами
+#define REPLAY_SPEED_ORIGINAL       1.0f
+/// Воспроизведение без пауз между кадрами
+#define REPLAY_AS_FAST_AS_POSSIBLE  0.0f
+
+/// Воспроизводятся кадры всех портов записи
+#define REPLAY_ALL_PORTS    (-1)
+
+/// Размер буфера байт, в который кодируются воспроизводимые кадры
+#define REPLAY_BUFFER_SIZE  65536
+
+/**
+ * \brief Канал, выдающий кадры из записи FrameRecording в виде потока байт протокола
+ *
+ * Кадры кодируются обратно в байты (заголовок, длина, командное слово, данные, контрольная сумма)
+ * и выдаются через peek_u_bytes() так же, как их выдаёт последовательный порт. Кадр выдаётся не раньше
+ * момента, который соответствует его времени приёма в записи с учётом скорости воспроизведения.
+ * При скорости REPLAY_AS_FAST_AS_POSSIBLE в буфер кодируется сразу столько кадров, сколько в него помещается.
+ *
+ * Отправляемые байты отбрасываются. После последнего кадра чтение завершается с SERIAL_ERROR,
+ * если не включено повторение записи.
+ */
+class ReplayTransport : public Transport {
+
+private:
+    FrameRecording recording;
+    int port_filter = REPLAY_ALL_PORTS;
+
+    std::atomic<float> speed{REPLAY_SPEED_ORIGINAL};
+    std::atomic<bool> looped{false};
+
+    /// Закодированные кадры
+    std::vector<u_byte_t> buffer;
+    size_t buffer_pos = 0;
+    size_t buffer_length = 0;
+
+    /// Номер следующего кадра записи
+    size_t next_frame = 0;
+    /// Количество выданных кадров
+    std::atomic<unsigned long long> frames_replayed{0};
+
+    /// Момент выдачи первого кадра и его время приёма в записи
+    bool started = false;
+    /// Флаг смены скорости, по которому отсчёт интервалов начинается заново
+    std::atomic<bool> timing_reset{false};
+    std::chrono::steady_clock::time_point replay_start{};
+    uint64_t first_timestamp = 0;
+
+    std::atomic<bool> reads_cancelled{false};
+    std::chrono::steady_clock::time_point read_deadline = std::chrono::steady_clock::time_point::max();
+    int last_read_status = SERIAL_OK;
+
+    serial_statistics statistics{};
+
+    /**
+     * \brief Поиск следующего кадра выбранного порта.
+     *
+     * \param [out] found Кадр
+     * \return true, если кадр найден. Номер кадра остаётся в next_frame.
+     */
+    bool find_next_frame(recorded_frame *found) {
+        while (next_frame < recording.get_frame_count()) {
+            if (recording.get_frame(next_frame, found) == RECORDER_OK &&
+                (port_filter == REPLAY_ALL_PORTS || found->port_id == port_filter)) {
+                return true;
+            }
+
+            ++next_frame;
+        }
+
+        return false;
+    }
+
+    /**
+     * \brief Момент, в который должен быть выдан кадр.
+     */
+    std::chrono::steady_clock::time_point get_due_time(const recorded_frame &replayed_frame, float current_speed) {
+        if (!started || timing_reset.exchange(false)) {
+            started = true;
+            replay_start = std::chrono::steady_clock::now();
+            first_timestamp = replayed_frame.timestamp;
+        }
+
+        if (current_speed <= 0 || replayed_frame.timestamp <= first_timestamp) {
+            return replay_start;
+        }
+
+        double offset = (double) (replayed_frame.timestamp - first_timestamp) / current_speed;
+
+        return replay_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::nano>(offset));
+    }
+
+    /**
+     * \brief Ожидание момента выдачи кадра.
+     *
+     * \return SERIAL_OK, если момент наступил. SERIAL_TIMEOUT, если раньше истёк срок чтения.
+     * SERIAL_ERROR, если чтение прервано.
+     */
+    int wait_until(std::chrono::steady_clock::time_point due) {
+        while (true) {
+            if (reads_cancelled.load()) {
+                return SERIAL_ERROR;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+
+            if (now >= due) {
+                return SERIAL_OK;
+            }
+
+            if (now >= read_deadline) {
+                return SERIAL_TIMEOUT;
+            }
+
+            auto wake = now + std::chrono::milliseconds(SERIAL_READ_POLL_TIMEOUT);
+
+            if (due < wake) {
+                wake = due;
+            }
+
+            if (read_deadline < wake) {
+                wake = read_deadline;
+            }
+
+            std::this_thread::sleep_until(wake);
+        }
+    }
+
+    /**
+     * \brief Кодирование кадра в буфер.
+     */
+    void encode_frame(const recorded_frame &replayed_frame) {
+        u_byte_t *packet = buffer.data() + buffer_length;
+        size_t payload_length = replayed_frame.data_length - 1;
+
+        packet[0] = HEADER_DATA_FRAME_1;
+        packet[1] = HEADER_DATA_FRAME_2;
+        packet[2] = (u_byte_t) (replayed_frame.data_length & 0xFF);
+        packet[3] = (u_byte_t) (replayed_frame.data_length >> 8);
+        packet[4] = replayed_frame.word;
+
+        if (payload_length > 0) {
+            memcpy(packet + 5, replayed_frame.payload, payload_length);
+        }
+
+        packet[5 + payload_length] = replayed_frame.checksum;
+
+        buffer_length += get_packet_length(replayed_frame);
+    }
+
+    static size_t get_packet_length(const recorded_frame &replayed_frame) {
+        return LENGTH_HEADER + LENGTH_DATA_LENGTH + replayed_frame.data_length + LENGTH_CHECKSUM;
+    }
+
+    /**
+     * \brief Заполнение буфера кадрами, время выдачи которых наступило.
+     *
+     * \return SERIAL_OK, если в буфер записан хотя бы один кадр. В противном случае - SERIAL_TIMEOUT или SERIAL_ERROR.
+     */
+    int fill_buffer() {
+        recorded_frame replayed_frame;
+
+        buffer_pos = 0;
+        buffer_length = 0;
+
+        if (!find_next_frame(&replayed_frame)) {
+            if (!looped.load() || frames_replayed.load() == 0) {
+                return SERIAL_ERROR;
+            }
+
+            next_frame = 0;
+            started = false;
+
+            if (!find_next_frame(&replayed_frame)) {
+                return SERIAL_ERROR;
+            }
+        }
+
+        float current_speed = speed.load();
+        int status = wait_until(get_due_time(replayed_frame, current_speed));
+
+        if (status != SERIAL_OK) {
+            return status;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+
+        do {
+            if (buffer_length + get_packet_length(replayed_frame) > buffer.size() ||
+                get_due_time(replayed_frame, current_speed) > now) {
+                break;
+            }
+
+            encode_frame(replayed_frame);
+
+            ++next_frame;
+            ++frames_replayed;
+        } while (find_next_frame(&replayed_frame));
+
+        ++statistics.read_calls;
+        statistics.bytes_received += buffer_length;
+
+        return SERIAL_OK;
+    }
+
+public:
+    ReplayTransport() : buffer(REPLAY_BUFFER_SIZE) {}
+
+    /**
+     * \brief Открытие записи.
+     *
+     * \param [in] path Путь к файлу записи
+     * \param [in] port_id Идентификатор порта, кадры которого воспроизводятся, или REPLAY_ALL_PORTS
+     * \return RECORDER_OK, если запись открыта. В противном случае - RECORDER_ERROR.
+     */
+    int open(const char *path, int port_id = REPLAY_ALL_PORTS) {
+        port_filter = port_id;
+
+        int result = recording.open(path);
+        rewind();
+
+        return result;
+    }
+
+    /**
+     * \brief Возврат к началу записи.
+     *
+     * \warning Вызывается, только когда из канала никто не читает.
+     */
+    void rewind() {
+        next_frame = 0;
+        started = false;
+
+        buffer_pos = 0;
+        buffer_length = 0;
+
+        frames_replayed.store(0);
+    }
+
+    /**
+     * \brief Установка скорости воспроизведения, может вызываться из другого потока.
+     */
+    void set_speed(float new_speed) {
+        speed.store(new_speed);
+        timing_reset.store(true);
+    }
+
+    float get_speed() const {
+        return speed.load();
+    }
+
+    void set_loop(bool loop) {
+        looped.store(loop);
+    }
+
+    /**
+     * \brief Проверка, выданы ли все кадры записи.
+     */
+    bool is_finished() const {
+        return !looped.load() && buffer_pos == buffer_length && next_frame >= recording.get_frame_count();
+    }
+
+    unsigned long long get_frames_replayed() const {
+        return frames_replayed.load();
+    }
+
+    size_t peek_u_bytes(const u_byte_t **chunk) override {
+        if (buffer_pos == buffer_length) {
+            last_read_status = fill_buffer();
+
+            if (last_read_status != SERIAL_OK) {
+                *chunk = nullptr;
+                return 0;
+            }
+        }
+
+        last_read_status = SERIAL_OK;
+        *chunk = buffer.data() + buffer_pos;
+
+        return buffer_length - buffer_pos;
+    }
+
+    void skip_u_bytes(size_t count) override {
+        if (count > buffer_length - buffer_pos) {
+            count = buffer_length - buffer_pos;
+        }
+
+        buffer_pos += count;
+    }
+
+    int write_u_bytes(u_byte_t * /*data*/, size_t length) override {
+        ++statistics.write_calls;
+        statistics.bytes_sent += length;
+
+        return SERIAL_OK;
+    }
+
+    bool is_open() const override {
+        return recording.get_frame_count() > 0;
+    }
+
+    void cancel_reads() override {
+        reads_cancelled.store(true);
+    }
+
+    void resume_reads() override {
+        reads_cancelled.store(false);
+    }
+
+    void set_read_deadline(std::chrono::steady_clock::time_point deadline) override {
+        read_deadline = deadline;
+    }
+
+    void clear_read_deadline() override {
+        read_deadline = std::chrono::steady_clock::time_point::max();
+    }
+
+    void set_timeouts(const serial_timeouts & /*new_timeouts*/) override {}
+
+    int get_read_status() const override {
+        return last_read_status;
+    }
+
+    serial_statistics get_statistics() const override {
+        return statistics;
+    }
+
+    void reset_statistics() override {
+        statistics = serial_statistics{};
+    }
+};
+
+/**
+ * \brief Объект для воспроизведения записи кадров радара
+ *
+ * Кадры из файла, созданного SmartRoadRadar::start_recording(), передаются в неизменённые read_frame()
+ * и get_target_data() базового класса, поэтому воспроизведение проходит тот же путь разбора и декодирования,
+ * что и данные реального радара. Поддерживается воспроизведение с исходными интервалами, ускоренное
+ * или замедленное в заданное число раз и без пауз (REPLAY_AS_FAST_AS_POSSIBLE) для измерения
+ * производительности.
+ *
+ * Команды, изменяющие настройки радара, не отправляются и считаются выполненными: у записи нет
+ * радара, который мог бы на них ответить.
+ *
+ * **Пример**
+ * \code
+ * SmartRoadRadarReplay radar("radar.rec", REPLAY_AS_FAST_AS_POSSIBLE);
+ * target_batch batch;
+ *
+ * while (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+ *     printf("%d targets\n", batch.count);
+ * }
+ * \endcode
+ */
+class SmartRoadRadarReplay : public SmartRoadRadar {
+
+private:
+    ReplayTransport replay;
+
+public:
+    /**
+     * \brief Конструктор, в который передаётся путь к записи.
+     *
+     * \param [in] path Путь к файлу записи
+     * \param [in] replay_speed Скорость воспроизведения: REPLAY_SPEED_ORIGINAL, множитель
+     * или REPLAY_AS_FAST_AS_POSSIBLE
+     * \param [in] port_id Идентификатор порта, кадры которого воспроизводятся, или REPLAY_ALL_PORTS
+     */
+    explicit SmartRoadRadarReplay(const char *path, float replay_speed = REPLAY_SPEED_ORIGINAL,
+                                  int port_id = REPLAY_ALL_PORTS) {
+        if (replay.open(path, port_id) != RECORDER_OK) {
+            printf("Can't open recording %s\n", path);
+        }
+
+        replay.set_speed(replay_speed);
+        set_transport(&replay);
+    }
+
+    /**
+     * \brief Деструктор, останавливающий чтение до уничтожения канала воспроизведения.
+     */
+    ~SmartRoadRadarReplay() override {
+        stop_acquisition();
+        set_transport(nullptr);
+    }
+
+    /**
+     * \brief Проверка, открыта ли запись.
+     */
+    bool is_open() const {
+        return replay.is_open();
+    }
+
+    /**
+     * \brief Установка скорости воспроизведения.
+     *
+     * Отсчёт интервалов начинается заново со следующего кадра.
+     *
+     * \param [in] replay_speed REPLAY_SPEED_ORIGINAL, множитель или REPLAY_AS_FAST_AS_POSSIBLE
+     */
+    void set_speed(float replay_speed) {
+        replay.set_speed(replay_speed);
+    }
+
+    /**
+     * \brief Включение повторения записи с начала после последнего кадра.
+     */
+    void set_loop(bool loop) {
+        replay.set_loop(loop);
+    }
+
+    /**
+     * \brief Возврат к началу записи.
+     *
+     * \warning Вызывается при остановленном фоновом чтении.
+     */
+    void rewind() {
+        replay.rewind();
+    }
+
+    /**
+     * \brief Проверка, воспроизведены ли все кадры записи.
+     */
+    bool is_finished() const {
+        return replay.is_finished();
+    }
+
+    /**
+     * \brief Количество воспроизведённых кадров с момента открытия или последнего rewind().
+     */
+    unsigned long long get_frames_replayed() const {
+        return replay.get_frames_replayed();
+    }
+
+    int set_parameters(parameters /*target_parameters*/) override {
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    int set_target_number(u_byte_t /*number*/) override {
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    int enable_data_transmit() override {
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    int disable_data_transmit() override {
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    int set_data_transmit_freq(u_byte_t /*freq*/) override {
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    int enable_zero_data_reporting() override {
+        return SMART_ROAD_RADAR_OK;
+    }
+
+    int disable_zero_data_reporting() override {
+        return SMART_ROAD_RADAR_OK;
+    }
+};
+
+#endif //SMART_ROAD_SMART_ROAD_RADAR_REPLAY_HPP
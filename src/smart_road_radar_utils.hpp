@@ -9,12 +9,24 @@
 #ifndef SMART_ROAD_SMART_ROAD_RADAR_UTILS_HPP
 #define SMART_ROAD_SMART_ROAD_RADAR_UTILS_HPP
 
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "serial.hpp"
 
 /// Возвращаемое значение при успешно выполненном действии
 #define SMART_ROAD_RADAR_OK     0
 /// Возвращаемое значение при невыполненном действии
 #define SMART_ROAD_RADAR_ERROR  1
+/// Возвращаемое значение, если радар не ответил до истечения срока
+#define SMART_ROAD_RADAR_TIMEOUT    2
 
 /// Байт в пакете данных при успешном действии
 #define SUCCESS     0x0A
@@ -68,6 +80,9 @@
 /// Длина контрольной суммы
 #define LENGTH_CHECKSUM         1
 
+/// Максимальный размер данных кадра (значение поля длины), который принимается от радара
+#define FRAME_MAX_DATA_LENGTH   8192
+
 /// Минимальная дальность
 #define MIN_DISTANCE    0.0f
 /// Максимальная дальность
@@ -189,101 +204,179 @@ struct target_data {
     float snr{};                ///< Отношение сигнал-шум
 };
 
+/// Структура статистики ввода-вывода радара
+struct io_statistics {
+    unsigned long long frames_received = 0;     ///< Количество принятых кадров
+    unsigned long long read_calls = 0;          ///< Количество системных вызовов чтения
+    unsigned long long bytes_received = 0;      ///< Количество принятых байт
+    float read_calls_per_frame = 0;             ///< Среднее количество системных вызовов чтения на один кадр
+    unsigned long long frame_timeouts = 0;      ///< Количество кадров, отброшенных из-за истечения таймаута
+    unsigned long long bytes_skipped = 0;       ///< Количество байт, пропущенных при поиске заголовка
+    unsigned long long frames_recovered = 0;    ///< Количество верных кадров, найденных после потери синхронизации
+};
+
 /**
- * Метод для расчёта контрольной суммы кадра
+ * Структура таймаутов чтения кадров
  *
- * \param [in] target_frame Кадр, для которого рассчитывается контрольная сумма
- * \return Контрольная сумма в формате одного байта типа u_byte_t
+ * Значения задаются в миллисекундах, ноль означает отсутствие ограничения.
  */
-u_byte_t calculate_checksum(frame target_frame) {
-    u_byte_t checksum = 0x00;
-
-    checksum += target_frame.data_length.b[0];
-    checksum += target_frame.data_length.b[1];
-
-    checksum += target_frame.word;
+struct read_timeouts {
+    DWORD inter_byte_timeout = 0;   ///< Максимальный интервал между байтами внутри кадра
+    DWORD frame_timeout = 0;        ///< Максимальное время приёма кадра от заголовка до контрольной суммы
+    DWORD data_timeout = 0;         ///< Максимальное время ожидания кадра с данными о целях в get_target_data()
+};
 
-    if (target_frame.data_length.i > 1) {
-        for (long long i = 0; i < target_frame.data_length.i - 1; ++i) {
-            checksum += target_frame.data[i];
-        }
-    }
+/// Структура кадра, принятого потоком фонового чтения
+struct acquired_frame {
+    frame header{};                                         ///< Кадр, поле data указывает на payload
+    std::chrono::steady_clock::time_point received_at{};    ///< Время приёма кадра
+    u_byte_t payload[FRAME_MAX_DATA_LENGTH]{};              ///< Данные кадра
+};
 
-    return checksum;
-}
+/// Структура статистики фонового чтения
+struct acquisition_statistics {
+    unsigned long long frames_published = 0;   ///< Количество кадров, переданных в очередь
+    unsigned long long overruns = 0;           ///< Количество кадров, отброшенных из-за заполненной очереди
+    size_t queue_depth = 0;                    ///< Текущее количество кадров в очереди
+    size_t queue_capacity = 0;                 ///< Ёмкость очереди
+    size_t queue_high_water = 0;               ///< Максимальное количество кадров в очереди
+};
 
 /**
- * Метод для перевода двух байт типа u_byte_t в число типа float
+ * Структура показателей состояния радара
  *
- * \param [in] u_bytes Массив, состоящий из двух байт
- * \return число типа float
+ * Все значения читаются из атомарных счётчиков, поэтому снимок можно получать из любого потока
+ * без остановки приёма кадров.
  */
-float u_byte_to_float(const u_byte_t u_bytes[2]) {
-    // TODO: Проверить это место на реальном радаре
-    short data = (int) (u_bytes[1] << 8) | (int) u_bytes[0];
-    return (float) data * SCALE;
-}
+struct radar_health {
+    unsigned long long frames_received = 0;     ///< Количество принятых кадров
+    unsigned long long checksum_failures = 0;   ///< Количество кадров с неверной контрольной суммой
+    unsigned long long frame_timeouts = 0;      ///< Количество кадров, отброшенных из-за истечения таймаута
+    unsigned long long bytes_skipped = 0;       ///< Количество байт, пропущенных при поиске заголовка
+    unsigned long long frames_recovered = 0;    ///< Количество восстановлений синхронизации
+    unsigned long long frames_dropped = 0;      ///< Количество кадров, отброшенных из-за заполненной очереди
+    size_t queue_depth = 0;                     ///< Текущее количество кадров в очереди фонового чтения
+    int target_count = 0;                       ///< Количество целей в последнем пакете
+};
 
 /**
- * Метод формирующий кадр, который состоит только из одного командного слова
+ * Метод для добавления байт к аддитивной контрольной сумме
+ *
+ * Позволяет считать контрольную сумму по частям по мере поступления байт. При сборке с SSE2 байты
+ * суммируются инструкцией _mm_sad_epu8 по 64 байта за итерацию (с AVX2 - _mm256_sad_epu8 по 128 байт),
+ * затем блоками по 16 (32) байт, остаток меньше блока суммируется поэлементно.
  *
- * \param [in] word Командное слово
- * \return Готовый кадр с рассчитанной контрольной суммой
+ * \param [in] checksum Контрольная сумма уже обработанных байт
+ * \param [in] data Указатель на массив байт
+ * \param [in] length Размер массива
+ * \return Контрольная сумма с учётом добавленных байт
  */
-frame configure_frame(u_byte_t word) {
-    frame configured_frame{};
+u_byte_t update_checksum(u_byte_t checksum, const u_byte_t *data, size_t length) {
+    size_t pos = 0;
+
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum_0 = _mm256_setzero_si256();
+    __m256i sum_1 = _mm256_setzero_si256();
+
+    for (; pos + 128 <= length; pos += 128) {
+        const __m256i *block = (const __m256i *) (data + pos);
+
+        sum_0 = _mm256_add_epi64(sum_0, _mm256_sad_epu8(_mm256_loadu_si256(block), zero));
+        sum_1 = _mm256_add_epi64(sum_1, _mm256_sad_epu8(_mm256_loadu_si256(block + 1), zero));
+        sum_0 = _mm256_add_epi64(sum_0, _mm256_sad_epu8(_mm256_loadu_si256(block + 2), zero));
+        sum_1 = _mm256_add_epi64(sum_1, _mm256_sad_epu8(_mm256_loadu_si256(block + 3), zero));
+    }
 
-    configured_frame.data_length.i = 1;
-    configured_frame.word = word;
+    for (; pos + 32 <= length; pos += 32) {
+        sum_0 = _mm256_add_epi64(sum_0, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *) (data + pos)), zero));
+    }
+
+    __m256i sum = _mm256_add_epi64(sum_0, sum_1);
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+
+    checksum += (u_byte_t) (_mm_cvtsi128_si32(half) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(half, half)));
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum_0 = _mm_setzero_si128();
+    __m128i sum_1 = _mm_setzero_si128();
+
+    for (; pos + 64 <= length; pos += 64) {
+        const __m128i *block = (const __m128i *) (data + pos);
+
+        sum_0 = _mm_add_epi64(sum_0, _mm_sad_epu8(_mm_loadu_si128(block), zero));
+        sum_1 = _mm_add_epi64(sum_1, _mm_sad_epu8(_mm_loadu_si128(block + 1), zero));
+        sum_0 = _mm_add_epi64(sum_0, _mm_sad_epu8(_mm_loadu_si128(block + 2), zero));
+        sum_1 = _mm_add_epi64(sum_1, _mm_sad_epu8(_mm_loadu_si128(block + 3), zero));
+    }
+
+    for (; pos + 16 <= length; pos += 16) {
+        sum_0 = _mm_add_epi64(sum_0, _mm_sad_epu8(_mm_loadu_si128((const __m128i *) (data + pos)), zero));
+    }
+
+    __m128i sum = _mm_add_epi64(sum_0, sum_1);
 
-    configured_frame.checksum = calculate_checksum(configured_frame);
+    checksum += (u_byte_t) (_mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum)));
+#endif
 
-    return configured_frame;
+    for (; pos < length; ++pos) {
+        checksum += data[pos];
+    }
+
+    return checksum;
 }
 
 /**
- * Метод формирующий кадр, который состоит из командного слова и одного байта данных
+ * Метод для расчёта контрольной суммы кадра
  *
- * \param [in] word Командное слово
- * \param [in] data Один байт данных
- * \return Готовый кадр с рассчитанной контрольной суммой
+ * \param [in] target_frame Кадр, для которого рассчитывается контрольная сумма
+ * \return Контрольная сумма в формате одного байта типа u_byte_t
  */
-frame configure_frame(u_byte_t word, u_byte_t data) {
-    frame configured_frame{};
+u_byte_t calculate_checksum(const frame &target_frame) {
+    u_byte_t checksum = 0x00;
 
-    configured_frame.data_length.i = 2;
-    configured_frame.word = word;
+    checksum += target_frame.data_length.b[0];
+    checksum += target_frame.data_length.b[1];
 
-    configured_frame.data = new u_byte_t[1];
-    configured_frame.data[0] = data;
+    checksum += target_frame.word;
 
-    configured_frame.checksum = calculate_checksum(configured_frame);
+    if (target_frame.data_length.i > 1) {
+        checksum = update_checksum(checksum, target_frame.data, (size_t) target_frame.data_length.i - 1);
+    }
 
-    return configured_frame;
+    return checksum;
 }
 
 /**
- * Метод формирующий кадр, который состоит из командного слова и массива данных
+ * Метод для определения размера массива data принятого кадра
+ *
+ * В кадре с данными о целях пустые байты в начале и в конце полезной нагрузки не входят в data.
  *
- * \param [in] word Командное слово
- * \param [in] data Указатель на массив данных
- * \param [in] length Размер массива данных
- * \return Готовый кадр с рассчитанной контрольной суммой
+ * \param [in] target_frame Кадр
+ * \return Количество байт, на которые указывает data
  */
-frame configure_frame(u_byte_t word, u_byte_t *data, u_short_t length) {
-    frame configured_frame{};
-
-    configured_frame.data_length.i = length + 1;
-    configured_frame.word = word;
+int get_frame_data_size(const frame &target_frame) {
+    if (target_frame.data == nullptr || target_frame.data_length.i <= 1) {
+        return 0;
+    }
 
-    configured_frame.data = new u_byte_t[length];
-    for (int i = 0; i < length; ++i) {
-        configured_frame.data[i] = *(data + i);
+    if (target_frame.word == CMD_READ_TARGET_DATA) {
+        return target_frame.data_length.i > 3 ? target_frame.data_length.i - 3 : 0;
     }
 
-    configured_frame.checksum = calculate_checksum(configured_frame);
+    return target_frame.data_length.i - 1;
+}
 
-    return configured_frame;
+/**
+ * Метод для перевода двух байт типа u_byte_t в число типа float
+ *
+ * \param [in] u_bytes Массив, состоящий из двух байт
+ * \return число типа float
+ */
+float u_byte_to_float(const u_byte_t u_bytes[2]) {
+    // TODO: Проверить это место на реальном радаре
+    short data = (int) (u_bytes[1] << 8) | (int) u_bytes[0];
+    return (float) data * SCALE;
 }
 
 #endif //SMART_ROAD_SMART_ROAD_RADAR_UTILS_HPP
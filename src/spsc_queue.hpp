@@ -0,0 +1,204 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий ограниченную lock-free очередь SpscQueue для одного производителя и одного потребителя
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_SPSC_QUEUE_HPP
+#define SMART_ROAD_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <vector>
+
+#include "utils.hpp"
+
+/// Размер строки кэша, по которому выравниваются индексы очереди
+#define CACHE_LINE_SIZE 64
+
+/**
+ * \brief Ограниченная lock-free очередь для одного производителя и одного потребителя
+ *
+ * Элементы хранятся в заранее выделенных ячейках и заполняются на месте: производитель получает
+ * указатель на свободную ячейку, заполняет её и публикует вызовом commit(), потребитель получает
+ * указатель на самую старую ячейку и освобождает её вызовом release(). Ёмкость округляется
+ * вверх до степени двойки.
+ *
+ * Если свободных ячеек нет, то acquire_write_slot() возвращает nullptr и увеличивает счётчик переполнений.
+ *
+ * **Пример**
+ * \code
+ * SpscQueue<int> queue(16);
+ *
+ * // Поток производителя
+ * int *slot = queue.acquire_write_slot();
+ * if (slot != nullptr) {
+ *     *slot = 42;
+ *     queue.commit();
+ * }
+ *
+ * // Поток потребителя
+ * int *item = queue.acquire_read_slot();
+ * if (item != nullptr) {
+ *     printf("%d\n", *item);
+ *     queue.release();
+ * }
+ * \endcode
+ */
+template<typename T>
+class SpscQueue {
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    /// Индекс следующей ячейки для чтения, изменяется только потребителем
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    /// Последнее значение tail, которое видел потребитель
+    size_t cached_tail = 0;
+
+    /// Индекс следующей ячейки для записи, изменяется только производителем
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    /// Последнее значение head, которое видел производитель
+    size_t cached_head = 0;
+
+    /// Количество элементов, не поместившихся в очередь
+    std::atomic<unsigned long long> overruns{0};
+    /// Максимальное количество элементов, одновременно находившихся в очереди
+    std::atomic<size_t> high_water{0};
+
+    static size_t round_up_capacity(size_t capacity) {
+        size_t rounded = 1;
+
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+
+        return rounded;
+    }
+
+public:
+    /**
+     * \brief Конструктор очереди.
+     *
+     * \param [in] capacity Минимальная ёмкость очереди
+     */
+    explicit SpscQueue(size_t capacity) : slots(round_up_capacity(capacity)), mask(slots.size() - 1) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * \brief Получение свободной ячейки для записи. Вызывается только производителем.
+     *
+     * \return Указатель на ячейку или nullptr, если очередь заполнена.
+     */
+    T *acquire_write_slot() {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+
+        if (current_tail - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+
+            if (current_tail - cached_head > mask) {
+                overruns.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        return &slots[current_tail & mask];
+    }
+
+    /**
+     * \brief Публикация заполненной ячейки. Вызывается только производителем.
+     */
+    void commit() {
+        size_t current_tail = tail.load(std::memory_order_relaxed) + 1;
+
+        tail.store(current_tail, std::memory_order_seq_cst);
+
+        size_t depth = current_tail - head.load(std::memory_order_relaxed);
+
+        if (depth > high_water.load(std::memory_order_relaxed)) {
+            high_water.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * \brief Получение самой старой ячейки. Вызывается только потребителем.
+     *
+     * \return Указатель на ячейку или nullptr, если очередь пуста.
+     */
+    T *acquire_read_slot() {
+        size_t current_head = head.load(std::memory_order_relaxed);
+
+        if (current_head == cached_tail) {
+            cached_tail = tail.load(std::memory_order_seq_cst);
+
+            if (current_head == cached_tail) {
+                return nullptr;
+            }
+        }
+
+        return &slots[current_head & mask];
+    }
+
+    /**
+     * \brief Освобождение прочитанной ячейки. Вызывается только потребителем.
+     */
+    void release() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * \brief Сброс очереди.
+     *
+     * \warning Вызывается, только когда ни производитель, ни потребитель не работают с очередью.
+     */
+    void clear() {
+        head.store(0);
+        tail.store(0);
+
+        cached_head = 0;
+        cached_tail = 0;
+    }
+
+    /**
+     * \brief Проверка очереди на пустоту.
+     */
+    bool is_empty() const {
+        return head.load(std::memory_order_seq_cst) == tail.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * \brief Текущее количество элементов в очереди.
+     */
+    size_t size() const {
+        size_t current_head = head.load(std::memory_order_acquire);
+
+        return tail.load(std::memory_order_acquire) - current_head;
+    }
+
+    /**
+     * \brief Ёмкость очереди.
+     */
+    size_t capacity() const {
+        return slots.size();
+    }
+
+    /**
+     * \brief Количество элементов, не поместившихся в очередь.
+     */
+    unsigned long long get_overruns() const {
+        return overruns.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Максимальное количество элементов, одновременно находившихся в очереди.
+     */
+    size_t get_high_water() const {
+        return high_water.load(std::memory_order_relaxed);
+    }
+};
+
+#endif //SMART_ROAD_SPSC_QUEUE_HPP
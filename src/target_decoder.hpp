@@ -0,0 +1,242 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий векторизованный декодер данных о целях в структуру массивов
+ *
+ * \authors Александр Горбунов
+ * \date 16 октября 2026
+ */
+
+#ifndef SMART_ROAD_TARGET_DECODER_HPP
+#define SMART_ROAD_TARGET_DECODER_HPP
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "smart_road_radar_utils.hpp"
+
+/// Максимальное количество целей в одном пакете
+#define TARGET_BATCH_CAPACITY   255
+
+/**
+ * \brief Пакет данных о целях в виде структуры массивов
+ *
+ * Каждое поле цели хранится в отдельном выровненном массиве, что позволяет обрабатывать
+ * пакет векторными инструкциями. Действительны первые count элементов каждого массива.
+ */
+struct target_batch {
+    int count = 0;                                          ///< Количество целей в пакете
+
+    u_byte_t num[TARGET_BATCH_CAPACITY]{};                  ///< Номера целей
+
+    alignas(32) float distance[TARGET_BATCH_CAPACITY]{};    ///< Расстояния
+    alignas(32) float speed[TARGET_BATCH_CAPACITY]{};       ///< Скорости
+    alignas(32) float angle[TARGET_BATCH_CAPACITY]{};       ///< Углы
+    alignas(32) float snr[TARGET_BATCH_CAPACITY]{};         ///< Отношения сигнал-шум
+
+    /// Признак того, что road_x и road_y заполнены RoadTransform для текущих целей
+    bool has_road_coordinates = false;
+
+    alignas(32) float road_x[TARGET_BATCH_CAPACITY]{};      ///< Поперечные координаты на дороге, м
+    alignas(32) float road_y[TARGET_BATCH_CAPACITY]{};      ///< Продольные координаты на дороге, м
+};
+
+/**
+ * \brief Блок облака точек из кадра CMD_READ_TARGET_DATA
+ *
+ * Раскладка блока не описана в протоколе, поэтому он передаётся без декодирования: указатель ссылается
+ * на данные принятого кадра и действителен до следующего чтения кадра.
+ */
+struct point_cloud_block {
+    const u_byte_t *data = nullptr;     ///< Начало блока или nullptr, если в кадре нет блока
+    size_t length = 0;                  ///< Размер блока, TARGET_DATA_BYTE_OFFSET
+};
+
+/**
+ * \brief Количество записей о целях в кадре CMD_READ_TARGET_DATA
+ *
+ * \param [in] data_length Значение поля длины кадра
+ * \return Количество полных записей длиной TARGET_DATA_BYTE_LENGTH после облака точек
+ */
+int get_target_count(int data_length) {
+    int records_length = data_length - 3 - TARGET_DATA_BYTE_OFFSET;
+
+    if (records_length <= 0) {
+        return 0;
+    }
+
+    return records_length / TARGET_DATA_BYTE_LENGTH;
+}
+
+/**
+ * \brief Скалярное декодирование записей о целях
+ *
+ * \param [in] records Указатель на первую запись
+ * \param [in] first Индекс первой декодируемой записи
+ * \param [in] count Количество записей
+ * \param [out] batch Пакет, в который записываются значения
+ */
+void decode_targets_scalar(const u_byte_t *records, int first, int count, target_batch *batch) {
+    for (int pos = first; pos < count; ++pos) {
+        const u_byte_t *record = records + TARGET_DATA_BYTE_LENGTH * pos;
+
+        batch->num[pos] = record[0];
+
+        batch->distance[pos] = u_byte_to_float(record + 2);
+        batch->speed[pos] = u_byte_to_float(record + 4);
+        batch->angle[pos] = u_byte_to_float(record + 6);
+        batch->snr[pos] = u_byte_to_float(record + 8);
+    }
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+/**
+ * \brief Загрузка четырёх 16-битных полей записи и перевод их в числа типа float с учётом SCALE
+ *
+ * \param [in] record Указатель на запись
+ * \param [in] scale Вектор из масштабных коэффициентов
+ * \return Вектор {distance, speed, angle, snr}
+ */
+__m128 load_target_fields_sse2(const u_byte_t *record, __m128 scale) {
+    __m128i fields = _mm_loadl_epi64((const __m128i *) (record + 2));
+    __m128i extended = _mm_srai_epi32(_mm_unpacklo_epi16(fields, fields), 16);
+
+    return _mm_mul_ps(_mm_cvtepi32_ps(extended), scale);
+}
+
+/**
+ * \brief Декодирование записей о целях блоками по четыре с помощью SSE2
+ *
+ * \param [in] records Указатель на первую запись
+ * \param [in] first Индекс первой декодируемой записи
+ * \param [in] count Количество записей
+ * \param [out] batch Пакет, в который записываются значения
+ * \return Индекс первой записи, которая не была декодирована
+ */
+int decode_targets_sse2(const u_byte_t *records, int first, int count, target_batch *batch) {
+    const __m128 scale = _mm_set1_ps(SCALE);
+    int pos = first;
+
+    for (; pos + 4 <= count; pos += 4) {
+        const u_byte_t *record = records + TARGET_DATA_BYTE_LENGTH * pos;
+
+        __m128 row_0 = load_target_fields_sse2(record, scale);
+        __m128 row_1 = load_target_fields_sse2(record + TARGET_DATA_BYTE_LENGTH, scale);
+        __m128 row_2 = load_target_fields_sse2(record + TARGET_DATA_BYTE_LENGTH * 2, scale);
+        __m128 row_3 = load_target_fields_sse2(record + TARGET_DATA_BYTE_LENGTH * 3, scale);
+
+        _MM_TRANSPOSE4_PS(row_0, row_1, row_2, row_3);
+
+        _mm_storeu_ps(batch->distance + pos, row_0);
+        _mm_storeu_ps(batch->speed + pos, row_1);
+        _mm_storeu_ps(batch->angle + pos, row_2);
+        _mm_storeu_ps(batch->snr + pos, row_3);
+
+        batch->num[pos]     = record[0];
+        batch->num[pos + 1] = record[TARGET_DATA_BYTE_LENGTH];
+        batch->num[pos + 2] = record[TARGET_DATA_BYTE_LENGTH * 2];
+        batch->num[pos + 3] = record[TARGET_DATA_BYTE_LENGTH * 3];
+    }
+
+    return pos;
+}
+#endif
+
+#if defined(__AVX2__)
+/**
+ * \brief Загрузка полей двух записей и перевод их в числа типа float с учётом SCALE
+ *
+ * \param [in] low Запись, поля которой попадают в младшую половину вектора
+ * \param [in] high Запись, поля которой попадают в старшую половину вектора
+ * \param [in] scale Вектор из масштабных коэффициентов
+ * \return Вектор {distance, speed, angle, snr} двух записей
+ */
+__m256 load_target_fields_avx2(const u_byte_t *low, const u_byte_t *high, __m256 scale) {
+    __m128i fields = _mm_unpacklo_epi64(
+            _mm_loadl_epi64((const __m128i *) (low + 2)),
+            _mm_loadl_epi64((const __m128i *) (high + 2)));
+
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(fields)), scale);
+}
+
+/**
+ * \brief Декодирование записей о целях блоками по восемь с помощью AVX2
+ *
+ * \param [in] records Указатель на первую запись
+ * \param [in] first Индекс первой декодируемой записи
+ * \param [in] count Количество записей
+ * \param [out] batch Пакет, в который записываются значения
+ * \return Индекс первой записи, которая не была декодирована
+ */
+int decode_targets_avx2(const u_byte_t *records, int first, int count, target_batch *batch) {
+    const __m256 scale = _mm256_set1_ps(SCALE);
+    int pos = first;
+
+    for (; pos + 8 <= count; pos += 8) {
+        const u_byte_t *record = records + TARGET_DATA_BYTE_LENGTH * pos;
+
+        /// Записи i и i + 4 лежат в одном векторе, чтобы транспонирование выполнялось внутри 128-битных половин
+        __m256 row_0 = load_target_fields_avx2(record, record + TARGET_DATA_BYTE_LENGTH * 4, scale);
+        __m256 row_1 = load_target_fields_avx2(record + TARGET_DATA_BYTE_LENGTH,
+                                               record + TARGET_DATA_BYTE_LENGTH * 5, scale);
+        __m256 row_2 = load_target_fields_avx2(record + TARGET_DATA_BYTE_LENGTH * 2,
+                                               record + TARGET_DATA_BYTE_LENGTH * 6, scale);
+        __m256 row_3 = load_target_fields_avx2(record + TARGET_DATA_BYTE_LENGTH * 3,
+                                               record + TARGET_DATA_BYTE_LENGTH * 7, scale);
+
+        __m256 low_01 = _mm256_unpacklo_ps(row_0, row_1);
+        __m256 high_01 = _mm256_unpackhi_ps(row_0, row_1);
+        __m256 low_23 = _mm256_unpacklo_ps(row_2, row_3);
+        __m256 high_23 = _mm256_unpackhi_ps(row_2, row_3);
+
+        _mm256_storeu_ps(batch->distance + pos, _mm256_shuffle_ps(low_01, low_23, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm256_storeu_ps(batch->speed + pos, _mm256_shuffle_ps(low_01, low_23, _MM_SHUFFLE(3, 2, 3, 2)));
+        _mm256_storeu_ps(batch->angle + pos, _mm256_shuffle_ps(high_01, high_23, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm256_storeu_ps(batch->snr + pos, _mm256_shuffle_ps(high_01, high_23, _MM_SHUFFLE(3, 2, 3, 2)));
+
+        for (int i = 0; i < 8; ++i) {
+            batch->num[pos + i] = record[TARGET_DATA_BYTE_LENGTH * i];
+        }
+    }
+
+    return pos;
+}
+#endif
+
+/**
+ * \brief Декодирование записей о целях в пакет
+ *
+ * Записи длиной TARGET_DATA_BYTE_LENGTH переводятся из 16-битных чисел в числа типа float
+ * с масштабным коэффициентом SCALE. При сборке с AVX2 используются блоки по восемь записей,
+ * с SSE2 - по четыре, оставшиеся записи обрабатываются скалярным кодом.
+ *
+ * \param [in] records Указатель на первую запись
+ * \param [in] count Количество записей, не больше TARGET_BATCH_CAPACITY
+ * \param [out] batch Пакет, в который записываются значения
+ */
+void decode_targets(const u_byte_t *records, int count, target_batch *batch) {
+    if (count > TARGET_BATCH_CAPACITY) {
+        count = TARGET_BATCH_CAPACITY;
+    }
+
+    int pos = 0;
+
+#if defined(__AVX2__)
+    pos = decode_targets_avx2(records, pos, count, batch);
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    pos = decode_targets_sse2(records, pos, count, batch);
+#endif
+
+    decode_targets_scalar(records, pos, count, batch);
+
+    batch->count = count;
+    batch->has_road_coordinates = false;
+}
+
+#endif //SMART_ROAD_TARGET_DECODER_HPP
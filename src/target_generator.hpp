@@ -0,0 +1,168 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий векторизуемый генератор случайных целей для эмуляции радара
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_TARGET_GENERATOR_HPP
+#define SMART_ROAD_TARGET_GENERATOR_HPP
+
+#include <cstdint>
+
+#include "target_decoder.hpp"
+
+/// Количество независимых потоков xorshift, которые генератор продвигает за один шаг
+#define TARGET_GENERATOR_LANES  8
+
+/// Частота кадров задаётся командой set_data_transmit_freq(), как у радара
+#define GENERATOR_RATE_DATA_FREQ    0.0
+/// Кадры формируются без пауз
+#define GENERATOR_RATE_UNLIMITED    (-1.0)
+
+/// Диапазоны значений генерируемых целей
+struct generator_ranges {
+    float min_distance = MIN_DISTANCE;  ///< Минимальное расстояние
+    float max_distance = MAX_DISTANCE;  ///< Максимальное расстояние
+
+    float min_speed = MIN_SPEED;        ///< Минимальная скорость
+    float max_speed = MAX_SPEED;        ///< Максимальная скорость
+
+    float min_angle = MIN_ANGLE;        ///< Минимальный угол
+    float max_angle = MAX_ANGLE;        ///< Максимальный угол
+};
+
+/**
+ * \brief Генератор случайных целей
+ *
+ * Состояние - TARGET_GENERATOR_LANES независимых 32-битных генераторов xorshift, которые продвигаются
+ * одновременно одинаковыми сдвигами и исключающими ИЛИ. Цикл по потокам не имеет зависимостей между
+ * итерациями и векторизуется компилятором, поэтому пакет целей заполняется блоками по TARGET_GENERATOR_LANES
+ * значений прямо в массивы target_batch.
+ *
+ * Потоки инициализируются из начального значения через splitmix64, поэтому одинаковое начальное значение
+ * даёт одинаковую последовательность пакетов.
+ *
+ * **Пример**
+ * \code
+ * TargetGenerator generator(42);
+ * target_batch batch;
+ *
+ * generator.generate(&batch, 35, generator_ranges{});
+ * \endcode
+ */
+class TargetGenerator {
+
+private:
+    alignas(32) uint32_t state[TARGET_GENERATOR_LANES]{};
+
+    /**
+     * \brief Шаг всех потоков.
+     *
+     * \param [out] values Новые значения потоков
+     */
+    void next(uint32_t values[TARGET_GENERATOR_LANES]) {
+        for (int lane = 0; lane < TARGET_GENERATOR_LANES; ++lane) {
+            uint32_t x = state[lane];
+
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+
+            state[lane] = x;
+            values[lane] = x;
+        }
+    }
+
+    /**
+     * \brief Заполнение массива равномерно распределёнными значениями.
+     *
+     * \param [out] values Массив значений
+     * \param [in] count Количество значений
+     * \param [in] min Нижняя граница
+     * \param [in] max Верхняя граница
+     */
+    void fill_uniform(float *values, int count, float min, float max) {
+        /// Старшие 24 бита переводятся в float без округления
+        const float scale = (max - min) * (1.0f / 16777216.0f);
+
+        alignas(32) uint32_t block[TARGET_GENERATOR_LANES];
+        int pos = 0;
+
+        for (; pos + TARGET_GENERATOR_LANES <= count; pos += TARGET_GENERATOR_LANES) {
+            next(block);
+
+            for (int lane = 0; lane < TARGET_GENERATOR_LANES; ++lane) {
+                values[pos + lane] = min + (float) (int32_t) (block[lane] >> 8) * scale;
+            }
+        }
+
+        if (pos < count) {
+            next(block);
+
+            for (int lane = 0; pos + lane < count; ++lane) {
+                values[pos + lane] = min + (float) (int32_t) (block[lane] >> 8) * scale;
+            }
+        }
+    }
+
+public:
+    /**
+     * \brief Конструктор с начальным значением.
+     *
+     * \param [in] seed Начальное значение
+     */
+    explicit TargetGenerator(uint64_t seed = 1) {
+        set_seed(seed);
+    }
+
+    /**
+     * \brief Перезапуск последовательности с начальным значением.
+     *
+     * \param [in] seed Начальное значение
+     */
+    void set_seed(uint64_t seed) {
+        for (int lane = 0; lane < TARGET_GENERATOR_LANES; ++lane) {
+            seed += 0x9E3779B97F4A7C15ull;
+
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+
+            /// Нулевое состояние xorshift не меняется
+            state[lane] = (uint32_t) z != 0 ? (uint32_t) z : 0x6D2B79F5u;
+        }
+    }
+
+    /**
+     * \brief Заполнение пакета случайными целями.
+     *
+     * Номера целей - от 1 до count по порядку, расстояние, скорость и угол распределены равномерно
+     * в заданных диапазонах, отношение сигнал-шум равно нулю. Координаты дороги сбрасываются.
+     *
+     * \param [out] batch Пакет целей
+     * \param [in] count Количество целей, не больше TARGET_BATCH_CAPACITY
+     * \param [in] ranges Диапазоны значений
+     */
+    void generate(target_batch *batch, int count, const generator_ranges &ranges) {
+        if (count > TARGET_BATCH_CAPACITY) {
+            count = TARGET_BATCH_CAPACITY;
+        }
+
+        batch->count = count;
+        batch->has_road_coordinates = false;
+
+        for (int pos = 0; pos < count; ++pos) {
+            batch->num[pos] = (u_byte_t) (pos + 1);
+            batch->snr[pos] = 0;
+        }
+
+        fill_uniform(batch->distance, count, ranges.min_distance, ranges.max_distance);
+        fill_uniform(batch->speed, count, ranges.min_speed, ranges.max_speed);
+        fill_uniform(batch->angle, count, ranges.min_angle, ranges.max_angle);
+    }
+};
+
+#endif //SMART_ROAD_TARGET_GENERATOR_HPP
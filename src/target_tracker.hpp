@@ -0,0 +1,420 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий сопровождение целей TargetTracker с альфа-бета фильтром и стробированием по сетке
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_TARGET_TRACKER_HPP
+#define SMART_ROAD_TARGET_TRACKER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "target_decoder.hpp"
+
+/// Максимальное количество одновременно сопровождаемых траекторий
+#define TRACKER_CAPACITY            512
+/// Радиус строба, м. Равен размеру ячейки сетки, поэтому строб покрывается ячейками 3x3
+#define TRACKER_GATE_DISTANCE       3.0f
+/// Количество ячеек хеш-таблицы сетки (степень двойки)
+#define TRACKER_GRID_BUCKETS        1024
+/// Коэффициент коррекции координат альфа-бета фильтра
+#define TRACKER_ALPHA               0.5f
+/// Коэффициент коррекции скорости альфа-бета фильтра
+#define TRACKER_BETA                0.15f
+/// Коэффициент сглаживания радиальной скорости
+#define TRACKER_SPEED_ALPHA         0.3f
+/// Количество подтверждений, после которого траектория выдаётся
+#define TRACKER_CONFIRM_HITS        3
+/// Количество пропусков подряд, после которого траектория удаляется
+#define TRACKER_MAX_MISSES          5
+/// Период кадров, который используется для первого обновления, с (DATA_FREQ_20)
+#define TRACKER_DEFAULT_PERIOD      0.05f
+/// Наименьший шаг фильтра, с. Пакеты, накопившиеся в порту, декодируются подряд с разницей отметок времени
+/// в микросекунды, и без ограничения коэффициент TRACKER_BETA / dt усиливал бы невязку до 10^5 м/с
+#define TRACKER_MIN_PERIOD          (TRACKER_DEFAULT_PERIOD * 0.5f)
+/// Наибольшее опережение времени фильтра относительно отметок времени пакетов, с
+#define TRACKER_MAX_LEAD            0.4f
+/// Перевод углов радара из градусов в радианы
+#define TRACKER_DEGREES_TO_RADIANS  0.017453292519943295f
+
+/**
+ * \brief Подтверждённые траектории в виде структуры массивов
+ *
+ * Если пакеты целей переведены в координаты дороги (RoadTransform), то траектории строятся в них. Иначе координаты
+ * отсчитываются от радара: ось y направлена вдоль оси антенны, ось x - вправо от неё. Действительны первые count элементов каждого массива.
+ */
+struct track_batch {
+    int count = 0;                                  ///< Количество траекторий
+
+    uint32_t id[TRACKER_CAPACITY]{};                ///< Постоянные номера траекторий
+
+    alignas(32) float x[TRACKER_CAPACITY]{};        ///< Поперечная координата, м
+    alignas(32) float y[TRACKER_CAPACITY]{};        ///< Продольная координата, м
+    alignas(32) float vx[TRACKER_CAPACITY]{};       ///< Поперечная скорость, м/с
+    alignas(32) float vy[TRACKER_CAPACITY]{};       ///< Продольная скорость, м/с
+    alignas(32) float speed[TRACKER_CAPACITY]{};    ///< Сглаженная радиальная скорость
+};
+
+/// Статистика сопровождения
+struct tracker_statistics {
+    unsigned long long updates = 0;                 ///< Количество обработанных пакетов
+    unsigned long long tracks_created = 0;          ///< Количество созданных траекторий
+    unsigned long long tracks_deleted = 0;          ///< Количество удалённых траекторий
+    unsigned long long detections_dropped = 0;      ///< Цели, для которых не хватило места под траекторию
+};
+
+/**
+ * \brief Объект сопровождения целей одного радара
+ *
+ * Номер цели в кадре радара не сохраняется между кадрами, поэтому цели связываются с траекториями по
+ * положению. Каждая траектория фильтруется альфа-бета фильтром по декартовым координатам, радиальная
+ * скорость сглаживается экспоненциально.
+ *
+ * Для связывания прогнозы траекторий раскладываются по хеш-сетке с ячейкой TRACKER_GATE_DISTANCE, и для
+ * каждой цели проверяются только траектории из соседних ячеек 3x3. Пары внутри строба сортируются по расстоянию
+ * и назначаются жадно, поэтому обработка пакета близка к O(n log n) по количеству пар, а не O(n * m).
+ *
+ * Траектория выдаётся в get_tracks() после TRACKER_CONFIRM_HITS связываний и удаляется после TRACKER_MAX_MISSES
+ * пропусков подряд. Память выделяется один раз в конструкторе.
+ *
+ * Координаты разных радаров не совмещены, поэтому для каждого радара создаётся свой трекер. Пакеты одного
+ * радара RadarManager передаёт из одного потока, так что трекер можно обновлять прямо в batch_callback.
+ * Пакеты, которые RadarManager доставляет пачкой с почти одинаковыми отметками времени, обрабатываются
+ * с шагом не меньше TRACKER_MIN_PERIOD.
+ *
+ * **Пример**
+ * \code
+ * TargetTracker tracker;
+ * target_batch batch;
+ *
+ * while (radar.get_target_data(&batch) == SMART_ROAD_RADAR_OK) {
+ *     const track_batch &tracks = tracker.update(batch, std::chrono::steady_clock::now());
+ *
+ *     for (int pos = 0; pos < tracks.count; ++pos) {
+ *         printf("%u: %.1f m, %.1f m/s\n", tracks.id[pos], tracks.y[pos], tracks.speed[pos]);
+ *     }
+ * }
+ * \endcode
+ */
+class TargetTracker {
+
+private:
+    /**
+     * \brief Пара цель-траектория внутри строба
+     */
+    struct gate_pair {
+        float distance;
+        int detection;
+        int track;
+
+        bool operator<(const gate_pair &other) const {
+            return distance < other.distance;
+        }
+    };
+
+    /// Состояние траекторий, действительны первые track_count элементов
+    int track_count = 0;
+    uint32_t track_id[TRACKER_CAPACITY]{};
+    float track_x[TRACKER_CAPACITY]{};
+    float track_y[TRACKER_CAPACITY]{};
+    float track_vx[TRACKER_CAPACITY]{};
+    float track_vy[TRACKER_CAPACITY]{};
+    float track_speed[TRACKER_CAPACITY]{};
+    int track_hits[TRACKER_CAPACITY]{};
+    int track_misses[TRACKER_CAPACITY]{};
+    bool track_updated[TRACKER_CAPACITY]{};
+
+    /// Декартовы координаты целей текущего пакета
+    float detection_x[TARGET_BATCH_CAPACITY]{};
+    float detection_y[TARGET_BATCH_CAPACITY]{};
+    /// Траектория, связанная с целью, или -1
+    int detection_track[TARGET_BATCH_CAPACITY]{};
+
+    /// Хеш-сетка прогнозов: первая траектория ячейки и следующая траектория той же ячейки
+    int grid_head[TRACKER_GRID_BUCKETS]{};
+    int grid_next[TRACKER_CAPACITY]{};
+
+    std::vector<gate_pair> pairs;
+
+    uint32_t next_id = 1;
+
+    bool has_last_update = false;
+    std::chrono::steady_clock::time_point last_update{};
+
+    track_batch tracks{};
+    tracker_statistics statistics{};
+
+    /**
+     * \brief Индекс ячейки хеш-сетки
+     *
+     * \param [in] cell_x Номер ячейки по оси x
+     * \param [in] cell_y Номер ячейки по оси y
+     */
+    static int get_bucket(int cell_x, int cell_y) {
+        auto hash = (uint32_t) cell_x * 73856093u ^ (uint32_t) cell_y * 19349663u;
+        return (int) (hash & (TRACKER_GRID_BUCKETS - 1));
+    }
+
+    static int get_cell(float coordinate) {
+        return (int) std::floor(coordinate * (1.0f / TRACKER_GATE_DISTANCE));
+    }
+
+    /**
+     * \brief Прогноз траекторий на dt и раскладка прогнозов по сетке
+     *
+     * \param [in] dt Время с предыдущего обновления, с
+     */
+    void predict(float dt) {
+        std::fill(grid_head, grid_head + TRACKER_GRID_BUCKETS, -1);
+
+        for (int track = 0; track < track_count; ++track) {
+            track_x[track] += track_vx[track] * dt;
+            track_y[track] += track_vy[track] * dt;
+            track_updated[track] = false;
+
+            int bucket = get_bucket(get_cell(track_x[track]), get_cell(track_y[track]));
+
+            grid_next[track] = grid_head[bucket];
+            grid_head[bucket] = track;
+        }
+    }
+
+    /**
+     * \brief Сбор пар цель-траектория внутри строба и их жадное назначение по возрастанию расстояния
+     *
+     * \param [in] detection_count Количество целей в пакете
+     */
+    void associate(int detection_count) {
+        pairs.clear();
+
+        const float gate = TRACKER_GATE_DISTANCE * TRACKER_GATE_DISTANCE;
+
+        for (int detection = 0; detection < detection_count; ++detection) {
+            int cell_x = get_cell(detection_x[detection]);
+            int cell_y = get_cell(detection_y[detection]);
+
+            for (int offset_x = -1; offset_x <= 1; ++offset_x) {
+                for (int offset_y = -1; offset_y <= 1; ++offset_y) {
+                    int bucket = get_bucket(cell_x + offset_x, cell_y + offset_y);
+
+                    /// Разные ячейки могут попасть в одну корзину, лишние траектории отсекаются по расстоянию
+                    for (int track = grid_head[bucket]; track >= 0; track = grid_next[track]) {
+                        float dx = detection_x[detection] - track_x[track];
+                        float dy = detection_y[detection] - track_y[track];
+                        float distance = dx * dx + dy * dy;
+
+                        if (distance <= gate) {
+                            pairs.push_back(gate_pair{distance, detection, track});
+                        }
+                    }
+                }
+            }
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+
+        for (const gate_pair &pair: pairs) {
+            if (detection_track[pair.detection] >= 0 || track_updated[pair.track]) {
+                continue;
+            }
+
+            detection_track[pair.detection] = pair.track;
+            track_updated[pair.track] = true;
+        }
+    }
+
+    /**
+     * \brief Коррекция траектории по связанной цели
+     *
+     * \param [in] track Номер траектории
+     * \param [in] x Поперечная координата цели, м
+     * \param [in] y Продольная координата цели, м
+     * \param [in] speed Радиальная скорость цели
+     * \param [in] dt Время с предыдущего обновления, с
+     */
+    void correct(int track, float x, float y, float speed, float dt) {
+        float residual_x = x - track_x[track];
+        float residual_y = y - track_y[track];
+
+        track_x[track] += TRACKER_ALPHA * residual_x;
+        track_y[track] += TRACKER_ALPHA * residual_y;
+        track_vx[track] += TRACKER_BETA / dt * residual_x;
+        track_vy[track] += TRACKER_BETA / dt * residual_y;
+        track_speed[track] += TRACKER_SPEED_ALPHA * (speed - track_speed[track]);
+
+        ++track_hits[track];
+        track_misses[track] = 0;
+    }
+
+    /**
+     * \brief Удаление траектории переносом на её место последней
+     *
+     * \param [in] track Номер удаляемой траектории
+     */
+    void remove_track(int track) {
+        --track_count;
+
+        track_id[track] = track_id[track_count];
+        track_x[track] = track_x[track_count];
+        track_y[track] = track_y[track_count];
+        track_vx[track] = track_vx[track_count];
+        track_vy[track] = track_vy[track_count];
+        track_speed[track] = track_speed[track_count];
+        track_hits[track] = track_hits[track_count];
+        track_misses[track] = track_misses[track_count];
+        track_updated[track] = track_updated[track_count];
+
+        ++statistics.tracks_deleted;
+    }
+
+public:
+    TargetTracker() {
+        pairs.reserve(TARGET_BATCH_CAPACITY * 4);
+    }
+
+    /**
+     * \brief Обработка пакета целей.
+     *
+     * \param [in] batch Пакет целей одного кадра
+     * \param [in] received_at Время приёма кадра. Шаг фильтра - разность с временем фильтра после предыдущего
+     * обновления, но не меньше TRACKER_MIN_PERIOD. Время фильтра может опережать отметки времени пакетов, доставленных
+     * пачкой, не больше чем на TRACKER_MAX_LEAD.
+     * \return Подтверждённые траектории, действительны до следующего вызова update() или reset()
+     */
+    const track_batch &update(const target_batch &batch, std::chrono::steady_clock::time_point received_at) {
+        float dt = TRACKER_DEFAULT_PERIOD;
+
+        if (has_last_update) {
+            dt = std::chrono::duration<float>(received_at - last_update).count();
+
+            if (dt < TRACKER_MIN_PERIOD) {
+                dt = TRACKER_MIN_PERIOD;
+            }
+
+            /// Время фильтра сдвигается на шаг, а не на отметку времени пакета, поэтому время, добавленное к пакетам
+            /// пачки, вычитается из паузы перед следующей пачкой
+            last_update += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<float>(dt));
+
+            if (last_update - received_at > std::chrono::duration<float>(TRACKER_MAX_LEAD)) {
+                last_update = received_at;
+            }
+        } else {
+            last_update = received_at;
+        }
+
+        has_last_update = true;
+
+        int detection_count = batch.count < TARGET_BATCH_CAPACITY ? batch.count : TARGET_BATCH_CAPACITY;
+
+        for (int detection = 0; detection < detection_count; ++detection) {
+            if (batch.has_road_coordinates) {
+                detection_x[detection] = batch.road_x[detection];
+                detection_y[detection] = batch.road_y[detection];
+            } else {
+                float angle = batch.angle[detection] * TRACKER_DEGREES_TO_RADIANS;
+
+                detection_x[detection] = batch.distance[detection] * std::sin(angle);
+                detection_y[detection] = batch.distance[detection] * std::cos(angle);
+            }
+
+            detection_track[detection] = -1;
+        }
+
+        predict(dt);
+        associate(detection_count);
+
+        for (int detection = 0; detection < detection_count; ++detection) {
+            if (detection_track[detection] >= 0) {
+                correct(detection_track[detection], detection_x[detection], detection_y[detection],
+                        batch.speed[detection], dt);
+            }
+        }
+
+        for (int track = track_count - 1; track >= 0; --track) {
+            if (!track_updated[track] && ++track_misses[track] >= TRACKER_MAX_MISSES) {
+                remove_track(track);
+            }
+        }
+
+        for (int detection = 0; detection < detection_count; ++detection) {
+            if (detection_track[detection] >= 0) {
+                continue;
+            }
+
+            if (track_count == TRACKER_CAPACITY) {
+                ++statistics.detections_dropped;
+                continue;
+            }
+
+            int track = track_count++;
+
+            track_id[track] = next_id++;
+            track_x[track] = detection_x[detection];
+            track_y[track] = detection_y[detection];
+            track_vx[track] = 0;
+            track_vy[track] = 0;
+            track_speed[track] = batch.speed[detection];
+            track_hits[track] = 1;
+            track_misses[track] = 0;
+
+            ++statistics.tracks_created;
+        }
+
+        tracks.count = 0;
+
+        for (int track = 0; track < track_count; ++track) {
+            if (track_hits[track] < TRACKER_CONFIRM_HITS) {
+                continue;
+            }
+
+            int pos = tracks.count++;
+
+            tracks.id[pos] = track_id[track];
+            tracks.x[pos] = track_x[track];
+            tracks.y[pos] = track_y[track];
+            tracks.vx[pos] = track_vx[track];
+            tracks.vy[pos] = track_vy[track];
+            tracks.speed[pos] = track_speed[track];
+        }
+
+        ++statistics.updates;
+
+        return tracks;
+    }
+
+    /**
+     * \brief Подтверждённые траектории после последнего вызова update().
+     */
+    const track_batch &get_tracks() const {
+        return tracks;
+    }
+
+    /**
+     * \brief Количество траекторий, включая неподтверждённые.
+     */
+    int get_track_count() const {
+        return track_count;
+    }
+
+    tracker_statistics get_statistics() const {
+        return statistics;
+    }
+
+    /**
+     * \brief Удаление всех траекторий. Номера новых траекторий продолжают расти.
+     */
+    void reset() {
+        track_count = 0;
+        tracks.count = 0;
+        has_last_update = false;
+    }
+};
+
+#endif //SMART_ROAD_TARGET_TRACKER_HPP
@@ -0,0 +1,249 @@
+/**
+ * \file
+ * \brief Заголовочный файл, содержащий вывод таблиц в терминал с двойной буферизацией TerminalRenderer
+ *
+ * \authors Александр Горбунов
+ * \date 17 октября 2026
+ */
+
+#ifndef SMART_ROAD_TERMINAL_RENDERER_HPP
+#define SMART_ROAD_TERMINAL_RENDERER_HPP
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#else
+#include <unistd.h>
+#endif
+
+/// Количество неизменившихся символов, которые выгоднее вывести заново, чем переместить курсор
+#define TERMINAL_RENDERER_MERGE_GAP     8
+/// Наибольшая длина последовательности перемещения курсора
+#define TERMINAL_RENDERER_MOVE_LENGTH   16
+
+/**
+ * \brief Вывод таблицы в терминал с двойной буферизацией
+ *
+ * Экран - сетка символов фиксированного размера. Кадр собирается в заднем буфере, затем present()
+ * сравнивает его с передним буфером (тем, что уже выведено) и выводит только изменившиеся участки строк,
+ * перемещая курсор escape-последовательностями. Все изменения кадра собираются в заранее выделенный
+ * буфер и выводятся одним системным вызовом, поэтому экран не мерцает, а вывод не выделяет память.
+ *
+ * Первый кадр после создания или invalidate() выводится целиком поверх очищенного экрана. Терминал
+ * должен поддерживать escape-последовательности VT100, на Windows их обработка включается в конструкторе.
+ *
+ * **Пример**
+ * \code
+ * TerminalRenderer renderer(2, 32);
+ *
+ * renderer.begin_frame();
+ * renderer.print(0, " # |  dist");
+ * renderer.print(1, "%2d | %6.2f", 1, 12.5f);
+ * renderer.present();
+ * \endcode
+ */
+class TerminalRenderer {
+
+private:
+    int rows;
+    int columns;
+
+    /// Символы, выведенные на экран
+    std::vector<char> front;
+    /// Символы собираемого кадра
+    std::vector<char> back;
+    /// Байты, выводимые за один вызов present()
+    std::vector<char> output;
+    size_t output_length = 0;
+
+    /// Строка форматирования, в которую vsnprintf записывает завершающий ноль
+    std::vector<char> line;
+
+    /**
+     * \brief Добавление байт к выводу.
+     */
+    void append(const char *data, size_t length) {
+        memcpy(output.data() + output_length, data, length);
+        output_length += length;
+    }
+
+    /**
+     * \brief Добавление перемещения курсора к выводу.
+     *
+     * \param [in] row Строка, начиная с нуля
+     * \param [in] column Столбец, начиная с нуля
+     */
+    void append_move(int row, int column) {
+        char move[TERMINAL_RENDERER_MOVE_LENGTH];
+        int length = snprintf(move, sizeof(move), "\x1b[%d;%dH", row + 1, column + 1);
+
+        append(move, (size_t) length);
+    }
+
+    /**
+     * \brief Вывод буфера одним системным вызовом.
+     */
+    static void write_all(const char *data, size_t length) {
+        /// Данные, накопленные в буфере stdio, выводятся раньше кадра
+        fflush(stdout);
+
+#ifdef _WIN32
+        DWORD written = 0;
+        WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), data, (DWORD) length, &written, nullptr);
+#else
+        while (length > 0) {
+            ssize_t written = ::write(STDOUT_FILENO, data, length);
+
+            if (written <= 0) {
+                return;
+            }
+
+            data += written;
+            length -= (size_t) written;
+        }
+#endif
+    }
+
+public:
+    /**
+     * \brief Конструктор с размером экрана.
+     *
+     * \param [in] screen_rows Количество строк
+     * \param [in] screen_columns Количество столбцов
+     */
+    TerminalRenderer(int screen_rows, int screen_columns)
+            : rows(screen_rows),
+              columns(screen_columns),
+              front((size_t) screen_rows * screen_columns),
+              back((size_t) screen_rows * screen_columns, ' '),
+              /// Худший случай - перемещение курсора перед каждым участком и символы всех ячеек
+              output((size_t) screen_rows * ((screen_columns / (TERMINAL_RENDERER_MERGE_GAP + 1) + 1) *
+                                             TERMINAL_RENDERER_MOVE_LENGTH + screen_columns) + 64),
+              line((size_t) screen_columns + 1) {
+#ifdef _WIN32
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+
+        if (GetConsoleMode(console, &mode)) {
+            SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        }
+#endif
+        invalidate();
+    }
+
+    /**
+     * \brief Начало нового кадра: задний буфер заполняется пробелами.
+     */
+    void begin_frame() {
+        memset(back.data(), ' ', back.size());
+    }
+
+    /**
+     * \brief Запись форматированной строки в задний буфер.
+     *
+     * Текст, не помещающийся в ширину экрана, обрезается, остаток строки не изменяется.
+     *
+     * \param [in] row Строка, начиная с нуля
+     * \param [in] format Строка форматирования printf
+     */
+    void print(int row, const char *format, ...) {
+        if (row < 0 || row >= rows) {
+            return;
+        }
+
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(line.data(), line.size(), format, args);
+        va_end(args);
+
+        if (length <= 0) {
+            return;
+        }
+
+        if (length > columns) {
+            length = columns;
+        }
+
+        memcpy(back.data() + (size_t) row * columns, line.data(), (size_t) length);
+    }
+
+    /**
+     * \brief Вывод изменений кадра на экран.
+     *
+     * \return Количество выведенных байт
+     */
+    size_t present() {
+        output_length = 0;
+
+        for (int row = 0; row < rows; ++row) {
+            const char *old_row = front.data() + (size_t) row * columns;
+            const char *new_row = back.data() + (size_t) row * columns;
+
+            int column = 0;
+
+            while (column < columns) {
+                if (old_row[column] == new_row[column]) {
+                    ++column;
+                    continue;
+                }
+
+                /// Участок продолжается, пока между изменениями не больше TERMINAL_RENDERER_MERGE_GAP символов
+                int start = column;
+                int end = column + 1;
+
+                for (int pos = end; pos < columns && pos - end <= TERMINAL_RENDERER_MERGE_GAP; ++pos) {
+                    if (old_row[pos] != new_row[pos]) {
+                        end = pos + 1;
+                    }
+                }
+
+                append_move(row, start);
+                append(new_row + start, (size_t) (end - start));
+
+                column = end;
+            }
+        }
+
+        if (output_length > 0) {
+            write_all(output.data(), output_length);
+        }
+
+        front.swap(back);
+
+        return output_length;
+    }
+
+    /**
+     * \brief Очистка экрана, после которой следующий кадр выводится целиком.
+     */
+    void invalidate() {
+        /// Нулевой символ не совпадает ни с одним выводимым, поэтому все ячейки считаются изменившимися
+        memset(front.data(), 0, front.size());
+
+        write_all("\x1b[2J\x1b[H", 7);
+    }
+
+    /**
+     * \brief Скрытие курсора на время вывода таблицы.
+     */
+    static void hide_cursor() {
+        write_all("\x1b[?25l", 6);
+    }
+
+    /**
+     * \brief Показ курсора, очистка экрана и перемещение курсора в начало.
+     */
+    static void restore_screen() {
+        write_all("\x1b[2J\x1b[H\x1b[?25h", 13);
+    }
+};
+
+#endif //SMART_ROAD_TERMINAL_RENDERER_HPP
@@ -9,14 +9,12 @@
 #ifndef SMART_ROAD_UTILS_HPP
 #define SMART_ROAD_UTILS_HPP
 
+#include <cstddef>
 #include <string>
 
 /// Стандартный делитель
 #define DELIMITER   " "
 
-/// Определение типа size_t на случай, если его нет по-умолчанию
-typedef unsigned long long int size_t;
-
 /// Тип данных byte_t размером 1 байт
 typedef char byte_t;
 /// Тип данных u_byte_t размером 1 байт